@@ -0,0 +1,60 @@
+#include "AnomalyDetector.hpp"
+#include "MemoryUsage.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+double AnomalyDetector::add(const std::string& location, const std::string& pollutant, double level) {
+    if (std::isnan(level))
+        return std::numeric_limits<double>::quiet_NaN();
+
+    auto site = baselines.find(location);
+    if (site == baselines.end())
+        site = baselines.emplace(location, std::unordered_map<std::string, Baseline>()).first;
+    auto series = site->second.find(pollutant);
+    if (series == site->second.end())
+        series = site->second.emplace(pollutant, Baseline()).first;
+    Baseline& baseline = series->second;
+
+    double score = std::numeric_limits<double>::quiet_NaN();
+    if (baseline.count >= WARM_UP) {
+        double spread = std::max(std::sqrt(baseline.variance), MIN_RELATIVE_SPREAD * std::abs(baseline.mean));
+        if (spread > 0.0)
+            score = (level - baseline.mean) / spread;
+        else
+            score = level == baseline.mean ? 0.0 : std::copysign(std::numeric_limits<double>::infinity(),
+                                                                 level - baseline.mean);
+    }
+
+    // The first sample seeds the mean; after that, the incremental
+    // exponentially weighted mean and variance update
+    if (baseline.count == 0) {
+        baseline.mean = level;
+    } else {
+        double difference = level - baseline.mean;
+        double increment = SMOOTHING * difference;
+        baseline.mean += increment;
+        baseline.variance = (1.0 - SMOOTHING) * (baseline.variance + difference * increment);
+    }
+    if (baseline.count < WARM_UP)
+        baseline.count++;
+    return score;
+}
+
+double AnomalyDetector::add(const WaterSample& sample) {
+    return add(sample.getLocation(), sample.getPollutant(), sample.getLevel());
+}
+
+void AnomalyDetector::clear() {
+    baselines.clear();
+}
+
+size_t AnomalyDetector::approximateBytes() const {
+    size_t bytes = hashMapBytes(baselines);
+    for (const auto& location : baselines) {
+        bytes += heapBytes(location.first) + hashMapBytes(location.second);
+        for (const auto& pollutant : location.second)
+            bytes += heapBytes(pollutant.first);
+    }
+    return bytes;
+}
@@ -0,0 +1,44 @@
+#ifndef ANOMALYDETECTOR_HPP
+#define ANOMALYDETECTOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include "WaterSample.hpp"
+
+// Flags levels that jump well above a site's own history, independently of
+// the static thresholds. Every location x pollutant keeps an exponentially
+// weighted mean and variance, updated in O(1) per sample, and a sample is
+// scored by how many weighted standard deviations it lies above the mean of
+// the samples before it. Samples must be added in time order per series.
+class AnomalyDetector {
+public:
+    static constexpr double SMOOTHING = 0.1;   // Weight of each new sample
+    static constexpr uint32_t WARM_UP = 10;    // Samples before a series is scored
+    static constexpr double THRESHOLD = 4.0;   // Score from which a sample is an anomaly
+    // Spread assumed at least this share of the mean, so a series that has
+    // been flat is not flagged for a tiny change
+    static constexpr double MIN_RELATIVE_SPREAD = 0.1;
+
+    // Score of level against its series so far (NaN while the series warms
+    // up), then folds level into the baseline
+    double add(const std::string& location, const std::string& pollutant, double level);
+    double add(const WaterSample& sample);
+    void clear();
+    size_t approximateBytes() const; // Heap bytes held, estimated
+
+    static bool isAnomaly(double score) { return score >= THRESHOLD; } // False for NaN
+
+private:
+    struct Baseline {
+        double mean = 0.0;
+        double variance = 0.0;
+        uint32_t count = 0;
+    };
+
+    // Keyed by location, then pollutant, so a lookup copies no strings
+    std::unordered_map<std::string, std::unordered_map<std::string, Baseline>> baselines;
+};
+
+#endif // ANOMALYDETECTOR_HPP
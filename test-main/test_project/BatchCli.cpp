@@ -0,0 +1,100 @@
+#include "BatchCli.hpp"
+#include "dataset.hpp"
+#include <cmath>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+void printUsage() {
+    std::cerr << "Usage: test --summary <data.csv> [more.csv ...]" << std::endl
+              << "       test --to-columnar <data.csv> [more.csv ...] <cache.wqc>" << std::endl;
+}
+
+// field as a CSV field in quotes, its own quotes doubled (RFC 4180)
+std::string quoted(const std::string& field) {
+    std::string result = "\"";
+    for (char c : field) {
+        if (c == '"')
+            result += '"';
+        result += c;
+    }
+    return result + '"';
+}
+
+// Prints count, mean, median and p95 level per site and pollutant, then the
+// distinct sampling points per pollutant, as CSV on stdout
+int printSummary(int argc, char *argv[]) {
+    if (argc < 3) {
+        printUsage();
+        return 1;
+    }
+
+    // Only the aggregates and sketches are needed, so stream the files and
+    // keep none of the rows; archives larger than memory work too
+    WaterDataset dataset;
+    std::vector<std::string> files(argv + 2, argv + argc);
+    dataset.streamQuery(files, ComplianceRules(), SampleFilter(), 0);
+
+    const DatasetAggregates& aggregates = dataset.getAggregates();
+    const DatasetSketches& sketches = dataset.getSketches();
+
+    std::cout << "Location,Pollutant,Count,Mean,Median,P95" << std::endl;
+    for (const SeriesKey& key : aggregates.getSeriesKeys()) {
+        RunningStats levels = aggregates.summarize(key.location, key.pollutant);
+        TDigest digest = sketches.levelDigest(key.location, key.pollutant);
+        std::cout << quoted(key.location) << ',' << quoted(key.pollutant) << ',' << levels.count << ','
+                  << levels.mean << ',' << digest.quantile(0.5) << ',' << digest.quantile(0.95) << std::endl;
+    }
+
+    std::set<std::string> pollutants;
+    for (const SeriesKey& key : aggregates.getSeriesKeys())
+        pollutants.insert(key.pollutant);
+
+    std::cout << std::endl << "Pollutant,DistinctSamplingPoints" << std::endl;
+    for (const std::string& pollutant : pollutants)
+        std::cout << quoted(pollutant) << ',' << std::llround(sketches.distinctSamplingPoints(pollutant)) << std::endl;
+    std::cout << quoted("All") << ',' << std::llround(sketches.distinctSamplingPoints()) << std::endl;
+    return 0;
+}
+
+// Merges CSV exports into one columnar cache, sorted by location, pollutant
+// and time with duplicate rows from overlapping exports removed
+int convertToColumnar(int argc, char *argv[]) {
+    if (argc < 4) {
+        printUsage();
+        return 1;
+    }
+
+    try {
+        WaterDataset dataset;
+        dataset.loadMerged(std::vector<std::string>(argv + 2, argv + argc - 1));
+        dataset.saveColumnar(argv[argc - 1]);
+    } catch (const std::exception& e) {
+        std::cerr << "Cannot convert to " << argv[argc - 1] << ": " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace
+
+bool isBatchInvocation(int argc, char *argv[]) {
+    if (argc < 2)
+        return false;
+    std::string mode = argv[1];
+    return mode == "--summary" || mode == "--to-columnar";
+}
+
+int runBatch(int argc, char *argv[]) {
+    std::string mode = argv[1];
+    if (mode == "--summary")
+        return printSummary(argc, argv);
+    if (mode == "--to-columnar")
+        return convertToColumnar(argc, argv);
+
+    printUsage();
+    return 1;
+}
@@ -0,0 +1,10 @@
+#ifndef BATCHCLI_HPP
+#define BATCHCLI_HPP
+
+// Command line modes that print results instead of opening the dashboard:
+//   test --summary <data.csv> [more.csv ...]
+//   test --to-columnar <data.csv> [more.csv ...] <cache.wqc>
+bool isBatchInvocation(int argc, char *argv[]);
+int runBatch(int argc, char *argv[]);
+
+#endif // BATCHCLI_HPP
@@ -0,0 +1,32 @@
+#ifndef CANCELLATION_HPP
+#define CANCELLATION_HPP
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+// Thrown by a query that noticed it was cancelled
+class QueryCancelled : public std::runtime_error {
+public:
+    QueryCancelled() : std::runtime_error("Query cancelled") {}
+};
+
+// Cooperative cancellation of a query running on another thread. Copies
+// share one flag: the owner keeps a copy to cancel() and the query calls
+// check() between units of work, so it stops at the next one.
+class CancelToken {
+public:
+    CancelToken() : flag(std::make_shared<std::atomic<bool>>(false)) {}
+
+    void cancel() { flag->store(true, std::memory_order_relaxed); }
+    bool isCancelled() const { return flag->load(std::memory_order_relaxed); }
+    void check() const {
+        if (isCancelled())
+            throw QueryCancelled();
+    }
+
+private:
+    std::shared_ptr<std::atomic<bool>> flag;
+};
+
+#endif // CANCELLATION_HPP
@@ -0,0 +1,699 @@
+#include "ColumnarCache.hpp"
+#include "SampleTime.hpp"
+#include "MemoryUsage.hpp"
+#include "csv.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+
+namespace columnar {
+
+namespace {
+
+const char MAGIC[8] = {'W', 'Q', 'C', 'A', 'C', 'H', 'E', '1'};
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr uint32_t FORMAT_VERSION = 3;
+constexpr size_t HEADER_SIZE = 56;
+constexpr size_t CHUNK_HEADER_SIZE = 8;
+// Block index entry with empty location and pollutant sets
+constexpr size_t MIN_INDEX_ENTRY_SIZE = 4 + 2 * 8 + 2 * 4 + 4 * 8 + 2 * 4 + COLUMN_COUNT * 16;
+
+// Codec byte at the start of every column chunk. The writer encodes each
+// chunk with every codec that applies and keeps the smallest.
+constexpr uint8_t CODEC_PLAIN = 0;
+constexpr uint8_t CODEC_FOR = 1;     // Offsets from the minimum, bit-packed
+constexpr uint8_t CODEC_DELTA = 2;   // Differences between neighbours, bit-packed as FOR
+constexpr uint8_t CODEC_DECIMAL = 3; // Levels scaled by 10^k to exact integers, then FOR
+
+// Decimal places tried by CODEC_DECIMAL
+constexpr int MAX_DECIMAL_SCALE = 6;
+const double POWERS_OF_TEN[MAX_DECIMAL_SCALE + 1] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6};
+
+// Dates that are not "YYYY-MM-DDTHH:MM:SS" are kept verbatim in a dictionary
+// and stored as ODD_DATE + id, far outside any real timestamp
+constexpr int64_t ODD_DATE = std::numeric_limits<int64_t>::min();
+
+template <typename T>
+void put(std::string& out, T value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+void putString(std::string& out, const std::string& value) {
+    put<uint32_t>(out, static_cast<uint32_t>(value.size()));
+    out += value;
+}
+
+// Bounds-checked reads from a byte buffer
+class Cursor {
+public:
+    Cursor(const char* data, size_t size) : data(data), size(size) {}
+
+    template <typename T>
+    T get() {
+        need(sizeof(T));
+        T value;
+        std::memcpy(&value, data + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    // Element count of a list that follows, rejected if the rest of the buffer cannot hold it
+    uint32_t getCount(size_t elementSize) {
+        uint32_t count = get<uint32_t>();
+        need(static_cast<size_t>(count) * elementSize);
+        return count;
+    }
+
+    size_t offset() const { return pos; }
+
+    std::string getString() {
+        uint32_t length = get<uint32_t>();
+        need(length);
+        std::string value(data + pos, length);
+        pos += length;
+        return value;
+    }
+
+private:
+    void need(size_t bytes) const {
+        if (size - pos < bytes)
+            throw std::runtime_error("Columnar file is truncated");
+    }
+
+    const char* data;
+    size_t size;
+    size_t pos = 0;
+};
+
+// Assigns dense ids to strings in order of first appearance
+class DictionaryBuilder {
+public:
+    uint32_t id(const std::string& value) {
+        auto it = ids.find(value);
+        if (it != ids.end())
+            return it->second;
+        uint32_t next = static_cast<uint32_t>(values.size());
+        ids.emplace(value, next);
+        values.push_back(value);
+        return next;
+    }
+
+    const std::vector<std::string>& getValues() const { return values; }
+
+private:
+    std::unordered_map<std::string, uint32_t> ids;
+    std::vector<std::string> values;
+};
+
+std::string chunkHeader(uint8_t codec, size_t count) {
+    std::string chunk;
+    put<uint8_t>(chunk, codec);
+    chunk.append(3, '\0');
+    put<uint32_t>(chunk, static_cast<uint32_t>(count));
+    return chunk;
+}
+
+unsigned bitWidth(uint64_t value) {
+    unsigned width = 0;
+    while (value) {
+        value >>= 1;
+        width++;
+    }
+    return width;
+}
+
+// 64-bit words holding count values of width bits, plus one zero word so the
+// decoder can always read the word after the one a value starts in
+size_t packedWords(size_t count, unsigned width) {
+    return (count * width + 63) / 64 + 1;
+}
+
+void packBits(std::string& out, const std::vector<uint64_t>& values, unsigned width) {
+    std::vector<uint64_t> words(packedWords(values.size(), width), 0);
+    for (size_t i = 0; i < values.size() && width > 0; ++i) {
+        size_t bit = i * width;
+        size_t word = bit / 64;
+        unsigned shift = bit % 64;
+        words[word] |= values[i] << shift;
+        if (shift + width > 64)
+            words[word + 1] |= values[i] >> (64 - shift);
+    }
+    for (uint64_t word : words)
+        put<uint64_t>(out, word);
+}
+
+template <typename Store>
+void unpackBits(const char* packed, size_t count, unsigned width, Store store) {
+    uint64_t mask = width == 64 ? ~0ULL : (1ULL << width) - 1;
+    for (size_t i = 0; i < count; ++i) {
+        size_t bit = i * width;
+        unsigned shift = bit % 64;
+        uint64_t low;
+        std::memcpy(&low, packed + bit / 64 * 8, 8);
+        uint64_t value = low >> shift;
+        if (shift + width > 64) {
+            uint64_t high;
+            std::memcpy(&high, packed + bit / 64 * 8 + 8, 8);
+            value |= high << (64 - shift);
+        }
+        store(i, value & mask);
+    }
+}
+
+// Reference value and bit width followed by the packed offsets. Arithmetic is
+// done modulo 2^64, so any int64 values round-trip.
+void putFrame(std::string& out, const std::vector<int64_t>& values) {
+    int64_t reference = values.empty() ? 0 : *std::min_element(values.begin(), values.end());
+    std::vector<uint64_t> offsets(values.size());
+    uint64_t largest = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        offsets[i] = static_cast<uint64_t>(values[i]) - static_cast<uint64_t>(reference);
+        largest = std::max(largest, offsets[i]);
+    }
+
+    unsigned width = bitWidth(largest);
+    put<int64_t>(out, reference);
+    put<uint8_t>(out, static_cast<uint8_t>(width));
+    out.append(7, '\0');
+    packBits(out, offsets, width);
+}
+
+template <typename Store>
+void getFrame(Cursor& cursor, const char* payload, size_t size, size_t count, Store store) {
+    uint64_t reference = static_cast<uint64_t>(cursor.get<int64_t>());
+    unsigned width = cursor.get<uint8_t>();
+    if (width > 64 || size != cursor.offset() + 7 + packedWords(count, width) * 8)
+        throw std::runtime_error("Columnar file has a malformed column chunk");
+
+    unpackBits(payload + cursor.offset() + 7, count, width,
+               [&](size_t i, uint64_t offset) { store(i, static_cast<int64_t>(reference + offset)); });
+}
+
+// Smallest of plain, FOR and delta encoding for an integer column
+template <typename T>
+std::string encodeIntegers(const std::vector<T>& values) {
+    std::string best = chunkHeader(CODEC_PLAIN, values.size());
+    best.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    if (values.empty())
+        return best;
+
+    std::vector<int64_t> wide(values.begin(), values.end());
+    std::string frame = chunkHeader(CODEC_FOR, values.size());
+    putFrame(frame, wide);
+    if (frame.size() < best.size())
+        best.swap(frame);
+
+    std::vector<int64_t> deltas(wide.size() - 1);
+    for (size_t i = 1; i < wide.size(); ++i)
+        deltas[i - 1] = static_cast<int64_t>(static_cast<uint64_t>(wide[i]) - static_cast<uint64_t>(wide[i - 1]));
+    std::string delta = chunkHeader(CODEC_DELTA, values.size());
+    put<int64_t>(delta, wide[0]);
+    putFrame(delta, deltas);
+    if (delta.size() < best.size())
+        best.swap(delta);
+    return best;
+}
+
+// Smallest scale k such that every level is exactly n / 10^k, or -1
+int decimalScale(const std::vector<double>& levels) {
+    for (int scale = 0; scale <= MAX_DECIMAL_SCALE; ++scale) {
+        bool exact = true;
+        for (double level : levels) {
+            double scaled = level * POWERS_OF_TEN[scale];
+            // Integers beyond 2^53 lose precision, and -0.0 would read back as 0.0
+            if (!(std::fabs(scaled) < 9007199254740992.0) || (level == 0.0 && std::signbit(level)) ||
+                static_cast<double>(std::llround(scaled)) / POWERS_OF_TEN[scale] != level) {
+                exact = false;
+                break;
+            }
+        }
+        if (exact)
+            return scale;
+    }
+    return -1;
+}
+
+std::string encodeLevels(const std::vector<double>& levels) {
+    std::string best = chunkHeader(CODEC_PLAIN, levels.size());
+    best.append(reinterpret_cast<const char*>(levels.data()), levels.size() * sizeof(double));
+
+    int scale = decimalScale(levels);
+    if (levels.empty() || scale < 0)
+        return best;
+
+    std::vector<int64_t> scaled(levels.size());
+    for (size_t i = 0; i < levels.size(); ++i)
+        scaled[i] = std::llround(levels[i] * POWERS_OF_TEN[scale]);
+    std::string decimal = chunkHeader(CODEC_DECIMAL, levels.size());
+    put<uint8_t>(decimal, static_cast<uint8_t>(scale));
+    decimal.append(7, '\0');
+    putFrame(decimal, scaled);
+    if (decimal.size() < best.size())
+        best.swap(decimal);
+    return best;
+}
+
+template <typename T>
+std::vector<T> decodeChunk(const char* chunk, size_t size, uint32_t rows) {
+    Cursor cursor(chunk, size);
+    uint8_t codec = cursor.get<uint8_t>();
+    cursor.get<uint8_t>();
+    cursor.get<uint16_t>();
+    uint32_t count = cursor.get<uint32_t>();
+    if (count != rows)
+        throw std::runtime_error("Columnar file has a malformed column chunk");
+
+    std::vector<T> values(count);
+    if (codec == CODEC_PLAIN) {
+        if (size != CHUNK_HEADER_SIZE + count * sizeof(T))
+            throw std::runtime_error("Columnar file has a malformed column chunk");
+        // Chunks are not aligned in the file, so values are copied out
+        std::memcpy(values.data(), chunk + CHUNK_HEADER_SIZE, count * sizeof(T));
+    } else if (codec == CODEC_FOR && std::is_integral<T>::value) {
+        getFrame(cursor, chunk, size, count, [&](size_t i, int64_t value) { values[i] = static_cast<T>(value); });
+    } else if (codec == CODEC_DELTA && std::is_integral<T>::value && count > 0) {
+        uint64_t previous = static_cast<uint64_t>(cursor.get<int64_t>());
+        values[0] = static_cast<T>(previous);
+        getFrame(cursor, chunk, size, count - 1, [&](size_t i, int64_t delta) {
+            previous += static_cast<uint64_t>(delta);
+            values[i + 1] = static_cast<T>(previous);
+        });
+    } else if (codec == CODEC_DECIMAL && std::is_floating_point<T>::value) {
+        unsigned scale = cursor.get<uint8_t>();
+        cursor.get<uint8_t>();
+        cursor.get<uint16_t>();
+        cursor.get<uint32_t>();
+        if (scale > MAX_DECIMAL_SCALE)
+            throw std::runtime_error("Columnar file has a malformed column chunk");
+        getFrame(cursor, chunk, size, count, [&](size_t i, int64_t value) {
+            values[i] = static_cast<T>(static_cast<double>(value) / POWERS_OF_TEN[scale]);
+        });
+    } else {
+        throw std::runtime_error("Columnar file has a malformed column chunk");
+    }
+    return values;
+}
+
+void putIds(std::string& out, const std::vector<uint32_t>& ids) {
+    put<uint32_t>(out, static_cast<uint32_t>(ids.size()));
+    for (uint32_t id : ids)
+        put<uint32_t>(out, id);
+}
+
+std::vector<uint32_t> getIds(Cursor& cursor) {
+    std::vector<uint32_t> ids(cursor.getCount(sizeof(uint32_t)));
+    for (uint32_t& id : ids)
+        id = cursor.get<uint32_t>();
+    return ids;
+}
+
+std::vector<uint32_t> distinctSorted(std::vector<uint32_t> ids) {
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
+
+} // namespace
+
+void writeFile(const std::string& path, const std::vector<WaterSample>& samples, uint32_t blockRows,
+               uint64_t sourceBytes) {
+    if (blockRows == 0)
+        throw std::runtime_error("Columnar block size must be positive");
+
+    DictionaryBuilder builders[COLUMN_COUNT];
+    std::vector<GridPoint> locationPositions; // By location id
+    std::vector<BlockInfo> blocks;
+
+    // Written to a temporary name first so a reader never sees a partial file
+    std::string tmpPath = path + ".tmp";
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw std::runtime_error("Cannot write columnar file " + tmpPath);
+
+    std::string header(HEADER_SIZE, '\0');
+    out.write(header.data(), header.size());
+    uint64_t offset = HEADER_SIZE;
+
+    auto writeChunk = [&](BlockInfo& block, Column column, const std::string& chunk) {
+        block.columns[static_cast<size_t>(column)] = ChunkRef{offset, chunk.size()};
+        out.write(chunk.data(), chunk.size());
+        offset += chunk.size();
+    };
+
+    for (size_t begin = 0; begin < samples.size(); begin += blockRows) {
+        size_t end = std::min(samples.size(), begin + blockRows);
+        std::vector<uint32_t> ids[COLUMN_COUNT];
+        std::vector<double> levels;
+        std::vector<int64_t> dates;
+        levels.reserve(end - begin);
+        dates.reserve(end - begin);
+
+        BlockInfo block;
+        ZoneMap& zone = block.zone;
+        zone.rows = static_cast<uint32_t>(end - begin);
+        zone.minLevel = std::numeric_limits<double>::infinity();
+        zone.maxLevel = -std::numeric_limits<double>::infinity();
+        zone.minYearMonth = std::numeric_limits<int>::max();
+        zone.maxYearMonth = std::numeric_limits<int>::min();
+        bool unorderedLevel = false;
+
+        for (size_t i = begin; i < end; ++i) {
+            const WaterSample& sample = samples[i];
+            uint32_t locationId = builders[static_cast<size_t>(Column::Location)].id(sample.getLocation());
+            ids[static_cast<size_t>(Column::Location)].push_back(locationId);
+            GridPoint position = positionOf(sample);
+            if (locationId >= locationPositions.size())
+                locationPositions.resize(locationId + 1);
+            if (!locationPositions[locationId].known())
+                locationPositions[locationId] = position;
+            zone.bounds.extend(position);
+            ids[static_cast<size_t>(Column::Pollutant)].push_back(
+                builders[static_cast<size_t>(Column::Pollutant)].id(sample.getPollutant()));
+            ids[static_cast<size_t>(Column::Unit)].push_back(
+                builders[static_cast<size_t>(Column::Unit)].id(sample.getUnit()));
+            ids[static_cast<size_t>(Column::Compliance)].push_back(
+                builders[static_cast<size_t>(Column::Compliance)].id(sample.getComplianceStatus()));
+
+            double level = sample.getLevel();
+            levels.push_back(level);
+            if (std::isnan(level)) {
+                unorderedLevel = true;
+            } else {
+                zone.minLevel = std::min(zone.minLevel, level);
+                zone.maxLevel = std::max(zone.maxLevel, level);
+            }
+
+            int64_t date;
+            if (!sampletime::parse(sample.getSampleDate(), date))
+                date = ODD_DATE + builders[static_cast<size_t>(Column::Date)].id(sample.getSampleDate());
+            dates.push_back(date);
+
+            int yearMonth = sample.getYearMonth();
+            zone.minYearMonth = std::min(zone.minYearMonth, yearMonth);
+            zone.maxYearMonth = std::max(zone.maxYearMonth, yearMonth);
+        }
+
+        // A NaN level compares false with everything, so the range cannot exclude anything
+        if (unorderedLevel) {
+            zone.minLevel = -std::numeric_limits<double>::infinity();
+            zone.maxLevel = std::numeric_limits<double>::infinity();
+        }
+        zone.locations = distinctSorted(ids[static_cast<size_t>(Column::Location)]);
+        zone.pollutants = distinctSorted(ids[static_cast<size_t>(Column::Pollutant)]);
+
+        writeChunk(block, Column::Location, encodeIntegers(ids[static_cast<size_t>(Column::Location)]));
+        writeChunk(block, Column::Pollutant, encodeIntegers(ids[static_cast<size_t>(Column::Pollutant)]));
+        writeChunk(block, Column::Level, encodeLevels(levels));
+        writeChunk(block, Column::Unit, encodeIntegers(ids[static_cast<size_t>(Column::Unit)]));
+        writeChunk(block, Column::Compliance, encodeIntegers(ids[static_cast<size_t>(Column::Compliance)]));
+        writeChunk(block, Column::Date, encodeIntegers(dates));
+        blocks.push_back(std::move(block));
+    }
+
+    std::string index;
+    for (const BlockInfo& block : blocks) {
+        const ZoneMap& zone = block.zone;
+        put<uint32_t>(index, zone.rows);
+        put<double>(index, zone.minLevel);
+        put<double>(index, zone.maxLevel);
+        put<int32_t>(index, zone.minYearMonth);
+        put<int32_t>(index, zone.maxYearMonth);
+        put<double>(index, zone.bounds.minEasting);
+        put<double>(index, zone.bounds.minNorthing);
+        put<double>(index, zone.bounds.maxEasting);
+        put<double>(index, zone.bounds.maxNorthing);
+        putIds(index, zone.locations);
+        putIds(index, zone.pollutants);
+        for (const ChunkRef& chunk : block.columns) {
+            put<uint64_t>(index, chunk.offset);
+            put<uint64_t>(index, chunk.size);
+        }
+    }
+    for (const DictionaryBuilder& builder : builders) {
+        put<uint32_t>(index, static_cast<uint32_t>(builder.getValues().size()));
+        for (const std::string& value : builder.getValues())
+            putString(index, value);
+    }
+    for (const GridPoint& position : locationPositions) {
+        put<double>(index, position.easting);
+        put<double>(index, position.northing);
+    }
+    uint64_t indexOffset = offset;
+    out.write(index.data(), index.size());
+
+    header.clear();
+    header.append(MAGIC, sizeof(MAGIC));
+    put<uint32_t>(header, BYTE_ORDER_MARK);
+    put<uint32_t>(header, FORMAT_VERSION);
+    put<uint64_t>(header, samples.size());
+    put<uint32_t>(header, blockRows);
+    put<uint32_t>(header, static_cast<uint32_t>(blocks.size()));
+    put<uint64_t>(header, indexOffset);
+    put<uint64_t>(header, index.size());
+    put<uint64_t>(header, sourceBytes);
+    out.seekp(0);
+    out.write(header.data(), header.size());
+    out.close();
+    if (!out)
+        throw std::runtime_error("Cannot write columnar file " + tmpPath);
+
+    std::filesystem::rename(tmpPath, path);
+}
+
+bool isFresh(const std::string& path, const std::string& sourcePath) {
+    std::error_code error;
+    auto cacheTime = std::filesystem::last_write_time(path, error);
+    if (error)
+        return false;
+    auto sourceTime = std::filesystem::last_write_time(sourcePath, error);
+    return !error && cacheTime >= sourceTime;
+}
+
+struct ColumnarFile::Mapping {
+    mio::mmap_source source;
+};
+
+ColumnarFile::ColumnarFile(const std::string& path) : mapping(new Mapping) {
+    // Mapped rather than read: opening only touches the header and index
+    // pages, and column chunks are paged in when a query decodes them
+    std::error_code error;
+    mapping->source.map(path, error);
+    if (error)
+        throw std::runtime_error("Cannot open columnar file " + path + ": " + error.message());
+
+    const char* header = mapping->source.data();
+    size_t fileSize = mapping->source.size();
+    if (fileSize < HEADER_SIZE || std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0)
+        throw std::runtime_error(path + " is not a columnar file");
+
+    Cursor cursor(header + sizeof(MAGIC), HEADER_SIZE - sizeof(MAGIC));
+    if (cursor.get<uint32_t>() != BYTE_ORDER_MARK)
+        throw std::runtime_error(path + " was written with a different byte order");
+    if (cursor.get<uint32_t>() != FORMAT_VERSION)
+        throw std::runtime_error(path + " has an unsupported columnar format version");
+    rows = cursor.get<uint64_t>();
+    cursor.get<uint32_t>(); // Block size, only needed by the writer
+    uint32_t blockCount = cursor.get<uint32_t>();
+    uint64_t indexOffset = cursor.get<uint64_t>();
+    uint64_t indexSize = cursor.get<uint64_t>();
+    sourceSize = cursor.get<uint64_t>();
+
+    if (indexOffset > fileSize || indexSize > fileSize - indexOffset)
+        throw std::runtime_error("Columnar file is truncated");
+
+    Cursor indexCursor(header + indexOffset, indexSize);
+    if (blockCount > indexSize / MIN_INDEX_ENTRY_SIZE)
+        throw std::runtime_error("Columnar file is truncated");
+    blocks.resize(blockCount);
+    uint64_t blockRowTotal = 0;
+    for (BlockInfo& block : blocks) {
+        ZoneMap& zone = block.zone;
+        zone.rows = indexCursor.get<uint32_t>();
+        zone.minLevel = indexCursor.get<double>();
+        zone.maxLevel = indexCursor.get<double>();
+        zone.minYearMonth = indexCursor.get<int32_t>();
+        zone.maxYearMonth = indexCursor.get<int32_t>();
+        zone.bounds.minEasting = indexCursor.get<double>();
+        zone.bounds.minNorthing = indexCursor.get<double>();
+        zone.bounds.maxEasting = indexCursor.get<double>();
+        zone.bounds.maxNorthing = indexCursor.get<double>();
+        zone.locations = getIds(indexCursor);
+        zone.pollutants = getIds(indexCursor);
+        for (ChunkRef& chunk : block.columns) {
+            chunk.offset = indexCursor.get<uint64_t>();
+            chunk.size = indexCursor.get<uint64_t>();
+            if (chunk.offset > indexOffset || chunk.size > indexOffset - chunk.offset)
+                throw std::runtime_error("Columnar file has a column chunk outside the data");
+        }
+        blockRowTotal += zone.rows;
+    }
+    for (size_t column = 0; column < COLUMN_COUNT; ++column) {
+        dictionaries[column].resize(indexCursor.getCount(sizeof(uint32_t)));
+        for (uint32_t id = 0; id < dictionaries[column].size(); ++id) {
+            dictionaries[column][id] = indexCursor.getString();
+            ids[column].emplace(dictionaries[column][id], id);
+        }
+    }
+    locationPositions.resize(dictionaries[static_cast<size_t>(Column::Location)].size());
+    for (GridPoint& position : locationPositions) {
+        position.easting = indexCursor.get<double>();
+        position.northing = indexCursor.get<double>();
+    }
+    for (const std::string& date : dictionaries[static_cast<size_t>(Column::Date)])
+        oddYearMonths.push_back(WaterSample("", "", 0.0, "", "", date).getYearMonth());
+
+    if (blockRowTotal != rows)
+        throw std::runtime_error("Columnar file index does not match its row count");
+}
+
+size_t ColumnarFile::rowCount() const {
+    return static_cast<size_t>(rows);
+}
+
+size_t ColumnarFile::approximateBytes() const {
+    size_t bytes = blocks.capacity() * sizeof(BlockInfo) + locationPositions.capacity() * sizeof(GridPoint) +
+                   oddYearMonths.capacity() * sizeof(int);
+    for (const BlockInfo& block : blocks)
+        bytes += (block.zone.locations.capacity() + block.zone.pollutants.capacity()) * sizeof(uint32_t);
+    for (size_t column = 0; column < COLUMN_COUNT; ++column) {
+        bytes += dictionaries[column].capacity() * sizeof(std::string) + hashMapBytes(ids[column]);
+        // Each value is held by the dictionary and again as a key of ids
+        for (const std::string& value : dictionaries[column])
+            bytes += 2 * heapBytes(value);
+    }
+    return bytes;
+}
+
+size_t ColumnarFile::blockCount() const {
+    return blocks.size();
+}
+
+const ZoneMap& ColumnarFile::zoneMap(size_t block) const {
+    return blocks.at(block).zone;
+}
+
+bool ColumnarFile::blockMayMatch(size_t block, const SampleFilter& filter, const ComplianceRules& rules) const {
+    const ZoneMap& zone = zoneMap(block);
+    if (zone.rows == 0)
+        return false;
+
+    if (filter.year != 0 && (filter.year < zone.minYearMonth / 100 || filter.year > zone.maxYearMonth / 100))
+        return false;
+
+    if (filter.area && !filter.area->bounds.intersects(zone.bounds))
+        return false;
+
+    if (!filter.location.empty()) {
+        int64_t id = findId(Column::Location, filter.location);
+        if (id < 0 || !std::binary_search(zone.locations.begin(), zone.locations.end(), static_cast<uint32_t>(id)))
+            return false;
+    }
+
+    std::vector<uint32_t> pollutants = zone.pollutants;
+    if (!filter.pollutant.empty()) {
+        int64_t id = findId(Column::Pollutant, filter.pollutant);
+        if (id < 0 || !std::binary_search(pollutants.begin(), pollutants.end(), static_cast<uint32_t>(id)))
+            return false;
+        pollutants.assign(1, static_cast<uint32_t>(id));
+    }
+
+    if (!filter.status)
+        return true;
+
+    // Good is one interval of levels, so a level range whose ends are both good
+    // only holds good rows; a pollutant without thresholds is always missing.
+    // Anything else may hold any status.
+    for (uint32_t id : pollutants) {
+        const std::string& pollutant = dictionaryValue(Column::Pollutant, id);
+        ComplianceStatus low = rules.assess(pollutant, zone.minLevel);
+        ComplianceStatus high = rules.assess(pollutant, zone.maxLevel);
+        if (low == ComplianceStatus::Missing || (low == ComplianceStatus::Good && high == ComplianceStatus::Good)) {
+            if (low == *filter.status)
+                return true;
+            continue;
+        }
+        return true;
+    }
+    return false;
+}
+
+ColumnarFile::~ColumnarFile() = default;
+
+const char* ColumnarFile::chunkData(size_t block, Column column) const {
+    // The constructor checked that every chunk lies inside the mapping
+    return mapping->source.data() + blocks.at(block).columns[static_cast<size_t>(column)].offset;
+}
+
+size_t ColumnarFile::chunkSize(size_t block, Column column) const {
+    return static_cast<size_t>(blocks.at(block).columns[static_cast<size_t>(column)].size);
+}
+
+std::vector<uint32_t> ColumnarFile::readIds(size_t block, Column column) const {
+    if (column == Column::Level || column == Column::Date || column == Column::Count)
+        throw std::runtime_error("Column does not hold dictionary ids");
+
+    std::vector<uint32_t> ids =
+        decodeChunk<uint32_t>(chunkData(block, column), chunkSize(block, column), blocks.at(block).zone.rows);
+    size_t dictionarySize = dictionary(column).size();
+    for (uint32_t id : ids) {
+        if (id >= dictionarySize)
+            throw std::runtime_error("Columnar file references a missing dictionary entry");
+    }
+    return ids;
+}
+
+std::vector<double> ColumnarFile::readLevels(size_t block) const {
+    return decodeChunk<double>(chunkData(block, Column::Level), chunkSize(block, Column::Level),
+                               blocks.at(block).zone.rows);
+}
+
+std::vector<int64_t> ColumnarFile::readDates(size_t block) const {
+    return decodeChunk<int64_t>(chunkData(block, Column::Date), chunkSize(block, Column::Date),
+                                blocks.at(block).zone.rows);
+}
+
+int64_t ColumnarFile::findId(Column column, const std::string& value) const {
+    dictionary(column); // Rejects columns without one
+    auto it = ids[static_cast<size_t>(column)].find(value);
+    return it == ids[static_cast<size_t>(column)].end() ? -1 : static_cast<int64_t>(it->second);
+}
+
+size_t ColumnarFile::dictionarySize(Column column) const {
+    return dictionary(column).size();
+}
+
+const std::string& ColumnarFile::dictionaryValue(Column column, uint32_t id) const {
+    return dictionary(column).at(id);
+}
+
+const GridPoint& ColumnarFile::locationPosition(uint32_t id) const {
+    return locationPositions.at(id);
+}
+
+std::string ColumnarFile::dateString(int64_t date) const {
+    const std::vector<std::string>& oddDates = dictionaries[static_cast<size_t>(Column::Date)];
+    if (date < ODD_DATE + static_cast<int64_t>(oddDates.size()))
+        return oddDates[static_cast<size_t>(date - ODD_DATE)];
+    return sampletime::format(date);
+}
+
+int ColumnarFile::yearMonth(int64_t date) const {
+    if (date < ODD_DATE + static_cast<int64_t>(oddYearMonths.size()))
+        return oddYearMonths[static_cast<size_t>(date - ODD_DATE)];
+    return sampletime::yearMonth(date);
+}
+
+const std::vector<std::string>& ColumnarFile::dictionary(Column column) const {
+    if (column == Column::Level || column == Column::Count)
+        throw std::runtime_error("Column has no dictionary");
+    return dictionaries[static_cast<size_t>(column)];
+}
+
+} // namespace columnar
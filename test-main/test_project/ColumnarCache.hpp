@@ -0,0 +1,124 @@
+#ifndef COLUMNARCACHE_HPP
+#define COLUMNARCACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "WaterSample.hpp"
+#include "ComplianceRules.hpp"
+#include "StatsEngine.hpp"
+
+// Columnar, block-structured copy of a dataset, written next to the CSV it
+// was converted from. Rows are split into blocks; each column of a block is
+// stored contiguously so a query only reads the columns it needs, and each
+// block carries a zone map so blocks that cannot match a filter are skipped.
+//
+// Layout (native little-endian):
+//   header | column chunks of block 0 | ... | block index | dictionaries
+// Strings (locations, pollutants, units, compliance flags) are stored once in
+// a dictionary and referenced by id, with each location's grid position after
+// the dictionaries; dates as seconds since 1970. Each column
+// chunk is bit-packed (frame of reference or delta, levels scaled to decimal
+// integers) when that is smaller than storing it plain.
+namespace columnar {
+
+enum class Column : uint8_t {
+    Location,
+    Pollutant,
+    Level,
+    Unit,
+    Compliance,
+    Date,
+    Count
+};
+
+constexpr size_t COLUMN_COUNT = static_cast<size_t>(Column::Count);
+constexpr uint32_t DEFAULT_BLOCK_ROWS = 16384;
+
+// What a block contains, used to rule it out without reading it
+struct ZoneMap {
+    uint32_t rows = 0;
+    double minLevel = 0.0;
+    double maxLevel = 0.0;
+    int minYearMonth = 0; // YYYYMM, 0 for malformed dates
+    int maxYearMonth = 0;
+    std::vector<uint32_t> locations; // Sorted dictionary ids
+    std::vector<uint32_t> pollutants;
+    GridBox bounds; // Of the rows' sampling points with a known position
+};
+
+struct ChunkRef {
+    uint64_t offset = 0;
+    uint64_t size = 0;
+};
+
+struct BlockInfo {
+    ZoneMap zone;
+    ChunkRef columns[COLUMN_COUNT];
+};
+
+// Writes samples to path in blocks of blockRows rows, recording that they were
+// read from the first sourceBytes bytes of the source CSV. Throws
+// std::runtime_error if the file cannot be written.
+void writeFile(const std::string& path, const std::vector<WaterSample>& samples,
+               uint32_t blockRows = DEFAULT_BLOCK_ROWS, uint64_t sourceBytes = 0);
+
+// True if path exists and is newer than sourcePath
+bool isFresh(const std::string& path, const std::string& sourcePath);
+
+// Read access to a file written by writeFile(). The file is memory mapped and
+// only the header and block index are parsed on open; a column chunk is paged
+// in when it is first decoded. Throws std::runtime_error if the file is
+// missing, truncated or not a columnar cache.
+class ColumnarFile {
+public:
+    explicit ColumnarFile(const std::string& path);
+    ~ColumnarFile();
+
+    size_t rowCount() const;
+    uint64_t sourceBytes() const { return sourceSize; } // As given to writeFile()
+    // Heap bytes of the parsed index and dictionaries, estimated; the mapped
+    // file itself is in the page cache
+    size_t approximateBytes() const;
+    size_t blockCount() const;
+    const ZoneMap& zoneMap(size_t block) const;
+
+    // False only if no row of the block can pass the filter
+    bool blockMayMatch(size_t block, const SampleFilter& filter, const ComplianceRules& rules) const;
+
+    // Decoded column values of one block
+    std::vector<uint32_t> readIds(size_t block, Column column) const; // Location, Pollutant, Unit, Compliance
+    std::vector<double> readLevels(size_t block) const;
+    std::vector<int64_t> readDates(size_t block) const;
+
+    // Dictionary id of value, or -1 if the file does not contain it
+    int64_t findId(Column column, const std::string& value) const;
+    size_t dictionarySize(Column column) const;
+    const std::string& dictionaryValue(Column column, uint32_t id) const;
+    const GridPoint& locationPosition(uint32_t id) const; // Unknown when the export had none
+    std::string dateString(int64_t date) const;
+    int yearMonth(int64_t date) const; // Same as WaterSample::getYearMonth() of dateString(date)
+
+private:
+    struct Mapping; // mio mapping, kept out of this header
+
+    const char* chunkData(size_t block, Column column) const;
+    size_t chunkSize(size_t block, Column column) const;
+    const std::vector<std::string>& dictionary(Column column) const;
+
+    std::unique_ptr<Mapping> mapping;
+    uint64_t rows = 0;
+    uint64_t sourceSize = 0;
+    std::vector<BlockInfo> blocks;
+    std::vector<std::string> dictionaries[COLUMN_COUNT]; // Date holds dates kept verbatim
+    std::unordered_map<std::string, uint32_t> ids[COLUMN_COUNT];
+    std::vector<GridPoint> locationPositions; // By location id
+    std::vector<int> oddYearMonths;
+};
+
+} // namespace columnar
+
+#endif // COLUMNARCACHE_HPP
@@ -1,17 +1,147 @@
 #include "ComplianceDashboard.hpp"
+#include <QHeaderView>
 #include "dataset.hpp"
 #include "WaterSample.hpp"
 #include "PollutantSample.hpp"
 #include "csv.hpp"
+#include "ColumnarCache.hpp"
+#include <algorithm>
 #include <iostream>
+#include <mutex>
+#include <optional>
 #include <string>
 
+// Most rows shown in the table when the data is streamed rather than loaded
+constexpr size_t STREAM_SAMPLE_ROWS = 20000;
+// Appends closer together than this are read in one go
+constexpr int TAIL_DELAY_MS = 250;
+// Filter changes closer together than this run one query
+constexpr int FILTER_DELAY_MS = 300;
+// Most locations suggested for the text typed in the location box
+constexpr size_t LOCATION_SUGGESTIONS = 50;
+const char* const FOOTER_TEXT = "Data provided by UK Environmental Agency.";
+
+namespace {
+
+// Queries for the same year may overlap, and each may write its cache
+std::mutex cacheWriteMutex;
+
+// The files a query for year reads; only the CSV for a single year, as its
+// columnar cache is rebuilt whenever the CSV changes
+std::vector<std::string> queryFiles(const std::string& year) {
+    std::vector<std::string> files;
+    if (year != "All Years") {
+        files.push_back("Y-" + year + "-M.csv");
+        return files;
+    }
+    for (int fileYear = 2020; fileYear <= 2024; ++fileYear)
+        files.push_back("Y-" + std::to_string(fileYear) + "-M.csv");
+    return files;
+}
+
+// Reads "easting, northing, radius" (a circle) or "min easting, min northing,
+// max easting, max northing" (a box), in metres, into area; blank text is no
+// area. False when the text is neither.
+bool parseArea(const QString& text, std::optional<SpatialArea>& area) {
+    area.reset();
+    if (text.trimmed().isEmpty())
+        return true;
+
+    QStringList parts = text.split(',');
+    std::vector<double> values;
+    for (const QString& part : parts) {
+        bool ok = false;
+        values.push_back(part.trimmed().toDouble(&ok));
+        if (!ok)
+            return false;
+    }
+    if (values.size() == 3 && values[2] > 0) {
+        area = SpatialArea::circle(GridPoint{values[0], values[1]}, values[2]);
+        return true;
+    }
+    if (values.size() == 4) {
+        area = SpatialArea::box(GridBox{std::min(values[0], values[2]), std::min(values[1], values[3]),
+                                        std::max(values[0], values[2]), std::max(values[1], values[3])});
+        return true;
+    }
+    return false;
+}
+
+// Loads the rows of year ("All Years" streams every year) that the dashboard
+// needs for filter into outcome. Runs on a worker thread; throws
+// QueryCancelled once cancel is.
+void runQuery(const std::string& year, const ComplianceRules& rules, const CancelToken& cancel,
+              QueryOutcome& outcome) {
+    WaterDataset& dataset = *outcome.dataset;
+    const SampleFilter& filter = outcome.filter;
+
+    if (year == "All Years") {
+        // Every year together may not fit in memory: stream the files and
+        // keep only a sample of the matching rows for the table
+        outcome.result = dataset.streamQuery(queryFiles(year), rules, filter, STREAM_SAMPLE_ROWS, &cancel);
+        return;
+    }
+
+    // A year is read from its columnar cache when that is newer than the CSV;
+    // otherwise the CSV is parsed once, sorted by location, pollutant and time
+    // so the cache blocks hold few locations each, and the cache written
+    std::string csvPath = "Y-" + year + "-M.csv";
+    std::string cachePath = "Y-" + year + "-M.wqc";
+    outcome.followPath = csvPath;
+    if (columnar::isFresh(cachePath, csvPath)) {
+        try {
+            // Rows written to the CSV after the part the cache holds are read
+            // by the tail, including any appended while the cache was written
+            outcome.result = dataset.loadColumnar(cachePath, rules, filter, &cancel);
+            outcome.followOffset = dataset.sourceBytes();
+            return;
+        } catch (const QueryCancelled&) {
+            throw;
+        } catch (const std::exception& e) {
+            std::cerr << "Ignoring " << cachePath << ": " << e.what() << std::endl;
+            dataset = WaterDataset();
+        }
+    }
+
+    // Rows written after the lines the load read are read by the tail
+    dataset.loadData(csvPath, &cancel);
+    outcome.followOffset = dataset.sourceBytes();
+    dataset.sortAndDeduplicate();
+    cancel.check();
+    try {
+        std::lock_guard<std::mutex> lock(cacheWriteMutex);
+        dataset.saveColumnar(cachePath);
+    } catch (const std::exception& e) {
+        std::cerr << "Cannot write " << cachePath << ": " << e.what() << std::endl;
+    }
+    cancel.check();
+    outcome.result = computeStats(dataset.getData(), rules, filter);
+}
+
+// Builds what the result panels read from the dataset on first use, so that
+// is done here rather than on the UI thread when the outcome is shown. After
+// loadColumnar() the aggregates and sketches cover every block of the file.
+void preparePanels(const WaterDataset& dataset, const SampleFilter& filter, const CancelToken& cancel) {
+    cancel.check();
+    dataset.getAggregates();
+    dataset.getSketches();
+    if (!filter.location.empty() && !filter.pollutant.empty())
+        dataset.getTimeSeries();
+}
+
+} // namespace
+
 ComplianceDashboard::ComplianceDashboard(QWidget *parent) : QMainWindow(parent) {
     initializeUI();
     loadTableData("Y-2024-M.csv");
 }
 
-ComplianceDashboard::~ComplianceDashboard() {}
+ComplianceDashboard::~ComplianceDashboard() {
+    // Workers post to this window; they must be done before it goes
+    queryCancel.cancel();
+    for (std::thread& worker : queryThreads)
+        worker.join();
+}
 
 void ComplianceDashboard::initializeUI() {
     // Central Widget
@@ -35,15 +165,28 @@ void ComplianceDashboard::initializeUI() {
     filterLocation = new QComboBox();
     filterLocation->addItems({"All Locations"});
 
+    std::vector<std::string> locationNames;
     for (const auto& row : reader1) {
-        filterLocation->addItems({QString::fromStdString(row["Location"].get<>())});
+        locationNames.push_back(row["Location"].get<>());
+        filterLocation->addItems({QString::fromStdString(locationNames.back())});
     }
+    locationSearch = LocationSearch(std::move(locationNames));
+
+    // Typing in the location box suggests the names found by locationSearch;
+    // the completer shows them as they are, in its order
+    filterLocation->setEditable(true);
+    filterLocation->setInsertPolicy(QComboBox::NoInsert);
+    locationMatches = new QStringListModel(this);
+    locationCompleter = new QCompleter(this);
+    locationCompleter->setModel(locationMatches);
+    locationCompleter->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    filterLocation->setCompleter(locationCompleter);
 
     filterPollutant = new QComboBox();
     filterPollutant->addItem("All Pollutants");
 
-    WaterDataset dataset;
-    std::vector<PollutantSample> pollutantSamples = dataset.loadPollutantSamples("pollutants.csv", 10);
+    pollutantSamples = dataset->loadPollutantSamples("pollutants.csv", 10);
+    complianceRules = ComplianceRules(pollutantSamples);
 
     for (const auto& sample : pollutantSamples) {
         filterPollutant->addItem(QString::fromStdString(sample.getName()));
@@ -52,13 +195,24 @@ void ComplianceDashboard::initializeUI() {
     filterStatus = new QComboBox();
     filterStatus->addItems({"All Statuses", "good", "medium", "bad"});
 
+    filterArea = new QLineEdit();
+    filterArea->setPlaceholderText("Area: E, N, radius or E1, N1, E2, N2");
+    filterArea->setToolTip("British National Grid metres: a circle around a point, or a box such as a catchment's");
+    filterArea->setClearButtonEnabled(true);
+
     applyFilterButton = new QPushButton("Filter");
 
+    followCheck = new QCheckBox("Follow file");
+    followCheck->setToolTip("Add rows appended to the year's CSV as they are written");
+    followCheck->setChecked(true);
+
     layoutFilters->addWidget(filterYear);
     layoutFilters->addWidget(filterLocation);
     layoutFilters->addWidget(filterPollutant);
     layoutFilters->addWidget(filterStatus);
+    layoutFilters->addWidget(filterArea);
     layoutFilters->addWidget(applyFilterButton);
+    layoutFilters->addWidget(followCheck);
 
     layoutMain->addLayout(layoutFilters);
 
@@ -66,8 +220,12 @@ void ComplianceDashboard::initializeUI() {
     layoutContent = new QHBoxLayout();
 
     // Detailed Table
-    dataTable = new QTableWidget(0, 6); // Start with 0 rows, 6 columns
-    dataTable->setHorizontalHeaderLabels({"Location", "Pollutant", "Level", "Unit", "Compliance", "Date"});
+    // Sorting by a header click reorders the model's row permutation
+    tableModel = new SampleTableModel(this);
+    dataTable = new QTableView();
+    dataTable->setModel(tableModel);
+    dataTable->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
+    dataTable->setSortingEnabled(true);
     dataTable->setMinimumSize(600, 300);
     layoutContent->addWidget(dataTable, 2);
 
@@ -80,6 +238,15 @@ void ComplianceDashboard::initializeUI() {
 
     layoutMain->addLayout(layoutContent);
 
+    // Trend of the selected location and pollutant, and where the sites are
+    QHBoxLayout *layoutCharts = new QHBoxLayout();
+    trendChart = new TrendChart();
+    layoutCharts->addWidget(trendChart, 2);
+    siteMap = new SiteMap();
+    connect(siteMap, &SiteMap::viewChanged, this, &ComplianceDashboard::summarizeMapView);
+    layoutCharts->addWidget(siteMap, 1);
+    layoutMain->addLayout(layoutCharts);
+
     // Summary Cards
     layoutCards = new QHBoxLayout();
 
@@ -93,7 +260,7 @@ void ComplianceDashboard::initializeUI() {
         QVBoxLayout *cardLayout = new QVBoxLayout();
 
         QLabel *cardTitle = new QLabel();
-        QLabel *cardDetails = new QLabel();
+        cardDetails[i] = new QLabel();
 
         if (i < pollutantSamples.size()) {
             const PollutantSample& sample = pollutantSamples[i];
@@ -103,24 +270,39 @@ void ComplianceDashboard::initializeUI() {
                                     .arg(QString::fromStdString(sample.getMinThreshold()))
                                     .arg(QString::fromStdString(sample.getMaxThreshold()))
                                     .arg(QString::fromStdString(sample.getInfo()));
-            cardDetails->setText(details);
+            cardDetails[i]->setText(details);
         } else {
             cardTitle->setText("No Data");
-            cardDetails->setText("No additional information available.");
+            cardDetails[i]->setText("No additional information available.");
         }
 
         cardTitle->setAlignment(Qt::AlignCenter);
-        cardDetails->setAlignment(Qt::AlignLeft);
+        cardDetails[i]->setAlignment(Qt::AlignLeft);
         cardLayout->addWidget(cardTitle);
-        cardLayout->addWidget(cardDetails);
+        cardLayout->addWidget(cardDetails[i]);
 
         summaryFrames[i]->setLayout(cardLayout);
         layoutCards->addWidget(summaryFrames[i]);
     }
+
+    // Anomalies found at ingest, across every pollutant
+    QFrame *anomalyFrame = new QFrame();
+    anomalyFrame->setFrameShape(QFrame::StyledPanel);
+    anomalyFrame->setStyleSheet("background-color: #f2f2f2; border: 1px solid #d9d9d9; padding: 10px;");
+    anomalyFrame->setMinimumHeight(200);
+    QVBoxLayout *anomalyLayout = new QVBoxLayout();
+    QLabel *anomalyTitle = new QLabel("Anomalies");
+    anomalyTitle->setAlignment(Qt::AlignCenter);
+    anomalyDetails = new QLabel("No data loaded.");
+    anomalyDetails->setAlignment(Qt::AlignLeft);
+    anomalyLayout->addWidget(anomalyTitle);
+    anomalyLayout->addWidget(anomalyDetails);
+    anomalyFrame->setLayout(anomalyLayout);
+    layoutCards->addWidget(anomalyFrame);
     layoutMain->addLayout(layoutCards);
 
     // Footer
-    footerText = new QLabel("Data provided by UK Environmental Agency.");
+    footerText = new QLabel(FOOTER_TEXT);
     footerText->setAlignment(Qt::AlignCenter);
     footerText->setStyleSheet("font-size: 12px; color: gray;");
     layoutMain->addWidget(footerText);
@@ -132,14 +314,36 @@ void ComplianceDashboard::initializeUI() {
 
     // Connect filter button to applySearchFilters
     connect(applyFilterButton, &QPushButton::clicked, this, &ComplianceDashboard::applySearchFilters);
+
+    connect(filterLocation->lineEdit(), &QLineEdit::textEdited, this, &ComplianceDashboard::searchLocations);
+    connect(locationCompleter, qOverload<const QString&>(&QCompleter::activated), this,
+            [this](const QString& name) { filterLocation->setCurrentIndex(filterLocation->findText(name)); });
+
+    // Filters also apply as the combo boxes change, once they settle
+    filterTimer = new QTimer(this);
+    filterTimer->setSingleShot(true);
+    filterTimer->setInterval(FILTER_DELAY_MS);
+    connect(filterTimer, &QTimer::timeout, this, &ComplianceDashboard::applySearchFilters);
+    for (QComboBox *box : {filterYear, filterLocation, filterPollutant, filterStatus})
+        connect(box, &QComboBox::currentIndexChanged, this, [this]() { filterTimer->start(); });
+    connect(filterArea, &QLineEdit::editingFinished, this, [this]() { filterTimer->start(); });
+
+    tailWatcher = new QFileSystemWatcher(this);
+    tailTimer = new QTimer(this);
+    tailTimer->setSingleShot(true);
+    tailTimer->setInterval(TAIL_DELAY_MS);
+    connect(tailWatcher, &QFileSystemWatcher::fileChanged, this, [this]() { tailTimer->start(); });
+    connect(tailTimer, &QTimer::timeout, this, &ComplianceDashboard::readAppendedRows);
+    // Catches up on what was appended while not following
+    connect(followCheck, &QCheckBox::toggled, this, &ComplianceDashboard::readAppendedRows);
 }
 
 void ComplianceDashboard::loadTableData(const std::string& filePath) {
-    WaterDataset dataset;
-    dataset.loadData(filePath);
+    stopFollowing();
+    dataset->loadData(filePath);
+    activeFilter = SampleFilter();
 
-    std::vector<PollutantSample> pollutantSamples = dataset.loadPollutantSamples("pollutants.csv", 10);
-    auto& samples = dataset.getData();
+    auto& samples = dataset->getData();
 
     if (samples.empty()) {
         QMessageBox::warning(this, "No Data Found",
@@ -147,146 +351,398 @@ void ComplianceDashboard::loadTableData(const std::string& filePath) {
         return;
     }
 
-    dataTable->setRowCount(samples.size());
-    dataTable->setColumnCount(6); // Number of columns
-    dataTable->setHorizontalHeaderLabels({"Location", "Pollutant", "Level", "Unit", "Date", "Compliance"});
-
-    int row = 0;
-    for (const auto& sample : samples) {
-        std::string complianceStatus = assessPerformanceStatus(sample, pollutantSamples);
-
-        auto *itemLocation = new QTableWidgetItem(QString::fromStdString(sample.getLocation()));
-        auto *itemPollutant = new QTableWidgetItem(QString::fromStdString(sample.getPollutant()));
-        auto *itemLevel = new QTableWidgetItem(QString::number(sample.getLevel()));
-        auto *itemUnit = new QTableWidgetItem(QString::fromStdString(sample.getUnit()));
-        auto *itemDate = new QTableWidgetItem(QString::fromStdString(sample.getSampleDate()));
-        auto *itemCompliance = new QTableWidgetItem(QString::fromStdString(complianceStatus));
-
-        // Set background color based on compliance status
-        QColor rowColor;
-        if (complianceStatus == "good") {
-            rowColor = QColor(0, 255, 0); // Green
-        } else if (complianceStatus == "medium") {
-            rowColor = QColor(255, 165, 0); // Orange
-        } else if (complianceStatus == "bad") {
-            rowColor = QColor(255, 0, 0); // Red
-        } else {
-            rowColor = QColor(255, 255, 255); // White for missing data
-        }
+    FilterResult result = computeStats(samples, complianceRules, activeFilter);
+    populateTable(samples, result);
+    // Rows written after the lines the load read are read by the tail
+    followFile(filePath, dataset->sourceBytes());
+}
 
-        // Apply background color to each item
-        itemLocation->setBackground(rowColor);
-        itemPollutant->setBackground(rowColor);
-        itemLevel->setBackground(rowColor);
-        itemUnit->setBackground(rowColor);
-        itemDate->setBackground(rowColor);
-        itemCompliance->setBackground(rowColor);
-
-        // Add items to the table
-        dataTable->setItem(row, 0, itemLocation);
-        dataTable->setItem(row, 1, itemPollutant);
-        dataTable->setItem(row, 2, itemLevel);
-        dataTable->setItem(row, 3, itemUnit);
-        dataTable->setItem(row, 4, itemDate);
-        dataTable->setItem(row, 5, itemCompliance);
-
-        row++;
-    }
+
+void ComplianceDashboard::searchLocations(const QString& text) {
+    QStringList matches;
+    for (size_t position : locationSearch.search(text.toStdString(), LOCATION_SUGGESTIONS))
+        matches.append(QString::fromStdString(locationSearch.names()[position]));
+    locationMatches->setStringList(matches);
+    locationCompleter->complete();
 }
 
 
 void ComplianceDashboard::applySearchFilters() {
     QString selectedYear = filterYear->currentText();
-    QString selectedLocation = filterLocation->currentText();
+    // The location chosen, not any text still being typed
+    QString selectedLocation = filterLocation->itemText(filterLocation->currentIndex());
     QString selectedPollutant = filterPollutant->currentText();
     QString selectedStatus = filterStatus->currentText();
 
-    WaterDataset dataset;
-    std::vector<PollutantSample> pollutantSamples = dataset.loadPollutantSamples("pollutants.csv", 10);
-
-    if (selectedYear == "All Years") {
-        for (int year = 2020; year <= 2024; ++year) {
-            try {
-                WaterDataset tempDataset;
-                tempDataset.loadData("Y-" + std::to_string(year) + "-M.csv");
-                dataset.appendData(tempDataset.getData());
-            } catch (...) {
-                continue; // Ignore missing files
-            }
-        }
-    } else {
-        dataset.loadData("Y-" + selectedYear.toStdString() + "-M.csv");
+    QueryKey key;
+    key.year = selectedYear.toStdString();
+    SampleFilter& filter = key.filter;
+    if (selectedLocation != "All Locations")
+        filter.location = selectedLocation.toStdString();
+    if (selectedPollutant != "All Pollutants")
+        filter.pollutant = selectedPollutant.toStdString();
+    if (selectedStatus == "good")
+        filter.status = ComplianceStatus::Good;
+    else if (selectedStatus == "medium")
+        filter.status = ComplianceStatus::Medium;
+    else if (selectedStatus == "bad")
+        filter.status = ComplianceStatus::Bad;
+    if (!parseArea(filterArea->text(), filter.area)) {
+        filterTimer->stop();
+        QMessageBox::warning(this, "Invalid Area",
+                             "Enter an area as easting, northing, radius or as two opposite corners "
+                             "easting, northing, easting, northing, in metres.");
+        return;
+    }
+    key.version = sourceVersion(queryFiles(key.year));
+
+    // A query still running is stale now: it stops at its next cancellation
+    // check and its outcome is dropped
+    filterTimer->stop();
+    queryCancel.cancel();
+    queryCancel = CancelToken();
+    uint64_t generation = ++queryGeneration;
+
+    cacheShownOutcome();
+    if (std::shared_ptr<QueryOutcome> cached = queryCache.find(key)) {
+        showQueryOutcome(key, cached);
+        return;
     }
 
-    const auto& samples = dataset.getData();
-    dataTable->setRowCount(0);
+    // The query runs on a worker thread while the current result stays on
+    // screen
+    footerText->setText("Loading...");
+    auto outcome = std::make_shared<QueryOutcome>();
+    outcome->filter = filter;
+    queryThreads.emplace_back([this, key, outcome, generation, cancel = queryCancel, rules = complianceRules]() {
+        bool completed = false;
+        try {
+            runQuery(key.year, rules, cancel, *outcome);
+            preparePanels(*outcome->dataset, outcome->filter, cancel);
+            completed = true;
+        } catch (const QueryCancelled&) {
+        } catch (const std::exception& e) {
+            std::cerr << "Query failed: " << e.what() << std::endl;
+        }
+        std::thread::id worker = std::this_thread::get_id();
+        QMetaObject::invokeMethod(this, [this, key, outcome, generation, completed, worker]() {
+            finishQuery(worker);
+            if (!completed)
+                return;
+            // Kept even when superseded: it is likely to be asked for again
+            queryCache.insert(key, outcome);
+            if (generation == queryGeneration)
+                showQueryOutcome(key, outcome);
+        }, Qt::QueuedConnection);
+    });
+}
 
-    for (const auto& sample : samples) {
-        if (selectedLocation != "All Locations" && sample.getLocation() != selectedLocation.toStdString())
-            continue;
-        if (selectedPollutant != "All Pollutants" && sample.getPollutant() != selectedPollutant.toStdString())
-            continue;
-        std::string complianceStatus = assessPerformanceStatus(sample, pollutantSamples);
-        if (selectedStatus != "All Statuses" && complianceStatus != selectedStatus.toStdString())
-            continue;
 
-        int row = dataTable->rowCount();
-        dataTable->insertRow(row);
-
-        auto *itemLocation = new QTableWidgetItem(QString::fromStdString(sample.getLocation()));
-        auto *itemPollutant = new QTableWidgetItem(QString::fromStdString(sample.getPollutant()));
-        auto *itemLevel = new QTableWidgetItem(QString::number(sample.getLevel()));
-        auto *itemUnit = new QTableWidgetItem(QString::fromStdString(sample.getUnit()));
-        auto *itemDate = new QTableWidgetItem(QString::fromStdString(sample.getSampleDate()));
-        auto *itemCompliance = new QTableWidgetItem(QString::fromStdString(complianceStatus));
-
-        // Set background color based on compliance status
-        QColor rowColor;
-        if (complianceStatus == "good") {
-            rowColor = QColor(0, 255, 0); // Green
-        } else if (complianceStatus == "medium") {
-            rowColor = QColor(255, 165, 0); // Orange
-        } else if (complianceStatus == "bad") {
-            rowColor = QColor(255, 0, 0); // Red
-        } else {
-            rowColor = QColor(255, 255, 255); // White for missing data
+void ComplianceDashboard::finishQuery(std::thread::id worker) {
+    for (auto it = queryThreads.begin(); it != queryThreads.end(); ++it) {
+        if (it->get_id() == worker) {
+            it->join(); // It has nothing left to do but return
+            queryThreads.erase(it);
+            break;
         }
+    }
+    if (queryThreads.empty())
+        footerText->setText(FOOTER_TEXT);
+}
+
+
+void ComplianceDashboard::showQueryOutcome(const QueryKey& key, const std::shared_ptr<QueryOutcome>& outcome) {
+    activeFilter = outcome->filter;
+    stopFollowing();
+    tableModel->clear(); // It points into the dataset about to be replaced
+    dataset = outcome->dataset;
+    shownKey = key;
+    shownChanged = false;
+
+    std::vector<WaterSample> noRows; // getData() throws when nothing matched
+    populateTable(outcome->result.rows.empty() ? noRows : dataset->getData(), outcome->result);
+    // A cached outcome resumes following where it stopped
+    if (!outcome->followPath.empty())
+        followFile(outcome->followPath, outcome->followOffset);
+}
+
+
+void ComplianceDashboard::cacheShownOutcome() {
+    if (!shownKey || !shownChanged)
+        return;
+
+    // The shown dataset has grown since it was cached under the file's old
+    // version; it is cached again, with the live result, under the new one.
+    // Any rows appended past tailOffset are read when it is followed again.
+    queryCache.erase(*shownKey);
+    auto outcome = std::make_shared<QueryOutcome>();
+    outcome->filter = activeFilter;
+    outcome->dataset = dataset;
+    outcome->result = liveQuery.result();
+    outcome->followPath = tailPath;
+    outcome->followOffset = tailOffset;
+    shownKey->version = sourceVersion(queryFiles(shownKey->year));
+    queryCache.insert(*shownKey, outcome);
+    shownChanged = false;
+}
+
 
-        itemLocation->setBackground(rowColor);
-        itemPollutant->setBackground(rowColor);
-        itemLevel->setBackground(rowColor);
-        itemUnit->setBackground(rowColor);
-        itemDate->setBackground(rowColor);
-        itemCompliance->setBackground(rowColor);
-
-        // Add items to the table
-        dataTable->setItem(row, 0, itemLocation);
-        dataTable->setItem(row, 1, itemPollutant);
-        dataTable->setItem(row, 2, itemLevel);
-        dataTable->setItem(row, 3, itemUnit);
-        dataTable->setItem(row, 4, itemDate);
-        dataTable->setItem(row, 5, itemCompliance);
+void ComplianceDashboard::populateTable(const std::vector<WaterSample>& samples, const FilterResult& result) {
+    // A new result is shown unsorted, in dataset order
+    dataTable->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
+    tableModel->setRows(samples, result, dataset->getAnomalyScores());
+    // Kept up to date from here on as rows are appended
+    liveQuery = LiveQuery(complianceRules, activeFilter, result, samples, dataset->getAnomalyScores());
+    updateResultPanels();
+    siteMap->fitView();
+}
+
+
+void ComplianceDashboard::updateResultPanels() {
+    updateStatsPanels();
+    updateTrendChart(liveQuery.result());
+    updateSiteMap();
+}
+
+
+void ComplianceDashboard::updateStatsPanels() {
+    const FilterResult& result = liveQuery.result();
+    const DatasetStats& stats = result.stats;
+    displayStats(stats.topLocation, stats.bottomLocation,
+                 stats.topYear, stats.bottomYear,
+                 stats.topPollutant, stats.bottomPollutant,
+                 stats.totals.total(), stats.totals.missing, stats.totals.good,
+                 stats.totals.medium, stats.totals.bad);
+    if (result.rows.size() < static_cast<size_t>(stats.totals.total()))
+        infoBox->append(QString("\nTable shows a random sample of %1 of these entries").arg(result.rows.size()));
+    if (activeFilter.area)
+        infoBox->append(QString("\nSampling points in the area: %1")
+                            .arg(dataset->getSpatialIndex().within(*activeFilter.area).size()));
+    infoBox->append(QString("\nDistinct sampling points: ~%1")
+                        .arg(qRound64(dataset->getSketches().distinctSamplingPoints(activeFilter.pollutant,
+                                                                                   activeFilter.year))));
+    updateSummaryCards(stats);
+    updateAnomalyCard();
+}
+
+
+void ComplianceDashboard::updateAnomalyCard() {
+    QString details = QString("Levels over %1 sd above their site's recent history\n\n"
+                              "Flagged: %2 of %3 rows shown")
+                          .arg(AnomalyDetector::THRESHOLD)
+                          .arg(liveQuery.anomalyCount())
+                          .arg(liveQuery.result().rows.size());
+    std::vector<std::pair<SeriesKey, int>> ranked = liveQuery.mostAnomalous(3);
+    if (!ranked.empty())
+        details += "\n\nMost flagged:";
+    for (const auto& entry : ranked)
+        details += QString("\n%1, %2: %3")
+                       .arg(QString::fromStdString(entry.first.location))
+                       .arg(QString::fromStdString(entry.first.pollutant))
+                       .arg(entry.second);
+    anomalyDetails->setText(details);
+}
+
+
+void ComplianceDashboard::followFile(const std::string& filePath, uint64_t offset) {
+    tailPath = filePath;
+    tailOffset = offset;
+    tailWatcher->addPath(QString::fromStdString(filePath));
+    // Rows may have been appended while the file was being loaded
+    readAppendedRows();
+}
+
+
+void ComplianceDashboard::stopFollowing() {
+    tailTimer->stop();
+    if (!tailWatcher->files().isEmpty())
+        tailWatcher->removePaths(tailWatcher->files());
+    tailPath.clear();
+}
+
+
+void ComplianceDashboard::readAppendedRows() {
+    if (tailPath.empty() || !followCheck->isChecked())
+        return;
+
+    // A file replaced by a rename stops being watched
+    QString watched = QString::fromStdString(tailPath);
+    if (!tailWatcher->files().contains(watched))
+        tailWatcher->addPath(watched);
+
+    size_t appended;
+    try {
+        appended = dataset->appendFromFile(tailPath, tailOffset);
+    } catch (const std::exception& e) {
+        // Replaced or truncated rather than appended to: read it again. The
+        // reload follows the file anew once it is done. The shown rows no
+        // longer match the file, so they are not cached again.
+        std::cerr << "Reloading " << tailPath << ": " << e.what() << std::endl;
+        stopFollowing();
+        if (shownKey)
+            queryCache.erase(*shownKey);
+        shownKey.reset();
+        applySearchFilters();
+        return;
     }
+    if (appended == 0)
+        return;
+    shownChanged = true;
+
+    // Only the new rows are filtered and counted; they go to the bottom of
+    // the table, which is no longer sorted
+    const std::vector<WaterSample>& samples = dataset->getData();
+    size_t firstPosition = liveQuery.update(samples, dataset->getAnomalyScores());
+    dataTable->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
+    tableModel->appendRows(samples, liveQuery.result(), firstPosition, dataset->getAnomalyScores());
+    updateStatsPanels();
+
+    // The chart and map are redrawn only when the new rows change them, so
+    // a batch costs time in its own rows rather than the shown series or sites
+    bool seriesChanged = std::any_of(samples.end() - appended, samples.end(), [this](const WaterSample& sample) {
+        return sample.getLocation() == activeFilter.location && sample.getPollutant() == activeFilter.pollutant;
+    });
+    if (seriesChanged)
+        updateTrendChart(liveQuery.result());
+    updateAppendedSites(firstPosition);
 }
 
 
-std::string ComplianceDashboard::assessPerformanceStatus(const WaterSample& sample, const std::vector<PollutantSample>& pollutantSamples) {
-    for (const auto& pollutant : pollutantSamples) {
-        if (sample.getPollutant() == pollutant.getName()) {
-            double sampleLevel = sample.getLevel();
-            double minThreshold = std::stod(pollutant.getMinThreshold());
-            double maxThreshold = std::stod(pollutant.getMaxThreshold());
-            double range = maxThreshold - minThreshold;
-
-            if (sampleLevel >= minThreshold && sampleLevel <= maxThreshold)
-                return "good";
-            else if (sampleLevel >= minThreshold - 0.2 * range && sampleLevel <= maxThreshold + 0.2 * range)
-                return "medium";
-            else
-                return "bad";
+void ComplianceDashboard::updateTrendChart(const FilterResult& result) {
+    if (activeFilter.location.empty() || activeFilter.pollutant.empty()) {
+        trendChart->clear("Select a location and a pollutant to plot their levels");
+        return;
+    }
+    if (result.rows.empty()) {
+        trendChart->clear("No samples match the filter");
+        return;
+    }
+
+    // Every sample of the pair in the year, whatever the status filter, from
+    // the CSV or the columnar cache alike; when streamed, only the sample of
+    // the matching rows
+    QString title = QString("%1 at %2").arg(QString::fromStdString(activeFilter.pollutant))
+                        .arg(QString::fromStdString(activeFilter.location));
+    if (result.rows.size() < static_cast<size_t>(result.stats.totals.total()))
+        title += " (sample)";
+    trendChart->setSeries(dataset->getTimeSeries().series(activeFilter.location, activeFilter.pollutant), title);
+}
+
+
+void ComplianceDashboard::updateSiteMap() {
+    const SpatialIndex& index = dataset->getSpatialIndex();
+    mappedSites.clear();
+    if (index.size() == 0) {
+        siteMap->clear("No sampling point coordinates in this data");
+        return;
+    }
+
+    // Per-site counts come from the result's accumulator, not the rows, so
+    // streamed results map every matching site and not only the sample
+    const StatsAccumulator& counts = liveQuery.result().accumulator;
+    for (const auto& point : index.points()) {
+        StatusCounts siteCounts = counts.locationCounts(point.first);
+        if (siteCounts.total() > 0)
+            mappedSites[point.first] = MapSite{point.first, point.second, worstStatus(siteCounts)};
+    }
+    drawMappedSites();
+}
+
+
+void ComplianceDashboard::updateAppendedSites(size_t firstPosition) {
+    const SpatialIndex& index = dataset->getSpatialIndex();
+    if (index.size() == 0) {
+        siteMap->clear("No sampling point coordinates in this data");
+        return;
+    }
+
+    // Only the sites of the new selected rows have new counts. A site's worst
+    // status seldom changes, so most batches leave the clusters as they are.
+    const FilterResult& result = liveQuery.result();
+    const std::vector<WaterSample>& samples = dataset->getData();
+    bool changed = false;
+    for (size_t position = firstPosition; position < result.rows.size(); ++position) {
+        const std::string& location = samples[result.rows[position]].getLocation();
+        GridPoint point = index.find(location);
+        if (!point.known())
+            continue;
+        MapSite site{location, point, worstStatus(result.accumulator.locationCounts(location))};
+        auto mapped = mappedSites.find(location);
+        if (mapped == mappedSites.end()) {
+            mappedSites.emplace(location, std::move(site));
+            changed = true;
+        } else if (mapped->second.worst != site.worst || mapped->second.position.easting != point.easting ||
+                   mapped->second.position.northing != point.northing) {
+            mapped->second = std::move(site);
+            changed = true;
         }
     }
-    return "-"; // Unknown pollutant
+    if (changed)
+        drawMappedSites();
+    else if (!mappedSites.empty())
+        summarizeMapView(siteMap->visibleArea());
+}
+
+
+void ComplianceDashboard::drawMappedSites() {
+    if (mappedSites.empty()) {
+        siteMap->clear("No mapped sampling points match the filter");
+        return;
+    }
+    std::vector<MapSite> sites;
+    sites.reserve(mappedSites.size());
+    for (const auto& site : mappedSites)
+        sites.push_back(site.second);
+    siteMap->setSites(SiteHierarchy(std::move(sites)));
+    summarizeMapView(siteMap->visibleArea());
+}
+
+
+void ComplianceDashboard::summarizeMapView(const GridBox& view) {
+    // Summed from the result's per-location counts of the points in view,
+    // so panning never visits the rows
+    StatusCounts counts = liveQuery.result().accumulator.countsWithin(dataset->getSpatialIndex(),
+                                                                      SpatialArea::box(view));
+    siteMap->setSummary(QString("In view: %1 bad, %2 medium, %3 good").arg(counts.bad).arg(counts.medium)
+                            .arg(counts.good));
+}
+
+
+void ComplianceDashboard::updateSummaryCards(const DatasetStats& stats) {
+    for (size_t i = 0; i < 4 && i < pollutantSamples.size(); ++i) {
+        const PollutantSample& sample = pollutantSamples[i];
+        StatusCounts counts;
+        auto it = stats.byPollutant.find(sample.getName());
+        if (it != stats.byPollutant.end())
+            counts = it->second;
+
+        // Level summary comes from the incremental aggregates, not a row scan
+        RunningStats levels = dataset->getAggregates().summarize(activeFilter.location, sample.getName(),
+                                                                activeFilter.year);
+        TDigest digest = dataset->getSketches().levelDigest(activeFilter.location, sample.getName(),
+                                                           activeFilter.year);
+
+        QString details = QString("Unit: %1\nMin Threshold: %2\nMax Threshold: %3\nInfo: %4\n\n"
+                                  "Samples: %5\nGood: %6  Medium: %7  Bad: %8\n"
+                                  "Level: %9\nMedian: %10  P95: %11")
+                                .arg(QString::fromStdString(sample.getUnit()))
+                                .arg(QString::fromStdString(sample.getMinThreshold()))
+                                .arg(QString::fromStdString(sample.getMaxThreshold()))
+                                .arg(QString::fromStdString(sample.getInfo()))
+                                .arg(counts.total())
+                                .arg(counts.good)
+                                .arg(counts.medium)
+                                .arg(counts.bad)
+                                .arg(levels.count == 0 ? QString("-")
+                                                       : QString("mean %1, sd %2 (%3 to %4)")
+                                                             .arg(levels.mean, 0, 'g', 4)
+                                                             .arg(levels.stddev(), 0, 'g', 4)
+                                                             .arg(levels.min, 0, 'g', 4)
+                                                             .arg(levels.max, 0, 'g', 4))
+                                .arg(digest.quantile(0.5), 0, 'g', 4)
+                                .arg(digest.quantile(0.95), 0, 'g', 4);
+        cardDetails[i]->setText(details);
+    }
 }
 
 
@@ -295,5 +751,33 @@ void ComplianceDashboard::displayStats(const std::string& topLocation, const std
                                        const std::string& topPollutant, const std::string& bottomPollutant,
                                        int totalEntries, int missingEntryCount, int compliantEntries,
                                        int averageEntries, int nonCompliantEntries) {
-    // Implementation for displaying statistics
+    auto percent = [totalEntries](int count) {
+        return totalEntries == 0 ? 0.0 : 100.0 * count / totalEntries;
+    };
+
+    QString summary = QString("Entries shown: %1\n"
+                              "Compliant (good): %2 (%3%)\n"
+                              "Average (medium): %4 (%5%)\n"
+                              "Non-compliant (bad): %6 (%7%)\n"
+                              "Missing thresholds: %8 (%9%)\n\n")
+                          .arg(totalEntries)
+                          .arg(compliantEntries).arg(percent(compliantEntries), 0, 'f', 1)
+                          .arg(averageEntries).arg(percent(averageEntries), 0, 'f', 1)
+                          .arg(nonCompliantEntries).arg(percent(nonCompliantEntries), 0, 'f', 1)
+                          .arg(missingEntryCount).arg(percent(missingEntryCount), 0, 'f', 1);
+
+    summary += QString("Most compliant location: %1\n"
+                       "Least compliant location: %2\n\n"
+                       "Most compliant year: %3\n"
+                       "Least compliant year: %4\n\n"
+                       "Most compliant pollutant: %5\n"
+                       "Least compliant pollutant: %6")
+                   .arg(QString::fromStdString(topLocation))
+                   .arg(QString::fromStdString(bottomLocation))
+                   .arg(QString::fromStdString(topYear))
+                   .arg(QString::fromStdString(bottomYear))
+                   .arg(QString::fromStdString(topPollutant))
+                   .arg(QString::fromStdString(bottomPollutant));
+
+    infoBox->setPlainText(summary);
 }
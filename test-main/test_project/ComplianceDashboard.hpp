@@ -2,7 +2,7 @@
 #define COMPLIANCEDASHBOARD_HPP
 
 #include <QMainWindow>
-#include <QTableWidget>
+#include <QTableView>
 #include <QComboBox>
 #include <QPushButton>
 #include <QTextEdit>
@@ -10,9 +10,29 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QMessageBox>
+#include <QCheckBox>
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <QLineEdit>
+#include <QCompleter>
+#include <QStringListModel>
+#include <list>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <unordered_map>
 
 #include "WaterSample.hpp"
 #include "PollutantSample.hpp"
+#include "ComplianceRules.hpp"
+#include "StatsEngine.hpp"
+#include "dataset.hpp"
+#include "SampleTableModel.hpp"
+#include "TrendChart.hpp"
+#include "SiteMap.hpp"
+#include "LiveQuery.hpp"
+#include "QueryCache.hpp"
+#include "LocationSearch.hpp"
 
 class ComplianceDashboard : public QMainWindow {
     Q_OBJECT
@@ -24,10 +44,25 @@ public:
 private:
     void initializeUI();
     void loadTableData(const std::string& filePath);
+    void searchLocations(const QString& text);
     void applySearchFilters();
+    void finishQuery(std::thread::id worker);
+    void showQueryOutcome(const QueryKey& key, const std::shared_ptr<QueryOutcome>& outcome);
+    void cacheShownOutcome();
+    void populateTable(const std::vector<WaterSample>& samples, const FilterResult& result);
+    void updateResultPanels();
+    void updateStatsPanels();
+    void followFile(const std::string& filePath, uint64_t offset);
+    void stopFollowing();
+    void readAppendedRows();
+    void updateSummaryCards(const DatasetStats& stats);
+    void updateTrendChart(const FilterResult& result);
+    void updateSiteMap();
+    void updateAppendedSites(size_t firstPosition);
+    void drawMappedSites();
+    void summarizeMapView(const GridBox& view);
+    void updateAnomalyCard();
 
-    // Updated method to calculate compliance status
-    std::string assessPerformanceStatus(const WaterSample& sample, const std::vector<PollutantSample>& pollutantSamples);
     void displayStats(const std::string& topLocation, const std::string& bottomLocation,
                       const std::string& topYear, const std::string& bottomYear,
                       const std::string& topPollutant, const std::string& bottomPollutant,
@@ -39,17 +74,53 @@ private:
     QHBoxLayout *layoutFilters;
     QHBoxLayout *layoutContent;
     QHBoxLayout *layoutCards; 
-    QTableWidget *dataTable;
+    QTableView *dataTable;
+    SampleTableModel *tableModel;
     QComboBox *filterYear;
     QComboBox *filterLocation;
+    QCompleter *locationCompleter;
+    QStringListModel *locationMatches; // The completer's suggestions for the text typed
     QComboBox *filterPollutant;
     QComboBox *filterStatus;
+    QLineEdit *filterArea;
     QPushButton *applyFilterButton;
+    QCheckBox *followCheck;
     QTextEdit *infoBox;
+    TrendChart *trendChart;
+    SiteMap *siteMap;
     QLabel *footerText;
     QFrame *summaryFrames[4];
+    QLabel *cardDetails[4];
+    QLabel *anomalyDetails;
     QLabel *headerText;
 
+    std::shared_ptr<WaterDataset> dataset = std::make_shared<WaterDataset>(); // Shared with queryCache
+    SampleFilter activeFilter;
+    LiveQuery liveQuery; // The active filter's result, extended as rows are appended
+    std::unordered_map<std::string, MapSite> mappedSites; // The sites on siteMap, by location
+
+    // Tail-follow: rows appended to the shown year's CSV are read as they
+    // arrive. Change notifications are coalesced by tailTimer.
+    QFileSystemWatcher *tailWatcher;
+    QTimer *tailTimer;
+    std::string tailPath; // Empty when not following
+    uint64_t tailOffset = 0; // End of the rows read so far
+    std::vector<PollutantSample> pollutantSamples;
+    ComplianceRules complianceRules;
+    LocationSearch locationSearch;
+
+    // Filter queries run on worker threads. Only the latest one's outcome
+    // is shown; starting a query cancels the one before.
+    QTimer *filterTimer;
+    std::list<std::thread> queryThreads;
+    CancelToken queryCancel;
+    uint64_t queryGeneration = 0;
+
+    // Outcomes of recent queries, so going back to a filter shows it at once
+    QueryCache queryCache;
+    std::optional<QueryKey> shownKey; // The shown outcome's, when it came from a query
+    bool shownChanged = false; // Rows were appended since the outcome was cached
+
     // Add other variables as needed...
 };
 
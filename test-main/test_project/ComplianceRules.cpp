@@ -0,0 +1,49 @@
+#include "ComplianceRules.hpp"
+#include <stdexcept>
+
+const char* complianceStatusName(ComplianceStatus status) {
+    switch (status) {
+    case ComplianceStatus::Good:
+        return "good";
+    case ComplianceStatus::Medium:
+        return "medium";
+    case ComplianceStatus::Bad:
+        return "bad";
+    default:
+        return "-";
+    }
+}
+
+ComplianceStatus classifyLevel(double level, double minThreshold, double maxThreshold) {
+    double range = maxThreshold - minThreshold;
+
+    if (level >= minThreshold && level <= maxThreshold)
+        return ComplianceStatus::Good;
+    else if (level >= minThreshold - 0.2 * range && level <= maxThreshold + 0.2 * range)
+        return ComplianceStatus::Medium;
+    else
+        return ComplianceStatus::Bad;
+}
+
+ComplianceRules::ComplianceRules(const std::vector<PollutantSample>& pollutantSamples) {
+    for (const auto& pollutant : pollutantSamples) {
+        try {
+            Thresholds limits{std::stod(pollutant.getMinThreshold()), std::stod(pollutant.getMaxThreshold())};
+            // First definition wins, matching the old linear lookup
+            thresholds.emplace(pollutant.getName(), limits);
+        } catch (const std::exception&) {
+            continue; // Pollutant without numeric thresholds stays unclassified
+        }
+    }
+}
+
+ComplianceStatus ComplianceRules::assess(const WaterSample& sample) const {
+    return assess(sample.getPollutant(), sample.getLevel());
+}
+
+ComplianceStatus ComplianceRules::assess(const std::string& pollutant, double level) const {
+    auto it = thresholds.find(pollutant);
+    if (it == thresholds.end())
+        return ComplianceStatus::Missing;
+    return classifyLevel(level, it->second.min, it->second.max);
+}
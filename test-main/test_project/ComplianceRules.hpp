@@ -0,0 +1,42 @@
+#ifndef COMPLIANCERULES_HPP
+#define COMPLIANCERULES_HPP
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "WaterSample.hpp"
+#include "PollutantSample.hpp"
+
+enum class ComplianceStatus {
+    Missing, // No thresholds known for the pollutant
+    Good,
+    Medium,
+    Bad
+};
+
+// Name shown in the table and used by the status filter ("good", "medium", "bad", "-")
+const char* complianceStatusName(ComplianceStatus status);
+
+// Good inside [min, max], medium within 20% of the range outside it, bad otherwise
+ComplianceStatus classifyLevel(double level, double minThreshold, double maxThreshold);
+
+// Pollutant thresholds parsed once so samples can be classified without
+// re-reading pollutants.csv or calling std::stod per row
+class ComplianceRules {
+public:
+    ComplianceRules() = default;
+    explicit ComplianceRules(const std::vector<PollutantSample>& pollutantSamples);
+
+    ComplianceStatus assess(const WaterSample& sample) const;
+    ComplianceStatus assess(const std::string& pollutant, double level) const;
+
+private:
+    struct Thresholds {
+        double min;
+        double max;
+    };
+
+    std::unordered_map<std::string, Thresholds> thresholds;
+};
+
+#endif // COMPLIANCERULES_HPP
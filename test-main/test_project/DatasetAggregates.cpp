@@ -0,0 +1,129 @@
+#include "DatasetAggregates.hpp"
+#include "MemoryUsage.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+void RunningStats::add(double value) {
+    count++;
+    sum += value;
+
+    if (count == 1) {
+        mean = value;
+        min = value;
+        max = value;
+        return;
+    }
+
+    double delta = value - mean;
+    mean += delta / count;
+    m2 += delta * (value - mean);
+    min = std::min(min, value);
+    max = std::max(max, value);
+}
+
+void RunningStats::merge(const RunningStats& other) {
+    if (other.count == 0)
+        return;
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+
+    // Chan et al. pairwise combination of Welford states
+    size_t total = count + other.count;
+    double delta = other.mean - mean;
+    mean += delta * other.count / total;
+    m2 += other.m2 + delta * delta * (static_cast<double>(count) * other.count / total);
+    sum += other.sum;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    count = total;
+}
+
+double RunningStats::variance() const {
+    return count < 2 ? 0.0 : m2 / (count - 1);
+}
+
+double RunningStats::stddev() const {
+    return std::sqrt(variance());
+}
+
+namespace {
+
+size_t hashCombine(size_t seed, size_t value) {
+    return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+} // namespace
+
+size_t SeriesKeyHash::operator()(const SeriesKey& key) const {
+    return hashCombine(std::hash<std::string>()(key.location), std::hash<std::string>()(key.pollutant));
+}
+
+size_t AggregateKeyHash::operator()(const AggregateKey& key) const {
+    size_t hash = hashCombine(std::hash<std::string>()(key.location), std::hash<std::string>()(key.pollutant));
+    return hashCombine(hash, std::hash<int>()(key.yearMonth));
+}
+
+void DatasetAggregates::add(const WaterSample& sample) {
+    add(sample.getLocation(), sample.getPollutant(), sample.getYearMonth(), sample.getLevel());
+}
+
+void DatasetAggregates::add(const std::vector<WaterSample>& samples) {
+    for (const auto& sample : samples)
+        add(sample);
+}
+
+void DatasetAggregates::add(const std::string& location, const std::string& pollutant, int yearMonth,
+                            double level) {
+    cells[AggregateKey{location, pollutant, yearMonth}].add(level);
+}
+
+void DatasetAggregates::merge(const DatasetAggregates& other) {
+    for (const auto& cell : other.cells)
+        cells[cell.first].merge(cell.second);
+}
+
+void DatasetAggregates::clear() {
+    cells.clear();
+}
+
+size_t DatasetAggregates::approximateBytes() const {
+    size_t bytes = hashMapBytes(cells);
+    for (const auto& cell : cells)
+        bytes += heapBytes(cell.first.location) + heapBytes(cell.first.pollutant);
+    return bytes;
+}
+
+const DatasetAggregates::CellMap& DatasetAggregates::getCells() const {
+    return cells;
+}
+
+std::vector<SeriesKey> DatasetAggregates::getSeriesKeys() const {
+    std::vector<SeriesKey> keys;
+    keys.reserve(cells.size());
+    for (const auto& cell : cells)
+        keys.push_back(SeriesKey{cell.first.location, cell.first.pollutant});
+
+    std::sort(keys.begin(), keys.end(), [](const SeriesKey& a, const SeriesKey& b) {
+        return a.location != b.location ? a.location < b.location : a.pollutant < b.pollutant;
+    });
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
+
+RunningStats DatasetAggregates::summarize(const std::string& location, const std::string& pollutant, int year) const {
+    RunningStats result;
+    for (const auto& cell : cells) {
+        const AggregateKey& key = cell.first;
+        if (!location.empty() && key.location != location)
+            continue;
+        if (!pollutant.empty() && key.pollutant != pollutant)
+            continue;
+        if (year != 0 && key.yearMonth / 100 != year)
+            continue;
+        result.merge(cell.second);
+    }
+    return result;
+}
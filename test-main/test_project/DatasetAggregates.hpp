@@ -0,0 +1,77 @@
+#ifndef DATASETAGGREGATES_HPP
+#define DATASETAGGREGATES_HPP
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "WaterSample.hpp"
+
+// Count, sum, Welford mean/variance and min/max of a stream of levels.
+// Two RunningStats built over disjoint rows can be merged exactly.
+struct RunningStats {
+    size_t count = 0;
+    double sum = 0.0;
+    double mean = 0.0;
+    double m2 = 0.0; // Sum of squared deviations from the mean
+    double min = 0.0;
+    double max = 0.0;
+
+    void add(double value);
+    void merge(const RunningStats& other);
+    double variance() const; // Sample variance, 0 for fewer than two values
+    double stddev() const;
+};
+
+// Samples of one pollutant at one sampling point
+struct SeriesKey {
+    std::string location;
+    std::string pollutant;
+
+    bool operator==(const SeriesKey& other) const {
+        return location == other.location && pollutant == other.pollutant;
+    }
+};
+
+struct SeriesKeyHash {
+    size_t operator()(const SeriesKey& key) const;
+};
+
+struct AggregateKey {
+    std::string location;
+    std::string pollutant;
+    int yearMonth; // YYYYMM
+
+    bool operator==(const AggregateKey& other) const {
+        return yearMonth == other.yearMonth && location == other.location && pollutant == other.pollutant;
+    }
+};
+
+struct AggregateKeyHash {
+    size_t operator()(const AggregateKey& key) const;
+};
+
+// Level statistics per location x pollutant x month, kept up to date as rows
+// are added so summaries never need to rescan the samples
+class DatasetAggregates {
+public:
+    using CellMap = std::unordered_map<AggregateKey, RunningStats, AggregateKeyHash>;
+
+    void add(const WaterSample& sample);
+    void add(const std::vector<WaterSample>& samples);
+    void add(const std::string& location, const std::string& pollutant, int yearMonth, double level);
+    void merge(const DatasetAggregates& other);
+    void clear();
+    size_t approximateBytes() const; // Heap bytes held, estimated
+
+    const CellMap& getCells() const;
+    std::vector<SeriesKey> getSeriesKeys() const; // Sorted by location, then pollutant
+
+    // Merges every cell matching the arguments; empty strings and 0 mean "all"
+    RunningStats summarize(const std::string& location, const std::string& pollutant, int year = 0) const;
+
+private:
+    CellMap cells;
+};
+
+#endif // DATASETAGGREGATES_HPP
@@ -0,0 +1,129 @@
+#include "Downsample.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Points of every coarser level are picked from groups of this many points
+constexpr size_t GROUP_SIZE = 4;
+// No level coarser than this is built
+constexpr size_t MIN_LEVEL_POINTS = 256;
+
+} // namespace
+
+std::vector<SeriesPoint> lttb(const std::vector<SeriesPoint>& points, size_t threshold) {
+    threshold = std::max<size_t>(threshold, 3);
+    if (points.size() <= threshold)
+        return points;
+
+    std::vector<SeriesPoint> sampled;
+    sampled.reserve(threshold);
+    sampled.push_back(points.front());
+
+    // The points between the first and last are split into threshold - 2
+    // buckets, and from each the one making the largest triangle with the
+    // point kept before it and the mean of the next bucket is kept
+    const double bucketSize = static_cast<double>(points.size() - 2) / (threshold - 2);
+    const double origin = static_cast<double>(points.front().time);
+    size_t previous = 0;
+    for (size_t bucket = 0; bucket < threshold - 2; ++bucket) {
+        size_t start = static_cast<size_t>(bucket * bucketSize) + 1;
+        size_t end = static_cast<size_t>((bucket + 1) * bucketSize) + 1;
+        size_t nextEnd = std::min(static_cast<size_t>((bucket + 2) * bucketSize) + 1, points.size());
+
+        double meanTime = 0.0;
+        double meanValue = 0.0;
+        for (size_t i = end; i < nextEnd; ++i) {
+            meanTime += points[i].time - origin;
+            meanValue += points[i].value;
+        }
+        meanTime /= static_cast<double>(nextEnd - end);
+        meanValue /= static_cast<double>(nextEnd - end);
+
+        const double previousTime = points[previous].time - origin;
+        const double previousValue = points[previous].value;
+        size_t chosen = start;
+        double largestArea = -1.0;
+        for (size_t i = start; i < end; ++i) {
+            double area = std::abs((previousTime - meanTime) * (points[i].value - previousValue) -
+                                   (previousTime - (points[i].time - origin)) * (meanValue - previousValue));
+            if (area > largestArea) {
+                largestArea = area;
+                chosen = i;
+            }
+        }
+        sampled.push_back(points[chosen]);
+        previous = chosen;
+    }
+
+    sampled.push_back(points.back());
+    return sampled;
+}
+
+SeriesPyramid::SeriesPyramid(const TimeSeries& series) {
+    times.reserve(series.size());
+    values.reserve(series.size());
+    for (size_t i = 0; i < series.size(); ++i) {
+        if (std::isnan(series.values[i]))
+            continue;
+        times.push_back(series.times[i]);
+        values.push_back(series.values[i]);
+    }
+
+    size_t previousSize = times.size();
+    while (previousSize > MIN_LEVEL_POINTS) {
+        const std::vector<uint32_t> *below = levels.empty() ? nullptr : &levels.back();
+        auto pointAt = [below](size_t i) { return below ? (*below)[i] : static_cast<uint32_t>(i); };
+
+        std::vector<uint32_t> level;
+        level.reserve(previousSize / GROUP_SIZE * 2 + 2);
+        for (size_t group = 0; group < previousSize; group += GROUP_SIZE) {
+            uint32_t lowest = pointAt(group);
+            uint32_t highest = lowest;
+            for (size_t i = group + 1; i < std::min(group + GROUP_SIZE, previousSize); ++i) {
+                uint32_t point = pointAt(i);
+                if (values[point] < values[lowest])
+                    lowest = point;
+                if (values[point] > values[highest])
+                    highest = point;
+            }
+            level.push_back(std::min(lowest, highest));
+            if (lowest != highest)
+                level.push_back(std::max(lowest, highest));
+        }
+        previousSize = level.size();
+        levels.push_back(std::move(level));
+    }
+}
+
+std::vector<SeriesPoint> SeriesPyramid::query(int64_t from, int64_t to, size_t maxPoints) const {
+    if (times.empty() || from > to)
+        return {};
+
+    // Finest level whose points in [from, to] are few enough; the coarsest
+    // when none is
+    const std::vector<uint32_t> *level = nullptr;
+    size_t first = std::lower_bound(times.begin(), times.end(), from) - times.begin();
+    size_t last = std::upper_bound(times.begin(), times.end(), to) - times.begin();
+    for (size_t i = 0; i < levels.size() && last - first > GROUP_SIZE * maxPoints; ++i) {
+        level = &levels[i];
+        first = std::lower_bound(level->begin(), level->end(), from,
+                                 [this](uint32_t point, int64_t time) { return times[point] < time; }) -
+                level->begin();
+        last = std::upper_bound(level->begin(), level->end(), to,
+                                [this](int64_t time, uint32_t point) { return time < times[point]; }) -
+               level->begin();
+    }
+
+    const size_t levelSize = level ? level->size() : times.size();
+    first = first > 0 ? first - 1 : 0;
+    last = std::min(last + 1, levelSize);
+
+    std::vector<SeriesPoint> points;
+    points.reserve(last - first);
+    for (size_t i = first; i < last; ++i) {
+        uint32_t point = level ? (*level)[i] : static_cast<uint32_t>(i);
+        points.push_back(SeriesPoint{times[point], values[point]});
+    }
+    return lttb(points, maxPoints);
+}
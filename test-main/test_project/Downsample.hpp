@@ -0,0 +1,47 @@
+#ifndef DOWNSAMPLE_HPP
+#define DOWNSAMPLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "TimeSeries.hpp"
+
+struct SeriesPoint {
+    int64_t time;
+    double value;
+};
+
+// Largest-Triangle-Three-Buckets: threshold points of points (in time order)
+// that keep the visual shape of the line. The first and last points are
+// always kept; inputs with at most threshold points are returned as they are.
+std::vector<SeriesPoint> lttb(const std::vector<SeriesPoint>& points, size_t threshold);
+
+// Multi-resolution min/max pyramid over a series, for drawing it at any zoom
+// in time proportional to the screen width rather than the series length.
+// Level 0 is every point; each level above keeps the lowest and highest point
+// of every four of the level below, so spikes such as a single exceedance
+// survive at every level. Gap (NaN) points are left out. Built once, in
+// O(n) time and about 2n indices of memory.
+class SeriesPyramid {
+public:
+    SeriesPyramid() = default;
+    explicit SeriesPyramid(const TimeSeries& series);
+
+    bool empty() const { return times.empty(); }
+    int64_t firstTime() const { return times.front(); } // Not for an empty pyramid
+    int64_t lastTime() const { return times.back(); }
+    size_t levelCount() const { return levels.size() + 1; }
+
+    // At most maxPoints points covering [from, to], plus the nearest point
+    // outside either end so a line can be drawn to the edges. Taken from the
+    // finest level with no more than 4 * maxPoints points in the range, then
+    // reduced with lttb().
+    std::vector<SeriesPoint> query(int64_t from, int64_t to, size_t maxPoints) const;
+
+private:
+    std::vector<int64_t> times;
+    std::vector<double> values;
+    std::vector<std::vector<uint32_t>> levels; // Levels 1.., as indexes into times
+};
+
+#endif // DOWNSAMPLE_HPP
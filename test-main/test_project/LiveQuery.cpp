@@ -0,0 +1,46 @@
+#include "LiveQuery.hpp"
+#include "AnomalyDetector.hpp"
+#include <algorithm>
+
+LiveQuery::LiveQuery(const ComplianceRules& rules, const SampleFilter& filter, FilterResult result,
+                     const std::vector<WaterSample>& samples, const std::vector<double>& anomalyScores)
+    : rules(rules), activeFilter(filter), selection(std::move(result)), rowsSeen(samples.size()) {
+    tallyAnomalies(samples, anomalyScores, 0);
+}
+
+size_t LiveQuery::update(const std::vector<WaterSample>& samples, const std::vector<double>& anomalyScores) {
+    size_t firstPosition = selection.rows.size();
+    if (samples.size() > rowsSeen) {
+        extendStats(selection, samples, rowsSeen, rules, activeFilter);
+        rowsSeen = samples.size();
+        tallyAnomalies(samples, anomalyScores, firstPosition);
+    }
+    return firstPosition;
+}
+
+std::vector<std::pair<SeriesKey, int>> LiveQuery::mostAnomalous(size_t count) const {
+    std::vector<std::pair<SeriesKey, int>> ranked(flaggedBySeries.begin(), flaggedBySeries.end());
+    auto moreFlagged = [](const std::pair<SeriesKey, int>& a, const std::pair<SeriesKey, int>& b) {
+        if (a.second != b.second)
+            return a.second > b.second;
+        return a.first.location != b.first.location ? a.first.location < b.first.location
+                                                    : a.first.pollutant < b.first.pollutant;
+    };
+    count = std::min(count, ranked.size());
+    std::partial_sort(ranked.begin(), ranked.begin() + count, ranked.end(), moreFlagged);
+    ranked.resize(count);
+    return ranked;
+}
+
+void LiveQuery::tallyAnomalies(const std::vector<WaterSample>& samples, const std::vector<double>& anomalyScores,
+                               size_t firstPosition) {
+    if (anomalyScores.empty())
+        return;
+    for (size_t position = firstPosition; position < selection.rows.size(); ++position) {
+        size_t row = selection.rows[position];
+        if (!AnomalyDetector::isAnomaly(anomalyScores[row]))
+            continue;
+        flagged++;
+        flaggedBySeries[SeriesKey{samples[row].getLocation(), samples[row].getPollutant()}]++;
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef LIVEQUERY_HPP
+#define LIVEQUERY_HPP
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "WaterSample.hpp"
+#include "ComplianceRules.hpp"
+#include "StatsEngine.hpp"
+#include "DatasetAggregates.hpp"
+
+// The dashboard's active filter as a standing query over a dataset that only
+// grows. It remembers how many rows it has seen, and update() filters,
+// classifies and counts just the rows appended since, so keeping the
+// selection, its statistics and its anomaly tallies current costs time in
+// the number of new rows (plus re-ranking the groups), not the dataset size.
+class LiveQuery {
+public:
+    LiveQuery() = default;
+    // Takes over result, the filter's result over samples (from computeStats()
+    // or a WaterDataset load). anomalyScores is parallel to samples, or empty.
+    LiveQuery(const ComplianceRules& rules, const SampleFilter& filter, FilterResult result,
+              const std::vector<WaterSample>& samples, const std::vector<double>& anomalyScores);
+
+    // Catches up with the rows appended to samples since the last call.
+    // Returns the position in result().rows of the first new selected row.
+    size_t update(const std::vector<WaterSample>& samples, const std::vector<double>& anomalyScores);
+
+    const FilterResult& result() const { return selection; }
+    const SampleFilter& filter() const { return activeFilter; }
+
+    int anomalyCount() const { return flagged; } // Selected rows flagged by AnomalyDetector
+    // The count series with the most flagged selected rows, most first
+    std::vector<std::pair<SeriesKey, int>> mostAnomalous(size_t count) const;
+
+private:
+    void tallyAnomalies(const std::vector<WaterSample>& samples, const std::vector<double>& anomalyScores,
+                        size_t firstPosition);
+
+    ComplianceRules rules;
+    SampleFilter activeFilter;
+    FilterResult selection;
+    size_t rowsSeen = 0;
+    int flagged = 0;
+    std::unordered_map<SeriesKey, int, SeriesKeyHash> flaggedBySeries;
+};
+
+#endif // LIVEQUERY_HPP
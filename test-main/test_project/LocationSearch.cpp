@@ -0,0 +1,114 @@
+#include "LocationSearch.hpp"
+#include <algorithm>
+#include <cctype>
+#include <unordered_set>
+
+namespace {
+
+std::string foldCase(const std::string& text) {
+    std::string result(text);
+    for (char& c : result)
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return result;
+}
+
+uint32_t trigramAt(const std::string& text, size_t position) {
+    return static_cast<uint32_t>(static_cast<unsigned char>(text[position])) << 16 |
+           static_cast<uint32_t>(static_cast<unsigned char>(text[position + 1])) << 8 |
+           static_cast<uint32_t>(static_cast<unsigned char>(text[position + 2]));
+}
+
+// Distinct trigrams of text, sorted
+std::vector<uint32_t> trigrams(const std::string& text) {
+    std::vector<uint32_t> result;
+    for (size_t position = 0; position + 3 <= text.size(); ++position)
+        result.push_back(trigramAt(text, position));
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+} // namespace
+
+LocationSearch::LocationSearch(std::vector<std::string> names) : sortedNames(std::move(names)) {
+    std::sort(sortedNames.begin(), sortedNames.end());
+    sortedNames.erase(std::unique(sortedNames.begin(), sortedNames.end()), sortedNames.end());
+
+    folded.reserve(sortedNames.size());
+    for (const std::string& name : sortedNames)
+        folded.push_back(foldCase(name));
+
+    foldedOrder.resize(sortedNames.size());
+    for (uint32_t position = 0; position < foldedOrder.size(); ++position)
+        foldedOrder[position] = position;
+    std::stable_sort(foldedOrder.begin(), foldedOrder.end(),
+                     [this](uint32_t a, uint32_t b) { return folded[a] < folded[b]; });
+
+    for (uint32_t position = 0; position < folded.size(); ++position)
+        for (uint32_t trigram : trigrams(folded[position]))
+            postings[trigram].push_back(position);
+    shared.resize(sortedNames.size(), 0);
+}
+
+std::vector<size_t> LocationSearch::search(const std::string& query, size_t limit) const {
+    std::vector<size_t> matches;
+    std::string key = foldCase(query);
+    // Sized by the matches rather than the names, as is everything below
+    std::unordered_set<size_t> taken;
+    auto take = [&](size_t position) {
+        if (matches.size() < limit && taken.insert(position).second)
+            matches.push_back(position);
+    };
+
+    // Prefix matches are a contiguous run of the sorted folded names
+    auto first = std::lower_bound(foldedOrder.begin(), foldedOrder.end(), key,
+                                  [this](uint32_t position, const std::string& value) {
+                                      return folded[position] < value;
+                                  });
+    for (auto it = first; it != foldedOrder.end() && matches.size() < limit; ++it) {
+        if (folded[*it].compare(0, key.size(), key) != 0)
+            break;
+        take(*it);
+    }
+    if (matches.size() >= limit)
+        return matches;
+
+    std::vector<uint32_t> queryTrigrams = trigrams(key);
+    if (queryTrigrams.empty()) {
+        // Too short for trigrams; few enough names to scan for the substring
+        for (size_t position = 0; position < folded.size(); ++position)
+            if (folded[position].find(key) != std::string::npos)
+                take(position);
+        return matches;
+    }
+
+    // How many of the query's trigrams each name sharing one has
+    std::vector<uint32_t> candidates;
+    for (uint32_t trigram : queryTrigrams) {
+        auto it = postings.find(trigram);
+        if (it == postings.end())
+            continue;
+        for (uint32_t position : it->second)
+            if (shared[position]++ == 0)
+                candidates.push_back(position);
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    // A name containing the query has all its trigrams
+    for (uint32_t position : candidates)
+        if (shared[position] == queryTrigrams.size() && folded[position].find(key) != std::string::npos)
+            take(position);
+
+    std::vector<uint32_t> fuzzy;
+    for (uint32_t position : candidates)
+        if (!taken.count(position) && shared[position] >= FUZZY_MIN_SHARED * queryTrigrams.size())
+            fuzzy.push_back(position);
+    std::stable_sort(fuzzy.begin(), fuzzy.end(),
+                     [this](uint32_t a, uint32_t b) { return shared[a] > shared[b]; });
+    for (uint32_t position : fuzzy)
+        take(position);
+
+    for (uint32_t position : candidates)
+        shared[position] = 0;
+    return matches;
+}
@@ -0,0 +1,45 @@
+#ifndef LOCATIONSEARCH_HPP
+#define LOCATIONSEARCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Search over sampling-point names as the user types. Matching ignores ASCII
+// case. Names starting with the query come first, in name order, then names
+// containing it, then names sharing most of its trigrams (three-character
+// substrings), which catches typos, best first. Prefixes are found by binary
+// search over the sorted names and the rest from a trigram index, so a query
+// costs time in the number of names sharing a trigram with it, not the number
+// of names. Queries under three characters have no trigrams and scan the
+// names for the rest. Not thread-safe: search() uses scratch space kept
+// between calls.
+class LocationSearch {
+public:
+    // Least share of the query's trigrams a fuzzy match has
+    static constexpr double FUZZY_MIN_SHARED = 0.5;
+
+    LocationSearch() = default;
+    // Duplicate names are kept once
+    explicit LocationSearch(std::vector<std::string> names);
+
+    // Positions in names() of at most limit matches, best first; every name
+    // for an empty query
+    std::vector<size_t> search(const std::string& query, size_t limit) const;
+
+    const std::vector<std::string>& names() const { return sortedNames; }
+
+private:
+    std::vector<std::string> sortedNames;
+    std::vector<std::string> folded; // Lowercase sortedNames
+    std::vector<uint32_t> foldedOrder; // Positions sorted by folded name
+    // Each trigram's names, in position order
+    std::unordered_map<uint32_t, std::vector<uint32_t>> postings;
+    // Query trigrams each name has, by position; search() zeroes the entries
+    // it counted before returning, so it never has to clear all of them
+    mutable std::vector<uint16_t> shared;
+};
+
+#endif // LOCATIONSEARCH_HPP
@@ -0,0 +1,28 @@
+#ifndef MEMORYUSAGE_HPP
+#define MEMORYUSAGE_HPP
+
+#include <cstddef>
+#include <string>
+
+// Rough heap footprints of standard containers, for memory budgets. They
+// follow the usual standard library layouts and ignore allocator overhead.
+
+// Bytes text holds on the heap; short strings fit in the object itself
+inline size_t heapBytes(const std::string& text) {
+    return text.capacity() > std::string().capacity() ? text.capacity() + 1 : 0;
+}
+
+// Buckets and nodes of a hash map, not counting what its keys and values hold
+template <typename Map>
+size_t hashMapBytes(const Map& map) {
+    return map.bucket_count() * sizeof(void*) +
+           map.size() * (sizeof(typename Map::value_type) + 2 * sizeof(void*));
+}
+
+// Nodes of a std::map or std::list, not counting what their values hold
+template <typename Container>
+size_t nodeBytes(const Container& container) {
+    return container.size() * (sizeof(typename Container::value_type) + 4 * sizeof(void*));
+}
+
+#endif // MEMORYUSAGE_HPP
@@ -0,0 +1,19 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+
+// Below this many rows per thread the thread start-up costs more than it saves
+constexpr size_t MIN_ROWS_PER_THREAD = 20000;
+
+// Threads for a data-parallel pass over rows: one per core, but only as many
+// as get MIN_ROWS_PER_THREAD rows each, and at least one
+inline unsigned threadsFor(size_t rows) {
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    size_t useful = std::max<size_t>(1, rows / MIN_ROWS_PER_THREAD);
+    return static_cast<unsigned>(std::min<size_t>(cores, useful));
+}
+
+#endif // PARALLEL_HPP
@@ -0,0 +1,90 @@
+#include "QueryCache.hpp"
+#include <filesystem>
+
+namespace {
+
+size_t hashCombine(size_t seed, size_t value) {
+    return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+} // namespace
+
+bool QueryKey::operator==(const QueryKey& other) const {
+    return year == other.year && filter.year == other.filter.year && filter.location == other.filter.location &&
+           filter.pollutant == other.filter.pollutant && filter.status == other.filter.status &&
+           filter.area == other.filter.area && version == other.version;
+}
+
+size_t QueryKeyHash::operator()(const QueryKey& key) const {
+    size_t hash = hashCombine(std::hash<std::string>()(key.year), std::hash<int>()(key.filter.year));
+    hash = hashCombine(hash, std::hash<std::string>()(key.filter.location));
+    hash = hashCombine(hash, std::hash<std::string>()(key.filter.pollutant));
+    hash = hashCombine(hash, key.filter.status ? static_cast<size_t>(*key.filter.status) + 1 : 0);
+    if (key.filter.area) {
+        const GridBox& bounds = key.filter.area->bounds;
+        for (double value : {bounds.minEasting, bounds.minNorthing, bounds.maxEasting, bounds.maxNorthing,
+                             key.filter.area->radius})
+            hash = hashCombine(hash, std::hash<double>()(value));
+    }
+    return hashCombine(hash, std::hash<std::string>()(key.version));
+}
+
+std::string sourceVersion(const std::vector<std::string>& paths) {
+    std::string version;
+    for (const std::string& path : paths) {
+        // A missing file has a version too: the query reads nothing from it
+        std::error_code error;
+        uintmax_t size = std::filesystem::file_size(path, error);
+        if (error) {
+            version += "-;";
+            continue;
+        }
+        auto modified = std::filesystem::last_write_time(path, error);
+        version += std::to_string(size) + "@" +
+                   std::to_string(error ? 0 : modified.time_since_epoch().count()) + ";";
+    }
+    return version;
+}
+
+size_t approximateBytes(const QueryOutcome& outcome) {
+    const FilterResult& result = outcome.result;
+    // The per-pollutant counts of result.stats are few and not counted
+    return sizeof(QueryOutcome) + sizeof(WaterDataset) + outcome.dataset->approximateBytes() +
+           result.rows.capacity() * sizeof(size_t) + result.statuses.capacity() * sizeof(ComplianceStatus) +
+           result.accumulator.approximateBytes();
+}
+
+QueryCache::QueryCache(size_t byteBudget) : byteBudget(byteBudget) {}
+
+std::shared_ptr<QueryOutcome> QueryCache::find(const QueryKey& key) {
+    auto it = index.find(key);
+    if (it == index.end())
+        return nullptr;
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->outcome;
+}
+
+void QueryCache::insert(const QueryKey& key, std::shared_ptr<QueryOutcome> outcome) {
+    erase(key);
+    size_t bytes = approximateBytes(*outcome);
+    if (bytes > byteBudget)
+        return;
+
+    while (!entries.empty() && usedBytes + bytes > byteBudget) {
+        usedBytes -= entries.back().bytes;
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+    entries.push_front(Entry{key, std::move(outcome), bytes});
+    index.emplace(key, entries.begin());
+    usedBytes += bytes;
+}
+
+void QueryCache::erase(const QueryKey& key) {
+    auto it = index.find(key);
+    if (it == index.end())
+        return;
+    usedBytes -= it->second->bytes;
+    entries.erase(it->second);
+    index.erase(it);
+}
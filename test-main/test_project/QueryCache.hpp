@@ -0,0 +1,79 @@
+#ifndef QUERYCACHE_HPP
+#define QUERYCACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "StatsEngine.hpp"
+#include "dataset.hpp"
+
+// What a dashboard filter query loaded: the rows it needs and the result
+// over them
+struct QueryOutcome {
+    SampleFilter filter;
+    std::shared_ptr<WaterDataset> dataset = std::make_shared<WaterDataset>();
+    FilterResult result;
+    std::string followPath; // Empty when the result is not followed
+    uint64_t followOffset = 0;
+};
+
+// A query as the cache sees it: the year shown ("All Years" or a year), the
+// filter in its normal form (empty strings and no status for "All") and the
+// version of the files the query reads, from sourceVersion()
+struct QueryKey {
+    std::string year;
+    SampleFilter filter;
+    std::string version;
+
+    bool operator==(const QueryKey& other) const;
+};
+
+struct QueryKeyHash {
+    size_t operator()(const QueryKey& key) const;
+};
+
+// Size and modification time of each file, so any change to them, including
+// rows appended, gives a new version
+std::string sourceVersion(const std::vector<std::string>& paths);
+
+// Bytes held by an outcome's dataset, with everything built over its rows,
+// and its result, estimated from their sizes
+size_t approximateBytes(const QueryOutcome& outcome);
+
+// Recently run queries, most recent first, evicted least recently used first
+// once their approximate size passes byteBudget. Outcomes are shared with
+// whoever shows them, so an outcome that is changed (rows appended) must be
+// erase()d.
+class QueryCache {
+public:
+    explicit QueryCache(size_t byteBudget = 256u << 20);
+
+    std::shared_ptr<QueryOutcome> find(const QueryKey& key); // nullptr on a miss
+    // An outcome larger than the whole budget is not kept
+    void insert(const QueryKey& key, std::shared_ptr<QueryOutcome> outcome);
+    void erase(const QueryKey& key);
+
+    size_t size() const { return entries.size(); }
+    size_t bytes() const { return usedBytes; }
+
+private:
+    struct Entry {
+        QueryKey key;
+        std::shared_ptr<QueryOutcome> outcome;
+        size_t bytes;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    size_t byteBudget;
+    size_t usedBytes = 0;
+    EntryList entries;
+    std::unordered_map<QueryKey, EntryList::iterator, QueryKeyHash> index;
+};
+
+#endif // QUERYCACHE_HPP
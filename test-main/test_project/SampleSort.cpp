@@ -0,0 +1,309 @@
+#include "SampleSort.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+
+namespace {
+
+// Location and pollutant ranks in the high word, the time in the low word;
+// the sample index breaks ties so the order is stable
+struct SortKey {
+    uint64_t high;
+    uint64_t low;
+    uint32_t index;
+};
+
+bool keyLess(const SortKey& a, const SortKey& b) {
+    return std::tie(a.high, a.low, a.index) < std::tie(b.high, b.low, b.index);
+}
+
+bool sameKey(const SortKey& a, const SortKey& b) {
+    return a.high == b.high && a.low == b.low;
+}
+
+// Rank of field(i) for i < count in sorted order of the distinct strings
+template <typename Field>
+std::vector<uint32_t> rankStrings(size_t count, Field field) {
+    std::unordered_map<std::string, uint32_t> ids;
+    std::vector<const std::string*> distinct;
+    std::vector<uint32_t> sampleIds(count);
+    for (size_t i = 0; i < count; ++i) {
+        const std::string& value = field(i);
+        auto inserted = ids.emplace(value, static_cast<uint32_t>(distinct.size()));
+        if (inserted.second)
+            distinct.push_back(&inserted.first->first);
+        sampleIds[i] = inserted.first->second;
+    }
+
+    std::vector<uint32_t> order(distinct.size());
+    for (uint32_t id = 0; id < order.size(); ++id)
+        order[id] = id;
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return *distinct[a] < *distinct[b]; });
+
+    std::vector<uint32_t> rankOfId(distinct.size());
+    for (uint32_t rank = 0; rank < order.size(); ++rank)
+        rankOfId[order[rank]] = rank;
+    for (uint32_t& id : sampleIds)
+        id = rankOfId[id];
+    return sampleIds;
+}
+
+// "YYYY-MM-DDTHH:MM:SS" read as the number YYYYMMDDHHMMSS, which orders the
+// same as the time; false for any other text
+bool packTime(const std::string& date, uint64_t& packed) {
+    static const char PATTERN[] = "0000-00-00T00:00:00";
+    if (date.size() != sizeof(PATTERN) - 1)
+        return false;
+
+    packed = 0;
+    for (size_t i = 0; i < date.size(); ++i) {
+        if (PATTERN[i] != '0') {
+            if (date[i] != PATTERN[i])
+                return false;
+            continue;
+        }
+        if (date[i] < '0' || date[i] > '9')
+            return false;
+        packed = packed * 10 + static_cast<uint64_t>(date[i] - '0');
+    }
+    return true;
+}
+
+// Time keys of date(i) for i < count: other date text first, in string order,
+// then well-formed times. Bit 63 separates the two groups.
+template <typename Date>
+std::vector<uint64_t> timeKeys(size_t count, Date date) {
+    std::vector<uint64_t> keys(count);
+    std::vector<size_t> odd;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t packed;
+        if (packTime(date(i), packed))
+            keys[i] = packed | (1ULL << 63);
+        else
+            odd.push_back(i);
+    }
+
+    if (!odd.empty()) {
+        std::vector<uint32_t> ranks = rankStrings(odd.size(), [&](size_t j) -> const std::string& {
+            return date(odd[j]);
+        });
+        for (size_t j = 0; j < odd.size(); ++j)
+            keys[odd[j]] = ranks[j];
+    }
+    return keys;
+}
+
+// Unsigned integer with the same order as the double; NaN sorts last
+uint64_t levelKey(double level) {
+    if (std::isnan(level))
+        return ~0ULL;
+    if (level == 0.0)
+        level = 0.0; // -0.0 and 0.0 compare equal
+    uint64_t bits;
+    std::memcpy(&bits, &level, sizeof(bits));
+    return bits & (1ULL << 63) ? ~bits : bits | (1ULL << 63);
+}
+
+// Stable LSD radix sort of keys[begin, end) over the bytes of (high, low).
+// Bytes that are the same in every key are skipped, so narrow ranks and a
+// single year of dates cost only the passes they need.
+void radixSortRange(std::vector<SortKey>& keys, size_t begin, size_t end) {
+    size_t count = end - begin;
+    if (count < 2)
+        return;
+
+    std::vector<SortKey> scratch(count);
+    SortKey* from = keys.data() + begin;
+    SortKey* to = scratch.data();
+
+    for (int pass = 0; pass < 16; ++pass) {
+        bool lowWord = pass < 8;
+        unsigned shift = (pass % 8) * 8;
+        auto digit = [&](const SortKey& key) {
+            return static_cast<size_t>(((lowWord ? key.low : key.high) >> shift) & 0xff);
+        };
+
+        size_t histogram[256] = {};
+        for (size_t i = 0; i < count; ++i)
+            histogram[digit(from[i])]++;
+        if (histogram[digit(from[0])] == count)
+            continue;
+
+        size_t offset = 0;
+        for (size_t& bucket : histogram) {
+            size_t size = bucket;
+            bucket = offset;
+            offset += size;
+        }
+        for (size_t i = 0; i < count; ++i)
+            to[histogram[digit(from[i])]++] = from[i];
+        std::swap(from, to);
+    }
+
+    if (from != keys.data() + begin)
+        std::copy(from, from + count, keys.data() + begin);
+}
+
+// Sorts keys by (high, low, index): contiguous ranges are radix sorted in
+// parallel, then neighbouring ranges are merged pairwise, also in parallel,
+// until one run is left
+void sortKeys(std::vector<SortKey>& keys, unsigned threadCount) {
+    if (keys.empty())
+        return;
+
+    if (threadCount == 0)
+        threadCount = threadsFor(keys.size());
+
+    size_t rangeSize = (keys.size() + threadCount - 1) / threadCount;
+    std::vector<size_t> bounds;
+    for (size_t begin = 0; begin < keys.size(); begin += rangeSize)
+        bounds.push_back(begin);
+    bounds.push_back(keys.size());
+
+    auto runAll = [](std::vector<std::function<void()>>& tasks) {
+        if (tasks.size() == 1) {
+            tasks[0]();
+            return;
+        }
+        std::vector<std::thread> pool;
+        for (auto& task : tasks)
+            pool.emplace_back(task);
+        for (auto& worker : pool)
+            worker.join();
+    };
+
+    std::vector<std::function<void()>> tasks;
+    for (size_t r = 0; r + 1 < bounds.size(); ++r)
+        tasks.push_back([&keys, &bounds, r] { radixSortRange(keys, bounds[r], bounds[r + 1]); });
+    runAll(tasks);
+
+    std::vector<SortKey> merged(keys.size());
+    while (bounds.size() > 2) {
+        std::vector<size_t> next;
+        tasks.clear();
+        for (size_t r = 0; r + 1 < bounds.size(); r += 2) {
+            size_t begin = bounds[r];
+            size_t middle = bounds[r + 1];
+            size_t end = r + 2 < bounds.size() ? bounds[r + 2] : middle;
+            next.push_back(begin);
+            tasks.push_back([&keys, &merged, begin, middle, end] {
+                std::merge(keys.begin() + begin, keys.begin() + middle, keys.begin() + middle,
+                           keys.begin() + end, merged.begin() + begin, keyLess);
+            });
+        }
+        next.push_back(keys.size());
+        runAll(tasks);
+        keys.swap(merged);
+        bounds.swap(next);
+    }
+}
+
+bool sameSample(const WaterSample& a, const WaterSample& b) {
+    double levelA = a.getLevel();
+    double levelB = b.getLevel();
+    // Compared bitwise so NaN levels still count as duplicates
+    return std::memcmp(&levelA, &levelB, sizeof(double)) == 0 && a.getUnit() == b.getUnit() &&
+           a.getComplianceStatus() == b.getComplianceStatus() && a.getLocation() == b.getLocation() &&
+           a.getPollutant() == b.getPollutant() && a.getSampleDate() == b.getSampleDate();
+}
+
+} // namespace
+
+size_t sortAndDeduplicate(std::vector<WaterSample>& samples, unsigned threadCount) {
+    if (samples.empty())
+        return 0;
+
+    std::vector<uint32_t> locations =
+        rankStrings(samples.size(), [&](size_t i) -> const std::string& { return samples[i].getLocation(); });
+    std::vector<uint32_t> pollutants =
+        rankStrings(samples.size(), [&](size_t i) -> const std::string& { return samples[i].getPollutant(); });
+    std::vector<uint64_t> times =
+        timeKeys(samples.size(), [&](size_t i) -> const std::string& { return samples[i].getSampleDate(); });
+
+    std::vector<SortKey> keys(samples.size());
+    for (size_t i = 0; i < samples.size(); ++i)
+        keys[i] = SortKey{static_cast<uint64_t>(locations[i]) << 32 | pollutants[i], times[i],
+                          static_cast<uint32_t>(i)};
+
+    sortKeys(keys, threadCount);
+
+    // Duplicates share a key, so only rows within a run of equal keys are compared
+    std::vector<bool> keep(keys.size(), true);
+    size_t removed = 0;
+    for (size_t runBegin = 0; runBegin < keys.size();) {
+        size_t runEnd = runBegin + 1;
+        while (runEnd < keys.size() && sameKey(keys[runBegin], keys[runEnd]))
+            runEnd++;
+
+        for (size_t i = runBegin + 1; i < runEnd; ++i) {
+            for (size_t j = runBegin; j < i; ++j) {
+                if (keep[j] && sameSample(samples[keys[i].index], samples[keys[j].index])) {
+                    keep[i] = false;
+                    removed++;
+                    break;
+                }
+            }
+        }
+        runBegin = runEnd;
+    }
+
+    std::vector<WaterSample> sorted;
+    sorted.reserve(keys.size() - removed);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (keep[i])
+            sorted.push_back(std::move(samples[keys[i].index]));
+    }
+    samples.swap(sorted);
+    return removed;
+}
+
+std::vector<size_t> sortedRowOrder(const std::vector<WaterSample>& samples, const std::vector<size_t>& rows,
+                                   const std::vector<ComplianceStatus>& statuses, SampleColumn column,
+                                   bool descending, unsigned threadCount) {
+    auto sample = [&](size_t i) -> const WaterSample& { return samples[rows[i]]; };
+    std::vector<uint64_t> values(rows.size());
+
+    switch (column) {
+    case SampleColumn::Location:
+    case SampleColumn::Pollutant:
+    case SampleColumn::Unit: {
+        std::vector<uint32_t> ranks = rankStrings(rows.size(), [&](size_t i) -> const std::string& {
+            if (column == SampleColumn::Location)
+                return sample(i).getLocation();
+            return column == SampleColumn::Pollutant ? sample(i).getPollutant() : sample(i).getUnit();
+        });
+        values.assign(ranks.begin(), ranks.end());
+        break;
+    }
+    case SampleColumn::Level:
+        for (size_t i = 0; i < rows.size(); ++i)
+            values[i] = levelKey(sample(i).getLevel());
+        break;
+    case SampleColumn::Date:
+        values = timeKeys(rows.size(), [&](size_t i) -> const std::string& { return sample(i).getSampleDate(); });
+        break;
+    case SampleColumn::Compliance:
+        // Ordered by name like the text shown: "-", bad, good, medium
+        for (size_t i = 0; i < rows.size(); ++i)
+            values[i] = static_cast<uint64_t>(std::string(complianceStatusName(statuses[i]))[0]);
+        break;
+    }
+
+    // Rows with equal values keep their order in either direction
+    std::vector<SortKey> keys(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i)
+        keys[i] = SortKey{0, descending ? ~values[i] : values[i], static_cast<uint32_t>(i)};
+    sortKeys(keys, threadCount);
+
+    std::vector<size_t> order(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+        order[i] = keys[i].index;
+    return order;
+}
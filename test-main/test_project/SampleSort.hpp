@@ -0,0 +1,36 @@
+#ifndef SAMPLESORT_HPP
+#define SAMPLESORT_HPP
+
+#include <cstddef>
+#include <vector>
+#include "WaterSample.hpp"
+#include "ComplianceRules.hpp"
+
+// Orders samples by location, then pollutant, then sample time, and removes
+// exact duplicates (every field equal), keeping the first occurrence. Samples
+// with equal keys keep their input order, so the result is deterministic.
+// The keys are packed into integers and radix sorted in contiguous ranges on
+// separate threads, then merged; threadCount 0 picks one per core for large
+// inputs. Returns the number of duplicates removed.
+size_t sortAndDeduplicate(std::vector<WaterSample>& samples, unsigned threadCount = 0);
+
+// Columns of the dashboard table
+enum class SampleColumn {
+    Location,
+    Pollutant,
+    Level,
+    Unit,
+    Date,
+    Compliance
+};
+
+// Order in which to show the table rows samples[rows[i]] (with statuses[i])
+// when sorted by column: a permutation of 0..rows.size()-1. Strings compare
+// by their ranks, dates by their packed time and levels by their bits mapped
+// to integers, and the same parallel radix sort as above is used. Equal
+// values keep their order.
+std::vector<size_t> sortedRowOrder(const std::vector<WaterSample>& samples, const std::vector<size_t>& rows,
+                                   const std::vector<ComplianceStatus>& statuses, SampleColumn column,
+                                   bool descending, unsigned threadCount = 0);
+
+#endif // SAMPLESORT_HPP
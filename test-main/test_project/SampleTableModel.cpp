@@ -0,0 +1,162 @@
+#include "SampleTableModel.hpp"
+#include "SampleSort.hpp"
+#include "AnomalyDetector.hpp"
+#include <QColor>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+const char* const COLUMN_NAMES[] = {"Location", "Pollutant", "Level", "Unit", "Date", "Compliance", "Anomaly"};
+constexpr int COLUMN_COUNT = 7;
+constexpr int ANOMALY_COLUMN = 6; // Not a SampleColumn: the score is not part of the sample
+
+QColor statusColor(ComplianceStatus status) {
+    switch (status) {
+    case ComplianceStatus::Good:
+        return QColor(0, 255, 0); // Green
+    case ComplianceStatus::Medium:
+        return QColor(255, 165, 0); // Orange
+    case ComplianceStatus::Bad:
+        return QColor(255, 0, 0); // Red
+    default:
+        return QColor(255, 255, 255); // White for missing data
+    }
+}
+
+} // namespace
+
+SampleTableModel::SampleTableModel(QObject *parent) : QAbstractTableModel(parent) {}
+
+void SampleTableModel::setRows(const std::vector<WaterSample>& newSamples, const FilterResult& result,
+                               const std::vector<double>& anomalyScores) {
+    beginResetModel();
+    samples = result.rows.empty() ? nullptr : &newSamples;
+    rows = result.rows;
+    statuses = result.statuses;
+    scores.clear();
+    if (!anomalyScores.empty()) {
+        scores.reserve(rows.size());
+        for (size_t row : rows)
+            scores.push_back(anomalyScores[row]);
+    }
+    order.resize(rows.size());
+    std::iota(order.begin(), order.end(), 0);
+    endResetModel();
+}
+
+void SampleTableModel::appendRows(const std::vector<WaterSample>& newSamples, const FilterResult& result,
+                                  size_t firstPosition, const std::vector<double>& anomalyScores) {
+    if (firstPosition >= result.rows.size())
+        return;
+
+    int first = static_cast<int>(order.size());
+    beginInsertRows(QModelIndex(), first, first + static_cast<int>(result.rows.size() - firstPosition) - 1);
+    samples = &newSamples;
+    for (size_t position = firstPosition; position < result.rows.size(); ++position) {
+        order.push_back(rows.size());
+        rows.push_back(result.rows[position]);
+        statuses.push_back(result.statuses[position]);
+        if (!anomalyScores.empty())
+            scores.push_back(anomalyScores[result.rows[position]]);
+    }
+    endInsertRows();
+}
+
+void SampleTableModel::clear() {
+    beginResetModel();
+    samples = nullptr;
+    rows.clear();
+    statuses.clear();
+    scores.clear();
+    order.clear();
+    endResetModel();
+}
+
+int SampleTableModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(order.size());
+}
+
+int SampleTableModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : COLUMN_COUNT;
+}
+
+QVariant SampleTableModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || !samples || static_cast<size_t>(index.row()) >= order.size())
+        return QVariant();
+
+    size_t position = order[index.row()];
+    const WaterSample& sample = (*samples)[rows[position]];
+    ComplianceStatus status = statuses[position];
+    bool anomaly = !scores.empty() && AnomalyDetector::isAnomaly(scores[position]);
+
+    if (role == Qt::BackgroundRole)
+        return index.column() == ANOMALY_COLUMN && anomaly ? QColor(200, 120, 255) : statusColor(status);
+    if (role != Qt::DisplayRole)
+        return QVariant();
+    if (index.column() == ANOMALY_COLUMN)
+        return anomaly ? QString("%1 sd above").arg(scores[position], 0, 'f', 1) : QString();
+
+    switch (static_cast<SampleColumn>(index.column())) {
+    case SampleColumn::Location:
+        return QString::fromStdString(sample.getLocation());
+    case SampleColumn::Pollutant:
+        return QString::fromStdString(sample.getPollutant());
+    case SampleColumn::Level:
+        return QString::number(sample.getLevel());
+    case SampleColumn::Unit:
+        return QString::fromStdString(sample.getUnit());
+    case SampleColumn::Date:
+        return QString::fromStdString(sample.getSampleDate());
+    case SampleColumn::Compliance:
+        return QString(complianceStatusName(status));
+    }
+    return QVariant();
+}
+
+QVariant SampleTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (role != Qt::DisplayRole)
+        return QVariant();
+    if (orientation == Qt::Vertical)
+        return section + 1;
+    return section >= 0 && section < COLUMN_COUNT ? QString(COLUMN_NAMES[section]) : QVariant();
+}
+
+void SampleTableModel::sort(int column, Qt::SortOrder sortOrder) {
+    if (!samples || column < 0 || column >= COLUMN_COUNT)
+        return;
+
+    std::vector<size_t> sorted;
+    if (column == ANOMALY_COLUMN) {
+        // By score, unscored rows last either way
+        sorted.resize(rows.size());
+        std::iota(sorted.begin(), sorted.end(), 0);
+        if (!scores.empty()) {
+            bool descending = sortOrder == Qt::DescendingOrder;
+            std::stable_sort(sorted.begin(), sorted.end(), [&](size_t a, size_t b) {
+                if (std::isnan(scores[a]) || std::isnan(scores[b]))
+                    return !std::isnan(scores[a]) && std::isnan(scores[b]);
+                return descending ? scores[a] > scores[b] : scores[a] < scores[b];
+            });
+        }
+    } else {
+        sorted = sortedRowOrder(*samples, rows, statuses, static_cast<SampleColumn>(column),
+                                sortOrder == Qt::DescendingOrder);
+    }
+
+    // Persistent indexes (selection, current cell) follow their rows
+    emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+    std::vector<int> newRow(order.size());
+    for (size_t row = 0; row < sorted.size(); ++row)
+        newRow[sorted[row]] = static_cast<int>(row);
+
+    QModelIndexList from = persistentIndexList();
+    QModelIndexList to;
+    for (const QModelIndex& index : from)
+        to.append(this->index(newRow[order[index.row()]], index.column()));
+    changePersistentIndexList(from, to);
+
+    order.swap(sorted);
+    emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
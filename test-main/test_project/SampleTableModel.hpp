@@ -0,0 +1,45 @@
+#ifndef SAMPLETABLEMODEL_HPP
+#define SAMPLETABLEMODEL_HPP
+
+#include <QAbstractTableModel>
+#include <vector>
+#include "WaterSample.hpp"
+#include "StatsEngine.hpp"
+
+// Rows of a FilterResult shown in the dashboard table, plus an anomaly column
+// after the SampleColumn ones. Cells are produced on demand from the samples,
+// and sorting by a column only reorders a permutation of the result rows, so
+// no per-cell objects are ever created.
+class SampleTableModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    explicit SampleTableModel(QObject *parent = nullptr);
+
+    // Shows result.rows of samples, with their AnomalyDetector scores when
+    // anomalyScores (parallel to samples) is not empty. samples must outlive
+    // the model's use of them, until the next setRows() or clear().
+    void setRows(const std::vector<WaterSample>& samples, const FilterResult& result,
+                 const std::vector<double>& anomalyScores);
+    // Adds result.rows[firstPosition..], which were appended to the same
+    // samples and result since setRows(), at the bottom of the table.
+    // anomalyScores is empty or not as it was for setRows().
+    void appendRows(const std::vector<WaterSample>& samples, const FilterResult& result, size_t firstPosition,
+                    const std::vector<double>& anomalyScores);
+    void clear();
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+private:
+    const std::vector<WaterSample> *samples = nullptr;
+    std::vector<size_t> rows;
+    std::vector<ComplianceStatus> statuses;
+    std::vector<double> scores; // Parallel to rows; empty when not scored
+    std::vector<size_t> order; // Table row -> position in rows
+};
+
+#endif // SAMPLETABLEMODEL_HPP
@@ -0,0 +1,109 @@
+#include "SampleTime.hpp"
+#include <cstdio>
+
+namespace sampletime {
+
+namespace {
+
+int64_t floorDays(int64_t seconds) {
+    return seconds >= 0 ? seconds / SECONDS_PER_DAY : (seconds - (SECONDS_PER_DAY - 1)) / SECONDS_PER_DAY;
+}
+
+} // namespace
+
+// H. Hinnant's days_from_civil / civil_from_days
+int64_t daysFromCivil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+    unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<int64_t>(dayOfEra) - 719468;
+}
+
+void civilFromDays(int64_t days, int64_t& year, unsigned& month, unsigned& day) {
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    unsigned dayOfEra = static_cast<unsigned>(days - era * 146097);
+    unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    unsigned monthIndex = (5 * dayOfYear + 2) / 153;
+    day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    year = static_cast<int64_t>(yearOfEra) + era * 400 + (month <= 2);
+}
+
+bool parse(const std::string& text, int64_t& seconds) {
+    static const char PATTERN[] = "0000-00-00T00:00:00";
+    if (text.size() != sizeof(PATTERN) - 1)
+        return false;
+
+    int fields[6] = {};
+    int field = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (PATTERN[i] == '0') {
+            if (text[i] < '0' || text[i] > '9')
+                return false;
+            fields[field] = fields[field] * 10 + (text[i] - '0');
+        } else if (text[i] != PATTERN[i]) {
+            return false;
+        } else {
+            field++;
+        }
+    }
+
+    if (fields[1] < 1 || fields[1] > 12 || fields[2] < 1 || fields[2] > 31 ||
+        fields[3] > 23 || fields[4] > 59 || fields[5] > 59)
+        return false;
+
+    seconds = daysFromCivil(fields[0], fields[1], fields[2]) * SECONDS_PER_DAY +
+              fields[3] * 3600 + fields[4] * 60 + fields[5];
+
+    int64_t year;
+    unsigned month, day;
+    civilFromDays(floorDays(seconds), year, month, day);
+    return static_cast<int>(month) == fields[1] && static_cast<int>(day) == fields[2];
+}
+
+std::string format(int64_t seconds) {
+    int64_t days = floorDays(seconds);
+    int64_t secondOfDay = seconds - days * SECONDS_PER_DAY;
+    int64_t year;
+    unsigned month, day;
+    civilFromDays(days, year, month, day);
+
+    char text[48];
+    std::snprintf(text, sizeof(text), "%04lld-%02u-%02uT%02d:%02d:%02d", static_cast<long long>(year), month, day,
+                  static_cast<int>(secondOfDay / 3600), static_cast<int>(secondOfDay / 60 % 60),
+                  static_cast<int>(secondOfDay % 60));
+    return text;
+}
+
+int64_t startOfDay(int64_t seconds) {
+    return floorDays(seconds) * SECONDS_PER_DAY;
+}
+
+int64_t startOfMonth(int64_t seconds) {
+    int64_t year;
+    unsigned month, day;
+    civilFromDays(floorDays(seconds), year, month, day);
+    return daysFromCivil(year, month, 1) * SECONDS_PER_DAY;
+}
+
+int64_t addMonths(int64_t monthStart, int months) {
+    int64_t year;
+    unsigned month, day;
+    civilFromDays(floorDays(monthStart), year, month, day);
+    int64_t index = year * 12 + (month - 1) + months;
+    int64_t newYear = index >= 0 ? index / 12 : (index - 11) / 12;
+    return daysFromCivil(newYear, static_cast<unsigned>(index - newYear * 12 + 1), 1) * SECONDS_PER_DAY;
+}
+
+int yearMonth(int64_t seconds) {
+    int64_t year;
+    unsigned month, day;
+    civilFromDays(floorDays(seconds), year, month, day);
+    return static_cast<int>(year * 100 + month);
+}
+
+} // namespace sampletime
@@ -0,0 +1,28 @@
+#ifndef SAMPLETIME_HPP
+#define SAMPLETIME_HPP
+
+#include <cstdint>
+#include <string>
+
+// Sample times as seconds since 1970-01-01T00:00:00, proleptic Gregorian
+// calendar, no time zone (the exports are in local time with no offset)
+namespace sampletime {
+
+constexpr int64_t SECONDS_PER_DAY = 86400;
+
+// Seconds of a "YYYY-MM-DDTHH:MM:SS" date; false for any other text, including
+// days past the end of the month, so format() gives back the same text
+bool parse(const std::string& text, int64_t& seconds);
+std::string format(int64_t seconds); // "YYYY-MM-DDTHH:MM:SS"
+
+int64_t daysFromCivil(int64_t year, unsigned month, unsigned day);
+void civilFromDays(int64_t days, int64_t& year, unsigned& month, unsigned& day);
+
+int64_t startOfDay(int64_t seconds);
+int64_t startOfMonth(int64_t seconds);
+int64_t addMonths(int64_t monthStart, int months); // monthStart from startOfMonth()
+int yearMonth(int64_t seconds);                    // YYYYMM
+
+} // namespace sampletime
+
+#endif // SAMPLETIME_HPP
@@ -0,0 +1,129 @@
+#include "SiteClusters.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Severity order for picking the worst status of a cluster
+int severity(ComplianceStatus status) {
+    switch (status) {
+    case ComplianceStatus::Bad:
+        return 3;
+    case ComplianceStatus::Medium:
+        return 2;
+    case ComplianceStatus::Good:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+} // namespace
+
+ComplianceStatus worstStatus(const StatusCounts& counts) {
+    if (counts.bad > 0)
+        return ComplianceStatus::Bad;
+    if (counts.medium > 0)
+        return ComplianceStatus::Medium;
+    if (counts.good > 0)
+        return ComplianceStatus::Good;
+    return ComplianceStatus::Missing;
+}
+
+SiteHierarchy::SiteHierarchy(std::vector<MapSite> sites) {
+    for (MapSite& site : sites) {
+        if (!site.position.known())
+            continue;
+        extent.extend(site.position);
+        siteList.push_back(std::move(site));
+    }
+    if (siteList.empty())
+        return;
+
+    std::vector<SiteCluster> clusters;
+    for (size_t i = 0; i < siteList.size(); ++i)
+        clusters.push_back(SiteCluster{siteList[i].position, 1, siteList[i].worst, i});
+    fileClusters(clusters, FINEST_CELL_SIZE * TILE_CELLS);
+
+    // Each level groups the sites afresh by its own cells, so a cluster's
+    // centre is the mean of exactly the sites in its cell
+    struct Sum {
+        double easting = 0.0;
+        double northing = 0.0;
+        SiteCluster cluster;
+    };
+    // Cells twice the extent leave at most four clusters, which is coarse
+    // enough: sites straddling a cell boundary may never share a cell
+    double span = std::max(extent.maxEasting - extent.minEasting, extent.maxNorthing - extent.minNorthing);
+    for (double cellSize = FINEST_CELL_SIZE; clusters.size() > 1 && cellSize <= 2 * span + FINEST_CELL_SIZE;
+         cellSize *= 2) {
+        std::unordered_map<uint64_t, Sum> cells;
+        for (size_t i = 0; i < siteList.size(); ++i) {
+            const MapSite& site = siteList[i];
+            Sum& sum = cells[gridCellKey(site.position, cellSize)];
+            if (sum.cluster.siteCount == 0)
+                sum.cluster.site = i;
+            sum.easting += site.position.easting;
+            sum.northing += site.position.northing;
+            sum.cluster.siteCount++;
+            if (severity(site.worst) > severity(sum.cluster.worst))
+                sum.cluster.worst = site.worst;
+        }
+
+        clusters.clear();
+        for (auto& entry : cells) {
+            SiteCluster cluster = entry.second.cluster;
+            cluster.centre = GridPoint{entry.second.easting / cluster.siteCount,
+                                       entry.second.northing / cluster.siteCount};
+            clusters.push_back(cluster);
+        }
+        fileClusters(clusters, cellSize * TILE_CELLS);
+    }
+}
+
+void SiteHierarchy::fileClusters(const std::vector<SiteCluster>& clusters, double tileSize) {
+    Level level;
+    level.tileSize = tileSize;
+    level.clusterCount = clusters.size();
+    for (const SiteCluster& cluster : clusters)
+        level.tiles[gridCellKey(cluster.centre, tileSize)].push_back(cluster);
+    levels.push_back(std::move(level));
+}
+
+size_t SiteHierarchy::levelFor(double minSpacing) const {
+    if (levels.empty() || minSpacing < FINEST_CELL_SIZE)
+        return 0;
+    // Level k >= 1 has cells of FINEST_CELL_SIZE * 2^(k - 1)
+    size_t level = 1 + static_cast<size_t>(std::ceil(std::log2(minSpacing / FINEST_CELL_SIZE)));
+    return std::min(level, levels.size() - 1);
+}
+
+std::vector<const SiteCluster*> SiteHierarchy::visible(size_t level, const GridBox& view) const {
+    std::vector<const SiteCluster*> clusters;
+    if (level >= levels.size())
+        return clusters;
+
+    // Only tiles that can hold sites are visited, however far out the view
+    GridBox search = view;
+    search.minEasting = std::max(search.minEasting, extent.minEasting);
+    search.minNorthing = std::max(search.minNorthing, extent.minNorthing);
+    search.maxEasting = std::min(search.maxEasting, extent.maxEasting);
+    search.maxNorthing = std::min(search.maxNorthing, extent.maxNorthing);
+    if (search.empty())
+        return clusters;
+
+    const Level& tiled = levels[level];
+    for (int64_t column = gridCell(search.minEasting, tiled.tileSize);
+         column <= gridCell(search.maxEasting, tiled.tileSize); ++column) {
+        for (int64_t row = gridCell(search.minNorthing, tiled.tileSize);
+             row <= gridCell(search.maxNorthing, tiled.tileSize); ++row) {
+            auto tile = tiled.tiles.find(gridCellKey(column, row));
+            if (tile == tiled.tiles.end())
+                continue;
+            for (const SiteCluster& cluster : tile->second)
+                if (view.contains(cluster.centre))
+                    clusters.push_back(&cluster);
+        }
+    }
+    return clusters;
+}
@@ -0,0 +1,73 @@
+#ifndef SITECLUSTERS_HPP
+#define SITECLUSTERS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ComplianceRules.hpp"
+#include "SpatialIndex.hpp"
+#include "StatsEngine.hpp"
+
+// Bad, then medium, then good; missing only when nothing was assessed
+ComplianceStatus worstStatus(const StatusCounts& counts);
+
+// A sampling point on the map, with the worst status of its rows
+struct MapSite {
+    std::string location;
+    GridPoint position;
+    ComplianceStatus worst = ComplianceStatus::Missing;
+};
+
+// Sites near enough to be drawn as one marker
+struct SiteCluster {
+    GridPoint centre; // Mean position of the sites
+    size_t siteCount = 0;
+    ComplianceStatus worst = ComplianceStatus::Missing;
+    size_t site = 0; // Position in sites() of one of them, the only one if siteCount is 1
+};
+
+// Sites clustered at every zoom, for drawing thousands of them in time
+// proportional to the markers on screen. Level 0 has a cluster per site; each
+// level above merges the sites sharing a grid cell twice the side of the
+// level below's, up to cells twice the extent of the sites. Each level's
+// clusters are filed in tiles of TILE_CELLS x TILE_CELLS cells, so a view
+// only visits the tiles it overlaps. Built once, in
+// O(n log(extent / FINEST_CELL_SIZE)).
+class SiteHierarchy {
+public:
+    // Cell side of level 1 in metres; closer sites are merged only there
+    static constexpr double FINEST_CELL_SIZE = 250.0;
+    static constexpr int TILE_CELLS = 16;
+
+    SiteHierarchy() = default;
+    explicit SiteHierarchy(std::vector<MapSite> sites); // Sites without a known position are left out
+
+    bool empty() const { return siteList.empty(); }
+    const std::vector<MapSite>& sites() const { return siteList; }
+    const GridBox& bounds() const { return extent; }
+    size_t levelCount() const { return levels.size(); }
+    size_t clusterCount(size_t level) const { return levels[level].clusterCount; }
+
+    // The finest level whose clusters are at least minSpacing metres apart,
+    // roughly: its cell side is that or more
+    size_t levelFor(double minSpacing) const;
+    // Clusters of level with their centre inside view
+    std::vector<const SiteCluster*> visible(size_t level, const GridBox& view) const;
+
+private:
+    struct Level {
+        double tileSize = 0.0;
+        size_t clusterCount = 0;
+        std::unordered_map<uint64_t, std::vector<SiteCluster>> tiles;
+    };
+
+    void fileClusters(const std::vector<SiteCluster>& clusters, double tileSize);
+
+    std::vector<MapSite> siteList;
+    GridBox extent;
+    std::vector<Level> levels;
+};
+
+#endif // SITECLUSTERS_HPP
@@ -0,0 +1,201 @@
+#include "SiteMap.hpp"
+#include <QMouseEvent>
+#include <QPainter>
+#include <QResizeEvent>
+#include <QWheelEvent>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Markers are drawn at least this far apart; closer sites are clustered
+constexpr double CLUSTER_PIXELS = 24.0;
+constexpr double SITE_RADIUS = 5.0;
+constexpr double MAX_MARKER_RADIUS = 14.0;
+// Site names are drawn when no more markers than this are in view
+constexpr size_t MAX_LABELS = 30;
+constexpr double MIN_METRES_PER_PIXEL = 0.5;
+constexpr double MAX_METRES_PER_PIXEL = 5000.0;
+constexpr double ZOOM_PER_STEP = 1.25; // One wheel notch
+
+QColor markerColor(ComplianceStatus status) {
+    switch (status) {
+    case ComplianceStatus::Good:
+        return QColor(0, 200, 0);
+    case ComplianceStatus::Medium:
+        return QColor(255, 165, 0);
+    case ComplianceStatus::Bad:
+        return QColor(230, 0, 0);
+    default:
+        return QColor(170, 170, 170); // Nothing assessed
+    }
+}
+
+} // namespace
+
+SiteMap::SiteMap(QWidget *parent) : QWidget(parent) {
+    setMinimumHeight(220);
+    setMinimumWidth(300);
+    clear("No sampling point coordinates loaded");
+}
+
+void SiteMap::setSites(SiteHierarchy sites) {
+    bool wasEmpty = hierarchy.empty();
+    hierarchy = std::move(sites);
+    message = hierarchy.empty() ? QString("No sampling point coordinates loaded") : QString();
+    if (wasEmpty)
+        fitView();
+    update();
+}
+
+void SiteMap::clear(const QString& newMessage) {
+    hierarchy = SiteHierarchy();
+    message = newMessage;
+    summary.clear();
+    update();
+}
+
+void SiteMap::setSummary(const QString& text) {
+    summary = text;
+    update();
+}
+
+void SiteMap::fitView() {
+    if (hierarchy.empty())
+        return;
+    const GridBox& bounds = hierarchy.bounds();
+    centre = GridPoint{(bounds.minEasting + bounds.maxEasting) / 2, (bounds.minNorthing + bounds.maxNorthing) / 2};
+    // A margin of a marker's width around the outermost sites
+    int inset = static_cast<int>(MAX_MARKER_RADIUS);
+    QRect area = mapArea().adjusted(inset, inset, -inset, -inset);
+    setScale(std::max((bounds.maxEasting - bounds.minEasting) / std::max(area.width(), 1),
+                      (bounds.maxNorthing - bounds.minNorthing) / std::max(area.height(), 1)));
+    fitted = true;
+    viewMoved();
+}
+
+GridBox SiteMap::visibleArea() const {
+    QRect area = mapArea();
+    double halfWidth = std::max(area.width(), 0) / 2.0 * metresPerPixel;
+    double halfHeight = std::max(area.height(), 0) / 2.0 * metresPerPixel;
+    return GridBox{centre.easting - halfWidth, centre.northing - halfHeight, centre.easting + halfWidth,
+                   centre.northing + halfHeight};
+}
+
+void SiteMap::viewMoved() {
+    update();
+    if (!hierarchy.empty())
+        emit viewChanged(visibleArea());
+}
+
+QRect SiteMap::mapArea() const {
+    return rect().adjusted(8, 24, -8, -8);
+}
+
+void SiteMap::setScale(double scale) {
+    metresPerPixel = std::clamp(scale, MIN_METRES_PER_PIXEL, MAX_METRES_PER_PIXEL);
+}
+
+void SiteMap::paintEvent(QPaintEvent *) {
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::white);
+
+    if (hierarchy.empty()) {
+        painter.setPen(Qt::gray);
+        painter.drawText(rect(), Qt::AlignCenter, message);
+        return;
+    }
+
+    QRect area = mapArea();
+    if (area.width() <= 0 || area.height() <= 0)
+        return;
+
+    // Northing grows up the screen
+    QPointF middle = QRectF(area).center();
+    auto toScreen = [&](const GridPoint& point) {
+        return QPointF(middle.x() + (point.easting - centre.easting) / metresPerPixel,
+                       middle.y() - (point.northing - centre.northing) / metresPerPixel);
+    };
+
+    // Clusters just outside the view still show part of their marker
+    double margin = MAX_MARKER_RADIUS * metresPerPixel;
+    GridBox view = visibleArea();
+    view.minEasting -= margin;
+    view.minNorthing -= margin;
+    view.maxEasting += margin;
+    view.maxNorthing += margin;
+    size_t level = hierarchy.levelFor(CLUSTER_PIXELS * metresPerPixel);
+    std::vector<const SiteCluster*> clusters = hierarchy.visible(level, view);
+
+    painter.setPen(Qt::darkGray);
+    painter.drawRect(area);
+    painter.drawText(QRect(area.left(), 4, area.width(), 16), Qt::AlignLeft,
+                     summary.isEmpty() ? QString("%1 sites, worst status per site").arg(hierarchy.sites().size())
+                                       : summary);
+    painter.drawText(QRect(area.left(), 4, area.width(), 16), Qt::AlignRight,
+                     QString("%1 m per pixel").arg(metresPerPixel, 0, 'g', 3));
+
+    painter.setClipRect(area);
+    painter.setRenderHint(QPainter::Antialiasing);
+    bool labelled = level == 0 && clusters.size() <= MAX_LABELS;
+    for (const SiteCluster *cluster : clusters) {
+        QPointF position = toScreen(cluster->centre);
+        double radius = std::min(MAX_MARKER_RADIUS, SITE_RADIUS + 2.0 * std::log2(double(cluster->siteCount)));
+        painter.setPen(QPen(Qt::darkGray, 1.0));
+        painter.setBrush(markerColor(cluster->worst));
+        painter.drawEllipse(position, radius, radius);
+
+        if (cluster->siteCount > 1) {
+            painter.setPen(Qt::black);
+            painter.drawText(QRectF(position.x() - radius, position.y() - radius, 2 * radius, 2 * radius),
+                             Qt::AlignCenter, QString::number(cluster->siteCount));
+        } else if (labelled) {
+            painter.setPen(Qt::black);
+            painter.drawText(position + QPointF(radius + 3, 4),
+                             QString::fromStdString(hierarchy.sites()[cluster->site].location));
+        }
+    }
+}
+
+void SiteMap::resizeEvent(QResizeEvent *) {
+    // A fitted view stays fitted, e.g. when the map is first laid out
+    if (fitted)
+        fitView();
+    else
+        viewMoved();
+}
+
+void SiteMap::wheelEvent(QWheelEvent *event) {
+    QRect area = mapArea();
+    if (hierarchy.empty() || area.width() <= 0)
+        return;
+
+    // Zoom around the grid position under the cursor
+    QPointF offset = event->position() - QRectF(area).center();
+    GridPoint anchor{centre.easting + offset.x() * metresPerPixel, centre.northing - offset.y() * metresPerPixel};
+    setScale(metresPerPixel * std::pow(ZOOM_PER_STEP, -event->angleDelta().y() / 120.0));
+    centre = GridPoint{anchor.easting - offset.x() * metresPerPixel, anchor.northing + offset.y() * metresPerPixel};
+    fitted = false;
+    viewMoved();
+    event->accept();
+}
+
+void SiteMap::mousePressEvent(QMouseEvent *event) {
+    dragPosition = event->position();
+}
+
+void SiteMap::mouseMoveEvent(QMouseEvent *event) {
+    if (hierarchy.empty() || !(event->buttons() & Qt::LeftButton))
+        return;
+
+    QPointF shift = event->position() - dragPosition;
+    dragPosition = event->position();
+    centre.easting -= shift.x() * metresPerPixel;
+    centre.northing += shift.y() * metresPerPixel;
+    fitted = false;
+    viewMoved();
+}
+
+void SiteMap::mouseDoubleClickEvent(QMouseEvent *) {
+    fitView();
+}
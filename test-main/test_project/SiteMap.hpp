@@ -0,0 +1,55 @@
+#ifndef SITEMAP_HPP
+#define SITEMAP_HPP
+
+#include <QWidget>
+#include <QString>
+#include <QPointF>
+#include "SiteClusters.hpp"
+
+// Map of the shown result's sampling points, each coloured by its worst
+// status. Sites closer on screen than a marker merge into one marker showing
+// how many it holds: each repaint takes the SiteHierarchy level for the zoom
+// and draws only the clusters of the tiles in view, so thousands of sites
+// zoom (mouse wheel) and pan (drag) smoothly. Double-click shows every site.
+class SiteMap : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit SiteMap(QWidget *parent = nullptr);
+
+    // Keeps the current view unless nothing was shown
+    void setSites(SiteHierarchy sites);
+    void clear(const QString& message);
+    void fitView();
+    // Grid area in view, without the markers' margin
+    GridBox visibleArea() const;
+    // Drawn above the map, e.g. counts for the sites in view
+    void setSummary(const QString& text);
+
+signals:
+    // Zoomed, panned, refitted or resized
+    void viewChanged(const GridBox& view);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private:
+    QRect mapArea() const;
+    void setScale(double scale);
+    void viewMoved();
+
+    SiteHierarchy hierarchy;
+    QString message;
+    QString summary;
+    GridPoint centre; // Grid position at the middle of mapArea()
+    double metresPerPixel = 1.0;
+    bool fitted = false; // The view is fitView()'s, not moved since
+    QPointF dragPosition;
+};
+
+#endif // SITEMAP_HPP
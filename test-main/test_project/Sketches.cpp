@@ -0,0 +1,261 @@
+#include "Sketches.hpp"
+#include "MemoryUsage.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+
+// splitmix64 finaliser, spreads std::hash output over all 64 bits
+uint64_t mixHash(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+int leadingZeros(uint64_t x) {
+    if (x == 0)
+        return 64;
+    int zeros = 0;
+    while (!(x & 0x8000000000000000ULL)) {
+        x <<= 1;
+        zeros++;
+    }
+    return zeros;
+}
+
+} // namespace
+
+TDigest::TDigest(double compression)
+    : compression(compression),
+      minValue(std::numeric_limits<double>::infinity()),
+      maxValue(-std::numeric_limits<double>::infinity()) {}
+
+void TDigest::add(double value, double weight) {
+    if (std::isnan(value) || weight <= 0.0)
+        return;
+
+    minValue = std::min(minValue, value);
+    maxValue = std::max(maxValue, value);
+    buffer.push_back({value, weight});
+    totalWeight += weight;
+
+    if (buffer.size() >= static_cast<size_t>(5 * compression))
+        compress();
+}
+
+void TDigest::merge(const TDigest& other) {
+    other.compress();
+    for (const auto& centroid : other.centroids)
+        buffer.push_back(centroid);
+
+    totalWeight += other.totalWeight;
+    minValue = std::min(minValue, other.minValue);
+    maxValue = std::max(maxValue, other.maxValue);
+    compress();
+}
+
+double TDigest::count() const {
+    return totalWeight;
+}
+
+size_t TDigest::approximateBytes() const {
+    return (centroids.capacity() + buffer.capacity()) * sizeof(Centroid);
+}
+
+void TDigest::compress() const {
+    if (buffer.empty())
+        return;
+
+    buffer.insert(buffer.end(), centroids.begin(), centroids.end());
+    std::sort(buffer.begin(), buffer.end(),
+              [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+
+    // k1 scale function: centroids are small near q = 0 and q = 1
+    auto scale = [this](double q) { return compression / (2.0 * PI) * std::asin(2.0 * q - 1.0); };
+    auto inverseScale = [this](double k) { return (std::sin(k * 2.0 * PI / compression) + 1.0) / 2.0; };
+
+    std::vector<Centroid> merged;
+    Centroid current = buffer.front();
+    double weightSoFar = 0.0;
+    double limit = totalWeight * inverseScale(scale(0.0) + 1.0);
+
+    for (size_t i = 1; i < buffer.size(); ++i) {
+        const Centroid& next = buffer[i];
+        if (weightSoFar + current.weight + next.weight <= limit) {
+            current.weight += next.weight;
+            current.mean += (next.mean - current.mean) * next.weight / current.weight;
+        } else {
+            weightSoFar += current.weight;
+            merged.push_back(current);
+            current = next;
+            limit = totalWeight * inverseScale(scale(std::min(1.0, weightSoFar / totalWeight)) + 1.0);
+        }
+    }
+    merged.push_back(current);
+
+    centroids.swap(merged);
+    buffer.clear();
+}
+
+double TDigest::quantile(double q) const {
+    compress();
+    if (centroids.empty())
+        return std::numeric_limits<double>::quiet_NaN();
+    if (centroids.size() == 1)
+        return centroids.front().mean;
+
+    q = std::min(1.0, std::max(0.0, q));
+    double target = q * totalWeight;
+
+    // Interpolate between centroid centres; the extremes are anchored at min/max
+    double cumulative = 0.0;
+    double previousCentre = 0.0;
+    double previousMean = minValue;
+    for (const auto& centroid : centroids) {
+        double centre = cumulative + centroid.weight / 2.0;
+        if (target < centre) {
+            double span = centre - previousCentre;
+            double t = span > 0.0 ? (target - previousCentre) / span : 0.0;
+            return previousMean + t * (centroid.mean - previousMean);
+        }
+        cumulative += centroid.weight;
+        previousCentre = centre;
+        previousMean = centroid.mean;
+    }
+
+    double span = totalWeight - previousCentre;
+    double t = span > 0.0 ? (target - previousCentre) / span : 1.0;
+    return previousMean + t * (maxValue - previousMean);
+}
+
+HyperLogLog::HyperLogLog(int precision)
+    : precision(precision), registers(static_cast<size_t>(1) << precision, 0) {}
+
+void HyperLogLog::add(const std::string& value) {
+    uint64_t hash = mixHash(std::hash<std::string>()(value));
+    size_t index = static_cast<size_t>(hash >> (64 - precision));
+    uint64_t rest = hash << precision;
+    uint8_t rank = static_cast<uint8_t>(std::min(leadingZeros(rest), 64 - precision) + 1);
+    registers[index] = std::max(registers[index], rank);
+}
+
+void HyperLogLog::merge(const HyperLogLog& other) {
+    if (other.precision != precision)
+        return; // Sketches of different precision cannot be combined
+
+    for (size_t i = 0; i < registers.size(); ++i)
+        registers[i] = std::max(registers[i], other.registers[i]);
+}
+
+double HyperLogLog::estimate() const {
+    double m = static_cast<double>(registers.size());
+    double sum = 0.0;
+    int zeros = 0;
+    for (uint8_t reg : registers) {
+        sum += std::ldexp(1.0, -reg);
+        if (reg == 0)
+            zeros++;
+    }
+
+    double alpha = 0.7213 / (1.0 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
+
+    // Linear counting is more accurate while many registers are still empty
+    if (estimate <= 2.5 * m && zeros > 0)
+        estimate = m * std::log(m / zeros);
+    return estimate;
+}
+
+void DatasetSketches::add(const WaterSample& sample) {
+    add(sample.getLocation(), sample.getPollutant(), sample.getYearMonth(), sample.getLevel());
+}
+
+void DatasetSketches::add(const std::vector<WaterSample>& samples) {
+    for (const auto& sample : samples)
+        add(sample);
+}
+
+void DatasetSketches::add(const std::string& location, const std::string& pollutant, int yearMonth,
+                          double level) {
+    Partition& partition = partitions[yearMonth / 100];
+    partition.levels[SeriesKey{location, pollutant}].add(level);
+    partition.samplingPoints.add(location);
+    partition.samplingPointsByPollutant[pollutant].add(location);
+}
+
+void DatasetSketches::merge(const DatasetSketches& other) {
+    for (const auto& entry : other.partitions) {
+        Partition& partition = partitions[entry.first];
+        for (const auto& digest : entry.second.levels)
+            partition.levels[digest.first].merge(digest.second);
+        partition.samplingPoints.merge(entry.second.samplingPoints);
+        for (const auto& counter : entry.second.samplingPointsByPollutant)
+            partition.samplingPointsByPollutant[counter.first].merge(counter.second);
+    }
+}
+
+void DatasetSketches::clear() {
+    partitions.clear();
+}
+
+size_t DatasetSketches::approximateBytes() const {
+    size_t bytes = nodeBytes(partitions);
+    for (const auto& entry : partitions) {
+        const Partition& partition = entry.second;
+        bytes += hashMapBytes(partition.levels) + partition.samplingPoints.approximateBytes() +
+                 hashMapBytes(partition.samplingPointsByPollutant);
+        for (const auto& digest : partition.levels)
+            bytes += heapBytes(digest.first.location) + heapBytes(digest.first.pollutant) +
+                     digest.second.approximateBytes();
+        for (const auto& counter : partition.samplingPointsByPollutant)
+            bytes += heapBytes(counter.first) + counter.second.approximateBytes();
+    }
+    return bytes;
+}
+
+TDigest DatasetSketches::levelDigest(const std::string& location, const std::string& pollutant, int year) const {
+    TDigest result;
+    for (const auto& entry : partitions) {
+        if (year != 0 && entry.first != year)
+            continue;
+
+        const auto& levels = entry.second.levels;
+        if (!location.empty() && !pollutant.empty()) {
+            auto it = levels.find(SeriesKey{location, pollutant});
+            if (it != levels.end())
+                result.merge(it->second);
+            continue;
+        }
+
+        for (const auto& digest : levels) {
+            if (!location.empty() && digest.first.location != location)
+                continue;
+            if (!pollutant.empty() && digest.first.pollutant != pollutant)
+                continue;
+            result.merge(digest.second);
+        }
+    }
+    return result;
+}
+
+double DatasetSketches::distinctSamplingPoints(const std::string& pollutant, int year) const {
+    HyperLogLog result;
+    for (const auto& entry : partitions) {
+        if (year != 0 && entry.first != year)
+            continue;
+
+        if (pollutant.empty()) {
+            result.merge(entry.second.samplingPoints);
+        } else {
+            auto it = entry.second.samplingPointsByPollutant.find(pollutant);
+            if (it != entry.second.samplingPointsByPollutant.end())
+                result.merge(it->second);
+        }
+    }
+    return result.estimate();
+}
@@ -0,0 +1,83 @@
+#ifndef SKETCHES_HPP
+#define SKETCHES_HPP
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "WaterSample.hpp"
+#include "DatasetAggregates.hpp"
+
+// Merging t-digest: approximate quantiles in O(compression) memory, accurate
+// at the tails. Digests built over disjoint rows can be merged.
+class TDigest {
+public:
+    explicit TDigest(double compression = 100.0);
+
+    void add(double value, double weight = 1.0);
+    void merge(const TDigest& other);
+
+    double quantile(double q) const; // NaN when empty
+    double count() const;
+    size_t approximateBytes() const; // Heap bytes held
+
+private:
+    struct Centroid {
+        double mean;
+        double weight;
+    };
+
+    void compress() const;
+
+    double compression;
+    double minValue;
+    double maxValue;
+    // Compression is deferred until a query, so both are mutable
+    mutable std::vector<Centroid> centroids;
+    mutable std::vector<Centroid> buffer;
+    mutable double totalWeight = 0.0;
+};
+
+// HyperLogLog distinct counter with 2^precision one-byte registers
+class HyperLogLog {
+public:
+    explicit HyperLogLog(int precision = 12);
+
+    void add(const std::string& value);
+    void merge(const HyperLogLog& other);
+    double estimate() const;
+    size_t approximateBytes() const { return registers.capacity(); } // Heap bytes held
+
+private:
+    int precision;
+    std::vector<uint8_t> registers;
+};
+
+// Quantile and distinct-count sketches per year partition. A partition is
+// built while its rows are loaded and queries merge the partitions involved.
+class DatasetSketches {
+public:
+    void add(const WaterSample& sample);
+    void add(const std::vector<WaterSample>& samples);
+    void add(const std::string& location, const std::string& pollutant, int yearMonth, double level);
+    void merge(const DatasetSketches& other);
+    void clear();
+    size_t approximateBytes() const; // Heap bytes held, estimated
+
+    // Level digest for the arguments; empty strings and 0 mean "all"
+    TDigest levelDigest(const std::string& location, const std::string& pollutant, int year = 0) const;
+    // Estimated number of distinct sampling points; empty pollutant and 0 mean "all"
+    double distinctSamplingPoints(const std::string& pollutant = "", int year = 0) const;
+
+private:
+    struct Partition {
+        std::unordered_map<SeriesKey, TDigest, SeriesKeyHash> levels;
+        HyperLogLog samplingPoints;
+        std::unordered_map<std::string, HyperLogLog> samplingPointsByPollutant;
+    };
+
+    std::map<int, Partition> partitions;
+};
+
+#endif // SKETCHES_HPP
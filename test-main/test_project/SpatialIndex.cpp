@@ -0,0 +1,149 @@
+#include "SpatialIndex.hpp"
+#include "MemoryUsage.hpp"
+#include <algorithm>
+#include <cmath>
+
+GridPoint positionOf(const WaterSample& sample) {
+    return GridPoint{sample.getEasting(), sample.getNorthing()};
+}
+
+int64_t gridCell(double coordinate, double size) {
+    return static_cast<int64_t>(std::floor(coordinate / size));
+}
+
+uint64_t gridCellKey(int64_t column, int64_t row) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(column)) << 32 | static_cast<uint32_t>(row);
+}
+
+uint64_t gridCellKey(const GridPoint& point, double size) {
+    return gridCellKey(gridCell(point.easting, size), gridCell(point.northing, size));
+}
+
+bool GridBox::contains(const GridPoint& point) const {
+    return point.easting >= minEasting && point.easting <= maxEasting && point.northing >= minNorthing &&
+           point.northing <= maxNorthing;
+}
+
+bool GridBox::intersects(const GridBox& other) const {
+    return !empty() && !other.empty() && minEasting <= other.maxEasting && other.minEasting <= maxEasting &&
+           minNorthing <= other.maxNorthing && other.minNorthing <= maxNorthing;
+}
+
+void GridBox::extend(const GridPoint& point) {
+    if (!point.known())
+        return;
+    minEasting = std::min(minEasting, point.easting);
+    minNorthing = std::min(minNorthing, point.northing);
+    maxEasting = std::max(maxEasting, point.easting);
+    maxNorthing = std::max(maxNorthing, point.northing);
+}
+
+SpatialArea SpatialArea::box(const GridBox& box) {
+    SpatialArea area;
+    area.bounds = box;
+    return area;
+}
+
+SpatialArea SpatialArea::circle(const GridPoint& centre, double radius) {
+    SpatialArea area;
+    area.bounds = GridBox{centre.easting - radius, centre.northing - radius, centre.easting + radius,
+                          centre.northing + radius};
+    area.radius = radius;
+    return area;
+}
+
+bool SpatialArea::contains(const GridPoint& point) const {
+    if (!bounds.contains(point))
+        return false;
+    if (radius <= 0.0)
+        return true;
+    double east = point.easting - (bounds.minEasting + bounds.maxEasting) / 2;
+    double north = point.northing - (bounds.minNorthing + bounds.maxNorthing) / 2;
+    return east * east + north * north <= radius * radius;
+}
+
+bool SpatialArea::operator==(const SpatialArea& other) const {
+    return bounds.minEasting == other.bounds.minEasting && bounds.minNorthing == other.bounds.minNorthing &&
+           bounds.maxEasting == other.bounds.maxEasting && bounds.maxNorthing == other.bounds.maxNorthing &&
+           radius == other.radius;
+}
+
+void SpatialIndex::add(const std::string& location, const GridPoint& point) {
+    if (!point.known())
+        return;
+
+    auto it = positions.find(location);
+    if (it != positions.end()) {
+        const GridPoint& old = it->second;
+        if (old.easting == point.easting && old.northing == point.northing)
+            return;
+        std::vector<std::string>& oldCell = cells[gridCellKey(old, CELL_SIZE)];
+        oldCell.erase(std::find(oldCell.begin(), oldCell.end(), location));
+        it->second = point;
+    } else {
+        positions.emplace(location, point);
+    }
+    cells[gridCellKey(point, CELL_SIZE)].push_back(location);
+    extent.extend(point);
+}
+
+void SpatialIndex::add(const std::vector<WaterSample>& samples) {
+    // Rows come grouped by sampling point, so most repeat the one before
+    const WaterSample* previous = nullptr;
+    for (const WaterSample& sample : samples) {
+        if (!previous || sample.getLocation() != previous->getLocation() ||
+            sample.getEasting() != previous->getEasting() || sample.getNorthing() != previous->getNorthing())
+            add(sample.getLocation(), positionOf(sample));
+        previous = &sample;
+    }
+}
+
+void SpatialIndex::clear() {
+    positions.clear();
+    cells.clear();
+    extent = GridBox();
+}
+
+size_t SpatialIndex::approximateBytes() const {
+    size_t bytes = hashMapBytes(positions) + hashMapBytes(cells);
+    for (const auto& point : positions)
+        bytes += heapBytes(point.first);
+    for (const auto& cell : cells) {
+        bytes += cell.second.capacity() * sizeof(std::string);
+        for (const std::string& location : cell.second)
+            bytes += heapBytes(location);
+    }
+    return bytes;
+}
+
+GridPoint SpatialIndex::find(const std::string& location) const {
+    auto it = positions.find(location);
+    return it == positions.end() ? GridPoint() : it->second;
+}
+
+std::vector<std::string> SpatialIndex::within(const SpatialArea& area) const {
+    std::vector<std::string> names;
+    // Only the cells that hold points can match, however large the area
+    GridBox search = area.bounds;
+    search.minEasting = std::max(search.minEasting, extent.minEasting);
+    search.minNorthing = std::max(search.minNorthing, extent.minNorthing);
+    search.maxEasting = std::min(search.maxEasting, extent.maxEasting);
+    search.maxNorthing = std::min(search.maxNorthing, extent.maxNorthing);
+    if (search.empty())
+        return names;
+
+    for (int64_t column = gridCell(search.minEasting, CELL_SIZE); column <= gridCell(search.maxEasting, CELL_SIZE);
+         ++column) {
+        for (int64_t row = gridCell(search.minNorthing, CELL_SIZE); row <= gridCell(search.maxNorthing, CELL_SIZE);
+             ++row) {
+            auto cell = cells.find(gridCellKey(column, row));
+            if (cell == cells.end())
+                continue;
+            for (const std::string& location : cell->second)
+                if (area.contains(positions.at(location)))
+                    names.push_back(location);
+        }
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
@@ -0,0 +1,84 @@
+#ifndef SPATIALINDEX_HPP
+#define SPATIALINDEX_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "WaterSample.hpp"
+
+// British National Grid position in metres, as in the EA exports. NaN
+// coordinates mean the position is not known.
+struct GridPoint {
+    double easting = std::numeric_limits<double>::quiet_NaN();
+    double northing = std::numeric_limits<double>::quiet_NaN();
+
+    bool known() const { return !std::isnan(easting) && !std::isnan(northing); }
+};
+
+GridPoint positionOf(const WaterSample& sample);
+
+// Column or row of the square grid cell of side size holding coordinate, and
+// one key per cell, for grids filed in hash maps
+int64_t gridCell(double coordinate, double size);
+uint64_t gridCellKey(int64_t column, int64_t row);
+uint64_t gridCellKey(const GridPoint& point, double size);
+
+// Axis-aligned box, edges included. Starts empty and grows with extend().
+struct GridBox {
+    double minEasting = std::numeric_limits<double>::infinity();
+    double minNorthing = std::numeric_limits<double>::infinity();
+    double maxEasting = -std::numeric_limits<double>::infinity();
+    double maxNorthing = -std::numeric_limits<double>::infinity();
+
+    bool empty() const { return minEasting > maxEasting || minNorthing > maxNorthing; }
+    bool contains(const GridPoint& point) const;
+    bool intersects(const GridBox& other) const;
+    void extend(const GridPoint& point); // Unknown points are ignored
+};
+
+// Where a query is limited to: a box, e.g. around a catchment, or the
+// sampling points within radius metres of a point
+struct SpatialArea {
+    GridBox bounds;
+    double radius = 0.0; // Positive for a circle around the middle of bounds
+
+    static SpatialArea box(const GridBox& box);
+    static SpatialArea circle(const GridPoint& centre, double radius);
+
+    bool contains(const GridPoint& point) const;
+    bool operator==(const SpatialArea& other) const;
+};
+
+// Sampling points by position, in a uniform grid of CELL_SIZE cells, so the
+// points in an area are found by visiting the cells it overlaps rather than
+// every point. A point that moves is re-filed.
+class SpatialIndex {
+public:
+    // Cell side in metres; a few sampling points per cell at the density of
+    // the EA network
+    static constexpr double CELL_SIZE = 10000.0;
+
+    void add(const std::string& location, const GridPoint& point); // Unknown points are ignored
+    void add(const std::vector<WaterSample>& samples);
+    void clear();
+    size_t approximateBytes() const; // Heap bytes held, estimated
+
+    size_t size() const { return positions.size(); }
+    const GridBox& bounds() const { return extent; }
+    const std::unordered_map<std::string, GridPoint>& points() const { return positions; }
+    GridPoint find(const std::string& location) const; // Unknown when not indexed
+
+    // Names of the points inside area, sorted
+    std::vector<std::string> within(const SpatialArea& area) const;
+
+private:
+    std::unordered_map<std::string, GridPoint> positions;
+    std::unordered_map<uint64_t, std::vector<std::string>> cells;
+    GridBox extent; // Of every point ever added, so it only grows
+};
+
+#endif // SPATIALINDEX_HPP
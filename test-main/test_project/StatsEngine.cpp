@@ -0,0 +1,211 @@
+#include "StatsEngine.hpp"
+#include "Parallel.hpp"
+#include "MemoryUsage.hpp"
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+namespace {
+
+void reduceRange(const std::vector<WaterSample>& samples, const ComplianceRules& rules,
+                 const SampleFilter& filter, size_t begin, size_t end, FilterPartial& partial) {
+    for (size_t i = begin; i < end; ++i) {
+        const WaterSample& sample = samples[i];
+        if (!filter.location.empty() && sample.getLocation() != filter.location)
+            continue;
+        if (!filter.pollutant.empty() && sample.getPollutant() != filter.pollutant)
+            continue;
+        if (filter.area && !filter.area->contains(positionOf(sample)))
+            continue;
+
+        int year = sample.getYearMonth() / 100;
+        if (filter.year != 0 && year != filter.year)
+            continue;
+
+        ComplianceStatus status = rules.assess(sample);
+        if (filter.status && status != *filter.status)
+            continue;
+
+        partial.rows.push_back(i);
+        partial.statuses.push_back(status);
+        partial.stats.add(sample, status);
+    }
+}
+
+void mergePartial(FilterPartial& into, const FilterPartial& from) {
+    into.rows.insert(into.rows.end(), from.rows.begin(), from.rows.end());
+    into.statuses.insert(into.statuses.end(), from.statuses.begin(), from.statuses.end());
+    into.stats.merge(from.stats);
+}
+
+// Whether entry ranks before current: by rate (higher or lower first), then
+// by more assessed samples, then by the smaller key, so the pick does not
+// depend on the map's iteration order
+template <typename Entry>
+bool ranksBefore(const Entry& entry, const Entry* current, bool higherRateFirst) {
+    if (!current)
+        return true;
+    double rate = entry.second.complianceRate();
+    double currentRate = current->second.complianceRate();
+    if (rate != currentRate)
+        return higherRateFirst ? rate > currentRate : rate < currentRate;
+    if (entry.second.assessed() != current->second.assessed())
+        return entry.second.assessed() > current->second.assessed();
+    return entry.first < current->first;
+}
+
+// Best and worst key by compliance rate; keys with nothing assessed are skipped
+template <typename Map, typename Name>
+void rankByCompliance(const Map& groups, Name name, std::string& top, std::string& bottom) {
+    const typename Map::value_type* best = nullptr;
+    const typename Map::value_type* worst = nullptr;
+
+    for (const auto& entry : groups) {
+        if (entry.second.assessed() == 0)
+            continue;
+        if (ranksBefore(entry, best, true))
+            best = &entry;
+        if (ranksBefore(entry, worst, false))
+            worst = &entry;
+    }
+
+    if (best)
+        top = name(best->first);
+    if (worst)
+        bottom = name(worst->first);
+}
+
+} // namespace
+
+void StatusCounts::add(ComplianceStatus status) {
+    switch (status) {
+    case ComplianceStatus::Good:
+        good++;
+        break;
+    case ComplianceStatus::Medium:
+        medium++;
+        break;
+    case ComplianceStatus::Bad:
+        bad++;
+        break;
+    default:
+        missing++;
+        break;
+    }
+}
+
+void StatusCounts::merge(const StatusCounts& other) {
+    missing += other.missing;
+    good += other.good;
+    medium += other.medium;
+    bad += other.bad;
+}
+
+double StatusCounts::complianceRate() const {
+    return assessed() == 0 ? 0.0 : static_cast<double>(good) / assessed();
+}
+
+void StatsAccumulator::add(const WaterSample& sample, ComplianceStatus status) {
+    totals.add(status);
+    byLocation[sample.getLocation()].add(status);
+    byPollutant[sample.getPollutant()].add(status);
+    byYear[sample.getYearMonth() / 100].add(status);
+}
+
+void StatsAccumulator::merge(const StatsAccumulator& other) {
+    totals.merge(other.totals);
+    for (const auto& entry : other.byLocation)
+        byLocation[entry.first].merge(entry.second);
+    for (const auto& entry : other.byPollutant)
+        byPollutant[entry.first].merge(entry.second);
+    for (const auto& entry : other.byYear)
+        byYear[entry.first].merge(entry.second);
+}
+
+StatusCounts StatsAccumulator::locationCounts(const std::string& location) const {
+    auto it = byLocation.find(location);
+    return it == byLocation.end() ? StatusCounts() : it->second;
+}
+
+StatusCounts StatsAccumulator::countsWithin(const SpatialIndex& index, const SpatialArea& area) const {
+    StatusCounts counts;
+    for (const std::string& location : index.within(area))
+        counts.merge(locationCounts(location));
+    return counts;
+}
+
+size_t StatsAccumulator::approximateBytes() const {
+    size_t bytes = hashMapBytes(byLocation) + hashMapBytes(byPollutant) + nodeBytes(byYear);
+    for (const auto& entry : byLocation)
+        bytes += heapBytes(entry.first);
+    for (const auto& entry : byPollutant)
+        bytes += heapBytes(entry.first);
+    return bytes;
+}
+
+DatasetStats StatsAccumulator::result() const {
+    DatasetStats stats;
+    stats.totals = totals;
+    stats.byPollutant.insert(byPollutant.begin(), byPollutant.end());
+
+    auto keyName = [](const std::string& key) { return key; };
+    rankByCompliance(byLocation, keyName, stats.topLocation, stats.bottomLocation);
+    rankByCompliance(byPollutant, keyName, stats.topPollutant, stats.bottomPollutant);
+    rankByCompliance(byYear, [](int year) { return std::to_string(year); },
+                     stats.topYear, stats.bottomYear);
+    return stats;
+}
+
+FilterPartial filterSamples(const std::vector<WaterSample>& samples, const ComplianceRules& rules,
+                            const SampleFilter& filter, unsigned threadCount) {
+    if (threadCount == 0)
+        threadCount = threadsFor(samples.size());
+
+    std::vector<FilterPartial> partials(threadCount);
+    size_t rangeSize = (samples.size() + threadCount - 1) / threadCount;
+
+    if (threadCount == 1) {
+        reduceRange(samples, rules, filter, 0, samples.size(), partials[0]);
+    } else {
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < threadCount; ++t) {
+            size_t begin = std::min(samples.size(), t * rangeSize);
+            size_t end = std::min(samples.size(), begin + rangeSize);
+            pool.emplace_back(reduceRange, std::cref(samples), std::cref(rules), std::cref(filter),
+                              begin, end, std::ref(partials[t]));
+        }
+        for (auto& worker : pool)
+            worker.join();
+    }
+
+    FilterPartial& merged = partials[0];
+    for (unsigned t = 1; t < threadCount; ++t)
+        mergePartial(merged, partials[t]);
+
+    return std::move(merged);
+}
+
+FilterResult computeStats(const std::vector<WaterSample>& samples, const ComplianceRules& rules,
+                          const SampleFilter& filter, unsigned threadCount) {
+    FilterPartial partial = filterSamples(samples, rules, filter, threadCount);
+
+    FilterResult result;
+    result.rows = std::move(partial.rows);
+    result.statuses = std::move(partial.statuses);
+    result.stats = partial.stats.result();
+    result.accumulator = std::move(partial.stats);
+    return result;
+}
+
+void extendStats(FilterResult& result, const std::vector<WaterSample>& samples, size_t firstRow,
+                 const ComplianceRules& rules, const SampleFilter& filter) {
+    if (firstRow >= samples.size())
+        return;
+
+    FilterPartial partial;
+    reduceRange(samples, rules, filter, firstRow, samples.size(), partial);
+    result.rows.insert(result.rows.end(), partial.rows.begin(), partial.rows.end());
+    result.statuses.insert(result.statuses.end(), partial.statuses.begin(), partial.statuses.end());
+    result.accumulator.merge(partial.stats);
+    result.stats = result.accumulator.result();
+}
@@ -0,0 +1,100 @@
+#ifndef STATSENGINE_HPP
+#define STATSENGINE_HPP
+
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "WaterSample.hpp"
+#include "ComplianceRules.hpp"
+#include "SpatialIndex.hpp"
+
+// Filter selected in the dashboard combo boxes; empty / zero / nullopt means "All"
+struct SampleFilter {
+    int year = 0;
+    std::string location;
+    std::string pollutant;
+    std::optional<ComplianceStatus> status;
+    std::optional<SpatialArea> area; // Sampling points inside it only
+};
+
+struct StatusCounts {
+    int missing = 0;
+    int good = 0;
+    int medium = 0;
+    int bad = 0;
+
+    void add(ComplianceStatus status);
+    void merge(const StatusCounts& other);
+    int total() const { return missing + good + medium + bad; }
+    int assessed() const { return good + medium + bad; }
+    // Share of assessed samples that are good, 0 when nothing was assessed
+    double complianceRate() const;
+};
+
+struct DatasetStats {
+    std::string topLocation = "-";
+    std::string bottomLocation = "-";
+    std::string topYear = "-";
+    std::string bottomYear = "-";
+    std::string topPollutant = "-";
+    std::string bottomPollutant = "-";
+
+    StatusCounts totals;
+    std::map<std::string, StatusCounts> byPollutant;
+};
+
+// Status counts grouped by location, pollutant and year. Accumulators built
+// over disjoint rows can be merged, and ranked into DatasetStats at the end.
+class StatsAccumulator {
+public:
+    void add(const WaterSample& sample, ComplianceStatus status);
+    void merge(const StatsAccumulator& other);
+    DatasetStats result() const;
+    // Counts of the rows at one sampling point, or summed over the points of
+    // index inside area; neither visits the rows
+    StatusCounts locationCounts(const std::string& location) const;
+    StatusCounts countsWithin(const SpatialIndex& index, const SpatialArea& area) const;
+    size_t approximateBytes() const; // Heap bytes held, estimated
+
+private:
+    StatusCounts totals;
+    std::unordered_map<std::string, StatusCounts> byLocation;
+    std::unordered_map<std::string, StatusCounts> byPollutant;
+    std::map<int, StatusCounts> byYear;
+};
+
+// Rows of the dataset that passed the filter, in dataset order, with their status
+struct FilterResult {
+    std::vector<size_t> rows;
+    std::vector<ComplianceStatus> statuses;
+    DatasetStats stats;
+    StatsAccumulator accumulator; // stats before ranking, so rows can be added later
+};
+
+// FilterResult before ranking, so results over consecutive batches can be merged
+struct FilterPartial {
+    std::vector<size_t> rows;
+    std::vector<ComplianceStatus> statuses;
+    StatsAccumulator stats;
+};
+
+// Filters, classifies and aggregates the samples in one pass. The samples are
+// split into contiguous ranges reduced on separate threads into partial states
+// that are merged in order, so the row order of the result is stable.
+// threadCount 0 picks one per core for large inputs.
+FilterPartial filterSamples(const std::vector<WaterSample>& samples, const ComplianceRules& rules,
+                            const SampleFilter& filter, unsigned threadCount = 0);
+
+// filterSamples() followed by ranking
+FilterResult computeStats(const std::vector<WaterSample>& samples, const ComplianceRules& rules,
+                          const SampleFilter& filter, unsigned threadCount = 0);
+
+// Adds samples[firstRow..] (rows appended since result was computed over
+// samples with the same filter) to result, re-ranking its stats. Costs time
+// in the number of new rows, not the whole dataset.
+void extendStats(FilterResult& result, const std::vector<WaterSample>& samples, size_t firstRow,
+                 const ComplianceRules& rules, const SampleFilter& filter);
+
+#endif // STATSENGINE_HPP
@@ -0,0 +1,188 @@
+#include "TimeSeries.hpp"
+#include "MemoryUsage.hpp"
+#include "SampleTime.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const double GAP = std::numeric_limits<double>::quiet_NaN();
+
+// Mean of consecutive points whose bucket() is equal, with a NaN point for
+// each bucket next() steps over between two non-empty buckets
+template <typename Bucket, typename Next>
+TimeSeries resample(const TimeSeries& raw, Bucket bucket, Next next) {
+    TimeSeries result;
+    for (size_t i = 0; i < raw.size();) {
+        int64_t start = bucket(raw.times[i]);
+        if (!result.empty()) {
+            for (int64_t empty = next(result.times.back()); empty < start; empty = next(empty)) {
+                result.times.push_back(empty);
+                result.values.push_back(GAP);
+                result.counts.push_back(0);
+            }
+        }
+
+        double sum = 0.0;
+        uint32_t count = 0;
+        for (; i < raw.size() && bucket(raw.times[i]) == start; ++i) {
+            sum += raw.values[i] * raw.counts[i];
+            count += raw.counts[i];
+        }
+        result.times.push_back(start);
+        result.values.push_back(sum / count);
+        result.counts.push_back(count);
+    }
+    return result;
+}
+
+} // namespace
+
+TimeSeries rollingMean(const TimeSeries& series, int64_t windowSeconds) {
+    TimeSeries result = series;
+    double sum = 0.0;
+    uint64_t count = 0;
+    size_t first = 0;
+
+    for (size_t i = 0; i < series.size(); ++i) {
+        if (series.counts[i] > 0) {
+            sum += series.values[i] * series.counts[i];
+            count += series.counts[i];
+        }
+        while (first < i && series.times[first] <= series.times[i] - windowSeconds) {
+            if (series.counts[first] > 0) {
+                sum -= series.values[first] * series.counts[first];
+                count -= series.counts[first];
+            }
+            first++;
+        }
+        if (series.counts[i] > 0)
+            result.values[i] = sum / count;
+    }
+    return result;
+}
+
+std::vector<TimeGap> findGaps(const TimeSeries& series, int64_t minGapSeconds) {
+    std::vector<TimeGap> gaps;
+    size_t previous = series.size();
+    for (size_t i = 0; i < series.size(); ++i) {
+        if (series.counts[i] == 0)
+            continue;
+        if (previous < series.size() && series.times[i] - series.times[previous] > minGapSeconds)
+            gaps.push_back(TimeGap{series.times[previous], series.times[i]});
+        previous = i;
+    }
+    return gaps;
+}
+
+size_t TimeSeriesEngine::CacheKeyHash::operator()(const CacheKey& key) const {
+    return SeriesKeyHash()(key.series) * 31 + static_cast<size_t>(key.resolution);
+}
+
+TimeSeriesEngine::TimeSeriesEngine(const std::vector<WaterSample>& samples, size_t cacheSize)
+    : cacheSize(std::max<size_t>(1, cacheSize)) {
+    for (const WaterSample& sample : samples)
+        addPoint(sample);
+}
+
+void TimeSeriesEngine::add(const std::vector<WaterSample>& samples) {
+    for (const WaterSample& sample : samples) {
+        addPoint(sample);
+        SeriesKey key{sample.getLocation(), sample.getPollutant()};
+        for (Resolution resolution : {Resolution::Raw, Resolution::Daily, Resolution::Monthly}) {
+            auto cached = cacheIndex.find(CacheKey{key, resolution});
+            if (cached != cacheIndex.end()) {
+                cache.erase(cached->second);
+                cacheIndex.erase(cached);
+            }
+        }
+    }
+}
+
+void TimeSeriesEngine::addPoint(const WaterSample& sample) {
+    auto& points = pointsBySeries[SeriesKey{sample.getLocation(), sample.getPollutant()}];
+    int64_t time;
+    if (sampletime::parse(sample.getSampleDate(), time) && !std::isnan(sample.getLevel()))
+        points.emplace_back(time, sample.getLevel());
+}
+
+const TimeSeries& TimeSeriesEngine::series(const std::string& location, const std::string& pollutant,
+                                           Resolution resolution) const {
+    CacheKey key{SeriesKey{location, pollutant}, resolution};
+    auto cached = cacheIndex.find(key);
+    if (cached != cacheIndex.end()) {
+        cache.splice(cache.begin(), cache, cached->second);
+        return cached->second->second;
+    }
+
+    TimeSeries built = build(key.series, resolution);
+    cache.emplace_front(key, std::move(built));
+    cacheIndex[key] = cache.begin();
+    if (cache.size() > cacheSize) {
+        cacheIndex.erase(cache.back().first);
+        cache.pop_back();
+    }
+    return cache.front().second;
+}
+
+std::vector<SeriesKey> TimeSeriesEngine::keys() const {
+    std::vector<SeriesKey> result;
+    result.reserve(pointsBySeries.size());
+    for (const auto& entry : pointsBySeries)
+        result.push_back(entry.first);
+    std::sort(result.begin(), result.end(), [](const SeriesKey& a, const SeriesKey& b) {
+        return a.location != b.location ? a.location < b.location : a.pollutant < b.pollutant;
+    });
+    return result;
+}
+
+size_t TimeSeriesEngine::approximateBytes() const {
+    size_t bytes = hashMapBytes(pointsBySeries) + nodeBytes(cache) + hashMapBytes(cacheIndex);
+    for (const auto& entry : pointsBySeries)
+        bytes += heapBytes(entry.first.location) + heapBytes(entry.first.pollutant) +
+                 entry.second.capacity() * sizeof(entry.second[0]);
+    for (const auto& entry : cache) {
+        const TimeSeries& series = entry.second;
+        // The index holds a second copy of each key
+        bytes += 2 * (heapBytes(entry.first.series.location) + heapBytes(entry.first.series.pollutant)) +
+                 series.times.capacity() * sizeof(int64_t) + series.values.capacity() * sizeof(double) +
+                 series.counts.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
+
+TimeSeries TimeSeriesEngine::build(const SeriesKey& key, Resolution resolution) const {
+    if (resolution != Resolution::Raw) {
+        // Resampled from the raw series, which is cached as well
+        const TimeSeries& raw = series(key.location, key.pollutant, Resolution::Raw);
+        if (resolution == Resolution::Daily)
+            return resample(raw, sampletime::startOfDay,
+                            [](int64_t day) { return day + sampletime::SECONDS_PER_DAY; });
+        return resample(raw, sampletime::startOfMonth, [](int64_t month) { return sampletime::addMonths(month, 1); });
+    }
+
+    auto found = pointsBySeries.find(key);
+    if (found == pointsBySeries.end())
+        return TimeSeries();
+
+    std::vector<std::pair<int64_t, double>> points = found->second;
+    // Stable, so samples at the same time keep the dataset order
+    std::stable_sort(points.begin(), points.end(),
+                     [](const std::pair<int64_t, double>& a, const std::pair<int64_t, double>& b) {
+                         return a.first < b.first;
+                     });
+
+    TimeSeries raw;
+    for (size_t i = 0; i < points.size();) {
+        size_t end = i;
+        double sum = 0.0;
+        for (; end < points.size() && points[end].first == points[i].first; ++end)
+            sum += points[end].second;
+        raw.times.push_back(points[i].first);
+        raw.values.push_back(sum / static_cast<double>(end - i));
+        raw.counts.push_back(static_cast<uint32_t>(end - i));
+        i = end;
+    }
+    return raw;
+}
@@ -0,0 +1,93 @@
+#ifndef TIMESERIES_HPP
+#define TIMESERIES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "WaterSample.hpp"
+#include "DatasetAggregates.hpp"
+
+// Levels of one pollutant at one sampling point in time order. Times are
+// seconds since 1970 (see SampleTime.hpp). A NaN value marks a gap: an empty
+// bucket of a resampled series, or a break a chart should not draw across.
+struct TimeSeries {
+    std::vector<int64_t> times;
+    std::vector<double> values;
+    std::vector<uint32_t> counts; // Samples behind each point, 0 for gaps
+
+    size_t size() const { return times.size(); }
+    bool empty() const { return times.empty(); }
+};
+
+enum class Resolution {
+    Raw,    // One point per sample; samples at the same time are averaged
+    Daily,  // Mean per calendar day
+    Monthly // Mean per calendar month
+};
+
+struct TimeGap {
+    int64_t from; // Last sample before the gap
+    int64_t to;   // First sample after it
+};
+
+// Mean of the samples in (t - window, t] at every point of series, skipping
+// gaps. Gaps stay gaps.
+TimeSeries rollingMean(const TimeSeries& series, int64_t windowSeconds);
+
+// Intervals longer than minGapSeconds between consecutive samples of series
+std::vector<TimeGap> findGaps(const TimeSeries& series, int64_t minGapSeconds);
+
+// Per-site trend lines over a set of samples. The times and levels are
+// grouped by location x pollutant once, on construction; a series is sorted
+// and resampled the first time it is asked for and kept in a small LRU cache,
+// so redrawing or switching between recently viewed sites is a lookup. Not
+// thread-safe: series() updates the cache.
+class TimeSeriesEngine {
+public:
+    explicit TimeSeriesEngine(const std::vector<WaterSample>& samples, size_t cacheSize = 64);
+
+    // Adds appended samples, dropping only the cached series they belong to
+    void add(const std::vector<WaterSample>& samples);
+
+    // Series in time order; samples with a malformed date or a NaN level are
+    // left out. Empty for an unknown location x pollutant. Daily and monthly
+    // series have a NaN point for every empty bucket between the first and
+    // last. The reference stays valid until the entry is evicted, i.e. for at
+    // least the next cacheSize - 2 calls.
+    const TimeSeries& series(const std::string& location, const std::string& pollutant,
+                             Resolution resolution = Resolution::Raw) const;
+
+    std::vector<SeriesKey> keys() const; // Sorted by location, then pollutant
+    size_t approximateBytes() const;     // Heap bytes held, cached series included, estimated
+
+private:
+    struct CacheKey {
+        SeriesKey series;
+        Resolution resolution;
+
+        bool operator==(const CacheKey& other) const {
+            return resolution == other.resolution && series == other.series;
+        }
+    };
+
+    struct CacheKeyHash {
+        size_t operator()(const CacheKey& key) const;
+    };
+
+    using LruList = std::list<std::pair<CacheKey, TimeSeries>>;
+
+    TimeSeries build(const SeriesKey& key, Resolution resolution) const;
+    void addPoint(const WaterSample& sample);
+
+    // Unsorted (time, level) of every usable sample
+    std::unordered_map<SeriesKey, std::vector<std::pair<int64_t, double>>, SeriesKeyHash> pointsBySeries;
+    size_t cacheSize;
+    // Most recently used first
+    mutable LruList cache;
+    mutable std::unordered_map<CacheKey, LruList::iterator, CacheKeyHash> cacheIndex;
+};
+
+#endif // TIMESERIES_HPP
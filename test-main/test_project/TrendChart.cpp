@@ -0,0 +1,164 @@
+#include "TrendChart.hpp"
+#include "SampleTime.hpp"
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPainterPath>
+#include <QWheelEvent>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr int64_t MIN_GAP_SECONDS = 31 * sampletime::SECONDS_PER_DAY;
+constexpr double MIN_VIEW_SECONDS = 3600.0;
+constexpr double ZOOM_PER_STEP = 1.25; // One wheel notch
+
+QString dateLabel(int64_t seconds) {
+    return QString::fromStdString(sampletime::format(seconds).substr(0, 10));
+}
+
+} // namespace
+
+TrendChart::TrendChart(QWidget *parent) : QWidget(parent) {
+    setMinimumHeight(220);
+    clear("Select a location and a pollutant to plot their levels");
+}
+
+void TrendChart::setSeries(const TimeSeries& series, const QString& newTitle) {
+    pyramid = SeriesPyramid(series);
+    gaps = findGaps(series, MIN_GAP_SECONDS);
+    title = newTitle;
+    message = pyramid.empty() ? QString("No levels to plot") : QString();
+    if (!pyramid.empty())
+        setView(pyramid.firstTime(), pyramid.lastTime());
+    update();
+}
+
+void TrendChart::clear(const QString& newMessage) {
+    pyramid = SeriesPyramid();
+    gaps.clear();
+    title.clear();
+    message = newMessage;
+    update();
+}
+
+QRect TrendChart::plotArea() const {
+    return rect().adjusted(60, 24, -16, -24);
+}
+
+void TrendChart::setView(double from, double to) {
+    // Stays within the series; a single sample gets a day either side
+    double padding = pyramid.firstTime() == pyramid.lastTime() ? sampletime::SECONDS_PER_DAY : 0;
+    double first = pyramid.firstTime() - padding;
+    double last = pyramid.lastTime() + padding;
+    double span = std::clamp(to - from, std::min(MIN_VIEW_SECONDS, last - first), last - first);
+    from = std::clamp(from, first, last - span);
+    viewFrom = from;
+    viewTo = from + span;
+}
+
+void TrendChart::paintEvent(QPaintEvent *) {
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::white);
+
+    if (pyramid.empty()) {
+        painter.setPen(Qt::gray);
+        painter.drawText(rect(), Qt::AlignCenter, message);
+        return;
+    }
+
+    QRect area = plotArea();
+    if (area.width() <= 0 || area.height() <= 0)
+        return;
+
+    std::vector<SeriesPoint> points = pyramid.query(static_cast<int64_t>(std::floor(viewFrom)),
+                                                    static_cast<int64_t>(std::ceil(viewTo)), area.width());
+
+    // The value axis fits the visible points
+    double low = points.front().value;
+    double high = low;
+    for (const SeriesPoint& point : points) {
+        low = std::min(low, point.value);
+        high = std::max(high, point.value);
+    }
+    if (high - low < 1e-9) {
+        low -= 1.0;
+        high += 1.0;
+    }
+
+    auto x = [&](double time) { return area.left() + (time - viewFrom) / (viewTo - viewFrom) * area.width(); };
+    auto y = [&](double value) { return area.bottom() - (value - low) / (high - low) * area.height(); };
+
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(235, 235, 235));
+    for (const TimeGap& gap : gaps) {
+        if (gap.to < viewFrom || gap.from > viewTo)
+            continue;
+        double left = std::max<double>(x(gap.from), area.left());
+        double right = std::min<double>(x(gap.to), area.right());
+        painter.drawRect(QRectF(left, area.top(), right - left, area.height()));
+    }
+
+    painter.setPen(Qt::darkGray);
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRect(area);
+    painter.drawText(QRect(0, area.top() - 8, area.left() - 4, 16), Qt::AlignRight | Qt::AlignVCenter,
+                     QString::number(high, 'g', 4));
+    painter.drawText(QRect(0, area.bottom() - 8, area.left() - 4, 16), Qt::AlignRight | Qt::AlignVCenter,
+                     QString::number(low, 'g', 4));
+    painter.drawText(QRect(area.left(), area.bottom() + 4, area.width(), 16), Qt::AlignLeft,
+                     dateLabel(static_cast<int64_t>(viewFrom)));
+    painter.drawText(QRect(area.left(), area.bottom() + 4, area.width(), 16), Qt::AlignRight,
+                     dateLabel(static_cast<int64_t>(viewTo)));
+    painter.drawText(QRect(area.left(), 4, area.width(), 16), Qt::AlignCenter, title);
+
+    QPainterPath path;
+    path.moveTo(x(points.front().time), y(points.front().value));
+    for (size_t i = 1; i < points.size(); ++i)
+        path.lineTo(x(points[i].time), y(points[i].value));
+
+    painter.setClipRect(area);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QPen(QColor(31, 119, 180), 1.5));
+    painter.drawPath(path);
+    if (points.size() == 1)
+        painter.drawEllipse(QPointF(x(points.front().time), y(points.front().value)), 3, 3);
+}
+
+void TrendChart::wheelEvent(QWheelEvent *event) {
+    QRect area = plotArea();
+    if (pyramid.empty() || area.width() <= 0)
+        return;
+
+    // Zoom around the time under the cursor
+    double fraction = std::clamp((event->position().x() - area.left()) / area.width(), 0.0, 1.0);
+    double anchor = viewFrom + fraction * (viewTo - viewFrom);
+    double scale = std::pow(ZOOM_PER_STEP, -event->angleDelta().y() / 120.0);
+    double span = (viewTo - viewFrom) * scale;
+    setView(anchor - fraction * span, anchor + (1.0 - fraction) * span);
+    update();
+    event->accept();
+}
+
+void TrendChart::mousePressEvent(QMouseEvent *event) {
+    dragX = qRound(event->position().x());
+}
+
+void TrendChart::mouseMoveEvent(QMouseEvent *event) {
+    QRect area = plotArea();
+    if (pyramid.empty() || area.width() <= 0 || !(event->buttons() & Qt::LeftButton))
+        return;
+
+    int currentX = qRound(event->position().x());
+    double shift = (dragX - currentX) * (viewTo - viewFrom) / area.width();
+    dragX = currentX;
+    setView(viewFrom + shift, viewTo + shift);
+    update();
+}
+
+void TrendChart::mouseDoubleClickEvent(QMouseEvent *) {
+    if (pyramid.empty())
+        return;
+    setView(pyramid.firstTime(), pyramid.lastTime());
+    update();
+}
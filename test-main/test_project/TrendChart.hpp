@@ -0,0 +1,45 @@
+#ifndef TRENDCHART_HPP
+#define TRENDCHART_HPP
+
+#include <QWidget>
+#include <QString>
+#include <vector>
+#include "TimeSeries.hpp"
+#include "Downsample.hpp"
+
+// Line chart of one pollutant's levels at one sampling point. The series is
+// held as a SeriesPyramid, and each repaint draws at most about one point
+// per pixel column of the visible time range, so long histories zoom (mouse
+// wheel) and pan (drag) smoothly. Double-click shows the whole series again.
+// Sampling breaks longer than a month are shaded.
+class TrendChart : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit TrendChart(QWidget *parent = nullptr);
+
+    void setSeries(const TimeSeries& series, const QString& title);
+    void clear(const QString& message);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private:
+    QRect plotArea() const;
+    void setView(double from, double to);
+
+    SeriesPyramid pyramid;
+    std::vector<TimeGap> gaps;
+    QString title;
+    QString message;
+    // Visible time range, in seconds as doubles so zooming is smooth
+    double viewFrom = 0.0;
+    double viewTo = 0.0;
+    int dragX = 0;
+};
+
+#endif // TRENDCHART_HPP
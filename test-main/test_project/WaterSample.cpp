@@ -11,6 +11,20 @@ int WaterSample::getYear() const {
     return std::stoi(sampleDate.substr(0, 4));
 }
 
+int WaterSample::getYearMonth() const {
+    // Parsed by hand so malformed dates do not throw like std::stoi
+    if (sampleDate.size() < 7 || sampleDate[4] != '-')
+        return 0;
+
+    int yearMonth = 0;
+    for (size_t i : {0, 1, 2, 3, 5, 6}) {
+        if (sampleDate[i] < '0' || sampleDate[i] > '9')
+            return 0;
+        yearMonth = yearMonth * 10 + (sampleDate[i] - '0');
+    }
+    return yearMonth;
+}
+
 const std::string& WaterSample::getLocation() const {
     return location;
 }
@@ -35,6 +49,14 @@ const std::string& WaterSample::getSampleDate() const {
     return sampleDate;
 }
 
+double WaterSample::getEasting() const {
+    return easting;
+}
+
+double WaterSample::getNorthing() const {
+    return northing;
+}
+
 // Setters
 void WaterSample::setLocation(const std::string& location) {
     this->location = location;
@@ -59,3 +81,8 @@ void WaterSample::setComplianceStatus(const std::string& complianceStatus) {
 void WaterSample::setSampleDate(const std::string& sampleDate) {
     this->sampleDate = sampleDate;
 }
+
+void WaterSample::setPosition(double easting, double northing) {
+    this->easting = easting;
+    this->northing = northing;
+}
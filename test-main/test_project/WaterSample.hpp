@@ -1,6 +1,7 @@
 #ifndef WATERSAMPLE_HPP
 #define WATERSAMPLE_HPP
 
+#include <limits>
 #include <string>
 
 class WaterSample {
@@ -11,12 +12,17 @@ public:
 
     // Getters
     int getYear() const;
+    int getYearMonth() const; // YYYYMM, 0 when the date is malformed
     const std::string& getLocation() const;
     const std::string& getPollutant() const;
     double getLevel() const;
     const std::string& getUnit() const;
     const std::string& getComplianceStatus() const;
     const std::string& getSampleDate() const;
+    // Sampling point position on the British National Grid in metres, NaN
+    // when the export has none
+    double getEasting() const;
+    double getNorthing() const;
 
     // Setters (optional, if modification is needed)
     void setLocation(const std::string& location);
@@ -25,6 +31,7 @@ public:
     void setUnit(const std::string& unit);
     void setComplianceStatus(const std::string& complianceStatus); // Use const reference
     void setSampleDate(const std::string& sampleDate);
+    void setPosition(double easting, double northing);
 
 private:
     // Member variables
@@ -34,6 +41,8 @@ private:
     std::string unit;
     std::string complianceStatus;
     std::string sampleDate;
+    double easting = std::numeric_limits<double>::quiet_NaN();
+    double northing = std::numeric_limits<double>::quiet_NaN();
 };
 
 #endif // WATERSAMPLE_HPP
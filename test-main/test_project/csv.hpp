@@ -45,6 +45,20 @@ SOFTWARE.
 #include <string>
 #include <vector>
 
+// Vector instructions used to scan for structural characters,
+// define CSV_NO_SIMD to force the scalar fallback
+#if !defined(CSV_NO_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#define CSV_AVX2
+#elif !defined(CSV_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define CSV_SSE2
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 /* Copyright 2017 https://github.com/mandreyel
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy of this
@@ -1802,6 +1816,7 @@ using shared_ummap_sink = basic_shared_mmap_sink<unsigned char>;
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <condition_variable>
 #include <deque>
 #include <fstream>
@@ -4791,6 +4806,9 @@ namespace csv {
          */
         constexpr size_t ITERATION_CHUNK_SIZE = 10000000; // 10MB
 
+        /** Smallest chunk size accepted by CSVFormat::chunk_size() */
+        constexpr size_t MIN_CHUNK_SIZE = 65536; // 64KB
+
         template<typename T>
         inline bool is_equal(T a, T b, T epsilon = 0.001) {
             /** Returns true if two floating point values are about the same */
@@ -4985,6 +5003,37 @@ namespace csv {
             return *this;
         }
 
+        /** Sets how many bytes are parsed at a time
+         *
+         *  @note Every row must fit in a single chunk
+         *  @throws `std::runtime_error` thrown if bytes is smaller than csv::internals::MIN_CHUNK_SIZE
+         */
+        CSVFormat& chunk_size(size_t bytes);
+
+        /** Sets how many parsed rows may be queued ahead of the reader
+         *  before parsing pauses, 0 restores the default
+         */
+        CSVFormat& read_ahead(size_t rows) {
+            this->read_ahead_rows = rows;
+            return *this;
+        }
+
+        /** Parse on a background thread (default) or on the thread reading rows */
+        CSVFormat& threading(bool use_threads) {
+            this->use_threads = use_threads;
+            return *this;
+        }
+
+        /** Let CSVReader pick the chunk size, read-ahead and threading
+         *  from the size of the input, its row length and the number of cores
+         *
+         *  @note Overrides chunk_size(), read_ahead() and threading()
+         */
+        CSVFormat& auto_tune(bool enabled = true) {
+            this->tune = enabled;
+            return *this;
+        }
+
         #ifndef DOXYGEN_SHOULD_SKIP_THIS
         char get_delim() const {
             // This error should never be received by end users.
@@ -5001,6 +5050,10 @@ namespace csv {
         std::vector<char> get_possible_delims() const { return this->possible_delimiters; }
         std::vector<char> get_trim_chars() const { return this->trim_chars; }
         CONSTEXPR VariableColumnPolicy get_variable_column_policy() const { return this->variable_column_policy; }
+        CONSTEXPR size_t get_chunk_size() const { return this->chunk_bytes; }
+        CONSTEXPR size_t get_read_ahead() const { return this->read_ahead_rows; }
+        CONSTEXPR bool is_threaded() const { return this->use_threads; }
+        CONSTEXPR bool is_auto_tuned() const { return this->tune; }
         #endif
         
         /** CSVFormat for guessing the delimiter */
@@ -5044,6 +5097,18 @@ namespace csv {
 
         /**< Allow variable length columns? */
         VariableColumnPolicy variable_column_policy = VariableColumnPolicy::IGNORE_ROW;
+
+        /**< Bytes parsed at a time */
+        size_t chunk_bytes = internals::ITERATION_CHUNK_SIZE;
+
+        /**< Parsed rows allowed to queue up ahead of the reader, 0 for the default */
+        size_t read_ahead_rows = 0;
+
+        /**< Parse on a background thread? */
+        bool use_threads = true;
+
+        /**< Pick the settings above from the input? */
+        bool tune = false;
     };
 }
 /** @file
@@ -5470,9 +5535,11 @@ namespace csv {
             CSVFieldList(CSVFieldList&& other) :
                 _single_buffer_capacity(other._single_buffer_capacity) {
 
-                for (auto&& buffer : other.buffers) {
-                    this->buffers.emplace_back(std::move(buffer));
-                }
+                this->buffers = std::move(other.buffers);
+                this->_tables = std::move(other._tables);
+                this->_table.store(other._table.load(std::memory_order_acquire), std::memory_order_relaxed);
+                this->_table_capacity = other._table_capacity;
+                this->_blocks_used = other._blocks_used;
 
                 _current_buffer_size = other._current_buffer_size;
                 _back = other._back;
@@ -5489,7 +5556,17 @@ namespace csv {
             }
 
             size_t size() const noexcept {
-                return this->_current_buffer_size + ((this->buffers.size() - 1) * this->_single_buffer_capacity);
+                return this->_current_buffer_size + ((this->_blocks_used - 1) * this->_single_buffer_capacity);
+            }
+
+            /** Remove all fields but keep the allocated blocks for reuse
+             *
+             *  @note Must not be called while another thread may read the list
+             */
+            void clear() noexcept {
+                this->_blocks_used = 1;
+                this->_current_buffer_size = 0;
+                this->_back = this->buffers.front().get();
             }
 
             RawCSVField& operator[](size_t n) const;
@@ -5497,14 +5574,22 @@ namespace csv {
         private:
             const size_t _single_buffer_capacity;
 
+            /** Owned blocks of fields, only touched by the writing thread */
+            std::vector<std::unique_ptr<RawCSVField[]>> buffers = {};
+
             /**
-             * Prefer std::deque over std::vector because it does not
-             * reallocate upon expansion, allowing pointers to its members
-             * to remain valid & avoiding potential race conditions when 
-             * CSVFieldList is accesssed simulatenously by a reading thread and
-             * a writing thread
+             * Block tables read by operator[]. The writing thread appends blocks
+             * while a reading thread indexes rows it has already received, so a
+             * full table is copied into a larger one and published atomically
+             * instead of being reallocated. Retired tables are kept alive until
+             * the list is destroyed because a reader may still hold them.
              */
-            std::deque<std::unique_ptr<RawCSVField[]>> buffers = {};
+            std::vector<std::unique_ptr<RawCSVField*[]>> _tables = {};
+            std::atomic<RawCSVField**> _table = { nullptr };
+            size_t _table_capacity = 0;
+
+            /** Number of blocks holding fields, blocks past this are kept by clear() */
+            size_t _blocks_used = 0;
 
             /** Number of items in the current buffer */
             size_t _current_buffer_size = 0;
@@ -5518,22 +5603,100 @@ namespace csv {
 
         /** A class for storing raw CSV data and associated metadata */
         struct RawCSVData {
+            /** Owner of the memory viewed by data, e.g. a memory map */
             std::shared_ptr<void> _data = nullptr;
+
+            /** Chunk contents for parsers which copy their input, kept across reuse */
+            std::string buffer;
+
             csv::string_view data = "";
 
             internals::CSVFieldList fields;
 
             std::unordered_set<size_t> has_double_quotes = {};
 
-            // TODO: Consider replacing with a more thread-safe structure
+            /** Unescaped copies of double quoted fields, filled lazily by CSVRow::get_field() */
             std::unordered_map<size_t, std::string> double_quote_fields = {};
 
+            /** Guards double_quote_fields, which may be filled from several threads
+             *  (e.g. CSVStat workers) reading rows of the same chunk
+             */
+            std::mutex double_quote_fields_lock;
+
             internals::ColNamesPtr col_names = nullptr;
             internals::ParseFlagMap parse_flags;
             internals::WhitespaceMap ws_flags;
+
+            /** Drop this chunk's contents while keeping allocated memory */
+            void reset() {
+                _data = nullptr;
+                buffer.clear();
+                data = "";
+                fields.clear();
+                has_double_quotes.clear();
+                double_quote_fields.clear();
+                col_names = nullptr;
+            }
         };
 
         using RawCSVDataPtr = std::shared_ptr<RawCSVData>;
+
+        /** Recycles the RawCSVData chunks created by a parser.
+         *
+         *  Chunks handed out by acquire() come back here instead of being freed once
+         *  the last CSVRow referencing them is destroyed. Their field blocks and read
+         *  buffer keep their capacity, so streaming through a large file settles on a
+         *  few chunks rather than allocating fresh ones. Outstanding chunks keep the
+         *  arena alive, as rows may outlive the parser.
+         */
+        class RawCSVDataArena : public std::enable_shared_from_this<RawCSVDataArena> {
+        public:
+            /** @param[in] max_idle Number of released chunks to keep for reuse */
+            RawCSVDataArena(size_t max_idle = 2) : _max_idle(max_idle) {}
+
+            RawCSVDataArena(const RawCSVDataArena&) = delete;
+            RawCSVDataArena& operator=(const RawCSVDataArena&) = delete;
+
+            ~RawCSVDataArena() {
+                for (auto chunk : this->_idle)
+                    delete chunk;
+            }
+
+            RawCSVDataPtr acquire() {
+                RawCSVData* chunk = nullptr;
+                {
+                    std::lock_guard<std::mutex> lock{ this->_lock };
+                    if (!this->_idle.empty()) {
+                        chunk = this->_idle.back();
+                        this->_idle.pop_back();
+                    }
+                }
+
+                if (!chunk)
+                    chunk = new RawCSVData();
+
+                auto arena = this->shared_from_this();
+                return RawCSVDataPtr(chunk, [arena](RawCSVData* released) { arena->release(released); });
+            }
+
+        private:
+            void release(RawCSVData* chunk) {
+                chunk->reset();
+                {
+                    std::lock_guard<std::mutex> lock{ this->_lock };
+                    if (this->_idle.size() < this->_max_idle) {
+                        this->_idle.push_back(chunk);
+                        return;
+                    }
+                }
+
+                delete chunk;
+            }
+
+            const size_t _max_idle;
+            std::vector<RawCSVData*> _idle;
+            std::mutex _lock;
+        };
     }
 
     /**
@@ -5918,6 +6081,143 @@ namespace csv {
             return make_ws_flags(flags.data(), flags.size());
         }
 
+        /** Finds bytes which may change the parser state (delimiter, quote, CR and LF)
+         *  so runs of plain field data can be skipped without classifying each byte.
+         *
+         *  @par Implementation
+         *  The input is split into aligned 64-byte windows. Each window is classified
+         *  into a 64-bit mask with one bit per structural byte, using AVX2 (2 x 32 bytes)
+         *  or SSE2 (4 x 16 bytes) compares when the compiler targets them, and a scalar
+         *  loop otherwise. The mask of the current window is kept between calls, so
+         *  consecutive short fields share a single classification pass.
+         */
+        class StructuralScanner {
+        public:
+            StructuralScanner() = default;
+
+            /** If no_quote is set, pass the delimiter as the quote character */
+            StructuralScanner(char delim, char quote) : _delim(delim), _quote(quote) {}
+
+            /** Create a scanner for the delimiter and quote character marked in parse_flags */
+            static StructuralScanner from_parse_flags(const ParseFlagMap& parse_flags) noexcept {
+                char delim = ',', quote = '\0';
+                bool has_quote = false;
+                for (int i = -128; i < 128; i++) {
+                    const ParseFlags flag = parse_flags[i + 128];
+                    if (flag == ParseFlags::DELIMITER)
+                        delim = (char)i;
+                    else if (flag == ParseFlags::QUOTE) {
+                        quote = (char)i;
+                        has_quote = true;
+                    }
+                }
+
+                return StructuralScanner(delim, has_quote ? quote : delim);
+            }
+
+            /** Forget the cached window, must be called whenever the input changes */
+            void reset() noexcept { this->_window = nullptr; }
+
+            /** @returns The position of the first structural byte in
+             *           [pos, size), or size if there is none
+             */
+            size_t find(const char* data, size_t pos, size_t size) noexcept {
+                while (pos < size) {
+                    const char* window = data + (pos & ~size_t(63));
+                    if (window != this->_window) {
+                        this->_window = window;
+                        this->_mask = this->classify(window, (size_t)(data + size - window));
+                    }
+
+                    const uint64_t mask = this->_mask & (~uint64_t(0) << (pos & 63));
+                    if (mask)
+                        return (size_t)(window - data) + count_trailing_zeros(mask);
+
+                    pos = (pos | 63) + 1;
+                }
+
+                return size;
+            }
+
+        private:
+            char _delim = ',';
+            char _quote = '"';
+            const char* _window = nullptr;
+            uint64_t _mask = 0;
+
+            static unsigned count_trailing_zeros(uint64_t mask) noexcept {
+#if defined(_MSC_VER) && defined(_M_X64)
+                unsigned long idx;
+                _BitScanForward64(&idx, mask);
+                return (unsigned)idx;
+#elif defined(__GNUC__) || defined(__clang__)
+                return (unsigned)__builtin_ctzll(mask);
+#else
+                unsigned idx = 0;
+                while (!(mask & 1)) {
+                    mask >>= 1;
+                    idx++;
+                }
+                return idx;
+#endif
+            }
+
+            /** Classify up to 64 bytes starting at window, bit i is set if window[i] is structural */
+            uint64_t classify(const char* window, size_t available) const noexcept {
+                if (available < 64) {
+                    uint64_t mask = 0;
+                    for (size_t i = 0; i < available; i++) {
+                        const char ch = window[i];
+                        if (ch == _delim || ch == _quote || ch == '\r' || ch == '\n')
+                            mask |= uint64_t(1) << i;
+                    }
+
+                    return mask;
+                }
+
+#if defined(CSV_AVX2)
+                const __m256i delim = _mm256_set1_epi8(_delim), quote = _mm256_set1_epi8(_quote),
+                    cr = _mm256_set1_epi8('\r'), lf = _mm256_set1_epi8('\n');
+
+                uint64_t mask = 0;
+                for (size_t i = 0; i < 64; i += 32) {
+                    const __m256i in = _mm256_loadu_si256((const __m256i*)(window + i));
+                    const __m256i hits = _mm256_or_si256(
+                        _mm256_or_si256(_mm256_cmpeq_epi8(in, delim), _mm256_cmpeq_epi8(in, quote)),
+                        _mm256_or_si256(_mm256_cmpeq_epi8(in, cr), _mm256_cmpeq_epi8(in, lf))
+                    );
+                    mask |= (uint64_t)(uint32_t)_mm256_movemask_epi8(hits) << i;
+                }
+
+                return mask;
+#elif defined(CSV_SSE2)
+                const __m128i delim = _mm_set1_epi8(_delim), quote = _mm_set1_epi8(_quote),
+                    cr = _mm_set1_epi8('\r'), lf = _mm_set1_epi8('\n');
+
+                uint64_t mask = 0;
+                for (size_t i = 0; i < 64; i += 16) {
+                    const __m128i in = _mm_loadu_si128((const __m128i*)(window + i));
+                    const __m128i hits = _mm_or_si128(
+                        _mm_or_si128(_mm_cmpeq_epi8(in, delim), _mm_cmpeq_epi8(in, quote)),
+                        _mm_or_si128(_mm_cmpeq_epi8(in, cr), _mm_cmpeq_epi8(in, lf))
+                    );
+                    mask |= (uint64_t)(uint16_t)_mm_movemask_epi8(hits) << i;
+                }
+
+                return mask;
+#else
+                uint64_t mask = 0;
+                for (size_t i = 0; i < 64; i++) {
+                    const char ch = window[i];
+                    if (ch == _delim || ch == _quote || ch == '\r' || ch == '\n')
+                        mask |= uint64_t(1) << i;
+                }
+
+                return mask;
+#endif
+            }
+        };
+
         CSV_INLINE size_t get_file_size(csv::string_view filename);
 
         CSV_INLINE std::string get_csv_head(csv::string_view filename);
@@ -5925,104 +6225,221 @@ namespace csv {
         /** Read the first 500KB of a CSV file */
         CSV_INLINE std::string get_csv_head(csv::string_view filename, size_t file_size);
 
-        /** A std::deque wrapper which allows multiple read and write threads to concurrently
-         *  access it along with providing read threads the ability to wait for the deque
-         *  to become populated
+        /** A bounded single-producer/single-consumer queue used to hand rows from the
+         *  parsing thread to the reading thread.
+         *
+         *  @par Implementation
+         *  Items are moved in blocks of `block_size`: the producer fills a private block
+         *  and publishes it into a ring of `capacity` slots, the consumer takes a whole
+         *  block at a time. Drained block buffers are swapped back into the ring so their
+         *  capacity is reused. Publishing and taking a block only touch the two atomic
+         *  ring indices; the mutex and condition variable are used solely to sleep when
+         *  the ring is full (producer) or empty (consumer).
+         *
+         *  @par Backpressure
+         *  While a consumer is listening (between notify_all() and kill_all()) a full
+         *  ring blocks the producer, so parsing cannot run unboundedly ahead of reading.
+         *  Otherwise the producer is the only thread touching the ring, which then grows
+         *  instead, e.g. when a CSV head is parsed synchronously.
          */
         template<typename T>
-        class ThreadSafeDeque {
+        class SPSCRing {
         public:
-            ThreadSafeDeque(size_t notify_size = 100) : _notify_size(notify_size) {};
-            ThreadSafeDeque(const ThreadSafeDeque& other) {
-                this->data = other.data;
-                this->_notify_size = other._notify_size;
+            /** Number of items moved between threads at a time by default */
+            static constexpr size_t DEFAULT_BLOCK_SIZE = 512;
+
+            SPSCRing(size_t capacity = 64, size_t block_size = DEFAULT_BLOCK_SIZE) :
+                _slots(capacity < 2 ? 2 : capacity), _block_size(block_size < 1 ? 1 : block_size) {
+                this->_producer_block.reserve(this->_block_size);
             }
 
-            ThreadSafeDeque(const std::deque<T>& source) : ThreadSafeDeque() {
-                this->data = source;
+            SPSCRing(const SPSCRing&) = delete;
+            SPSCRing& operator=(const SPSCRing&) = delete;
+
+            /** @name Producer Interface */
+            ///@{
+            void push_back(T&& item) {
+                if (this->_abandoned.load(std::memory_order_relaxed)) return;
+
+                this->_producer_block.push_back(std::move(item));
+                if (this->_producer_block.size() >= this->_block_size) {
+                    this->flush();
+                }
             }
 
-            void clear() noexcept { this->data.clear(); }
+            /** Publish a partially filled block */
+            void flush() {
+                if (this->_producer_block.empty()) return;
+
+                const size_t tail = this->_tail.load(std::memory_order_relaxed);
+                if (tail - this->_head.load(std::memory_order_acquire) == this->_slots.size()) {
+                    if (this->is_waitable()) {
+                        this->wait_for([this, tail] {
+                            return tail - this->_head.load() < this->_slots.size()
+                                || this->_abandoned.load();
+                        });
+                    }
+                    else {
+                        this->grow();
+                    }
+                }
 
-            bool empty() const noexcept {
-                return this->data.empty();
+                if (this->_abandoned.load()) {
+                    this->_producer_block.clear();
+                    return;
+                }
+
+                // Hand the block over and take back a recycled buffer
+                const size_t tail_now = this->_tail.load(std::memory_order_relaxed);
+                std::swap(this->_slots[tail_now % this->_slots.size()], this->_producer_block);
+                this->_producer_block.clear();
+                this->_tail.store(tail_now + 1);
+                this->wake();
             }
 
-            T& front() noexcept {
-                return this->data.front();
+            /** Tell listeners that this queue is actively being pushed to */
+            void notify_all() {
+                this->_is_waitable.store(true);
             }
 
-            T& operator[](size_t n) {
-                return this->data[n];
+            /** Publish any remaining items and tell all listeners to stop */
+            void kill_all() {
+                this->flush();
+                this->_is_waitable.store(false);
+                this->wake();
             }
+            ///@}
 
-            void push_back(T&& item) {
-                std::lock_guard<std::mutex> lock{ this->_lock };
-                this->data.push_back(std::move(item));
+            /** @name Consumer Interface */
+            ///@{
+            /** Returns true if no item is available right now */
+            bool empty() noexcept {
+                return this->_consumer_pos == this->_consumer_block.size() && !this->take_block();
+            }
 
-                if (this->size() >= _notify_size) {
-                    this->_cond.notify_all();
-                }
+            /** @pre `!empty()` */
+            T& front() noexcept {
+                return this->_consumer_block[this->_consumer_pos];
             }
 
+            /** @pre `!empty()` */
             T pop_front() noexcept {
-                std::lock_guard<std::mutex> lock{ this->_lock };
-                T item = std::move(data.front());
-                data.pop_front();
-                return item;
+                return std::move(this->_consumer_block[this->_consumer_pos++]);
             }
 
-            size_t size() const noexcept { return this->data.size(); }
+            /** Returns true if a thread is actively pushing items to this queue */
+            bool is_waitable() const noexcept { return this->_is_waitable.load(); }
 
-            /** Returns true if a thread is actively pushing items to this deque */
-            constexpr bool is_waitable() const noexcept { return this->_is_waitable; }
+            /** Returns true once the consumer has stopped listening */
+            bool is_abandoned() const noexcept { return this->_abandoned.load(); }
 
-            /** Wait for an item to become available */
+            /** Wait for an item to become available or for the producer to stop */
             void wait() {
-                if (!is_waitable()) {
-                    return;
-                }
+                if (!this->empty()) return;
 
-                std::unique_lock<std::mutex> lock{ this->_lock };
-                this->_cond.wait(lock, [this] { return this->size() >= _notify_size || !this->is_waitable(); });
-                lock.unlock();
+                this->wait_for([this] {
+                    return this->_head.load(std::memory_order_relaxed) != this->_tail.load()
+                        || !this->is_waitable();
+                });
             }
 
-            typename std::deque<T>::iterator begin() noexcept {
-                return this->data.begin();
+            /** Stop consuming: pending and future items are dropped and a producer
+             *  blocked on a full ring is released
+             */
+            void abandon() {
+                this->_abandoned.store(true);
+                this->wake();
             }
+            ///@}
 
-            typename std::deque<T>::iterator end() noexcept {
-                return this->data.end();
+            /** Drop all items. Only safe while no producer is active. */
+            void clear() noexcept {
+                for (auto& slot : this->_slots) slot.clear();
+                this->_producer_block.clear();
+                this->_consumer_block.clear();
+                this->_consumer_pos = 0;
+                this->_head.store(0);
+                this->_tail.store(0);
             }
 
-            /** Tell listeners that this deque is actively being pushed to */
-            void notify_all() {
-                std::unique_lock<std::mutex> lock{ this->_lock };
-                this->_is_waitable = true;
-                this->_cond.notify_all();
+        private:
+            using Block = std::vector<T>;
+
+            /** Move the next published block into the consumer's buffer */
+            bool take_block() noexcept {
+                const size_t head = this->_head.load(std::memory_order_relaxed);
+                if (head == this->_tail.load(std::memory_order_acquire)) return false;
+
+                this->_consumer_block.clear();
+                this->_consumer_pos = 0;
+                std::swap(this->_consumer_block, this->_slots[head % this->_slots.size()]);
+                this->_head.store(head + 1);
+                this->wake();
+                return true;
             }
 
-            /** Tell all listeners to stop */
-            void kill_all() {
-                std::unique_lock<std::mutex> lock{ this->_lock };
-                this->_is_waitable = false;
-                this->_cond.notify_all();
+            /** Double the ring. Only called when no consumer is listening. */
+            void grow() {
+                std::vector<Block> grown(this->_slots.size() * 2);
+                const size_t head = this->_head.load(), tail = this->_tail.load();
+                for (size_t i = head; i < tail; i++)
+                    grown[i - head] = std::move(this->_slots[i % this->_slots.size()]);
+
+                this->_slots = std::move(grown);
+                this->_head.store(0);
+                this->_tail.store(tail - head);
             }
 
-        private:
-            bool _is_waitable = false;
-            size_t _notify_size;
+            /** Sleep until ready() holds. The waiter's _waiters++ then load in
+             *  ready() and the other side's store then _waiters.load() in wake()
+             *  must all be seq_cst: with weaker loads each side may miss the
+             *  other's store, and the waiter sleeps with nobody to wake it.
+             */
+            template<typename Pred>
+            void wait_for(Pred ready) {
+                this->_waiters++;
+                {
+                    std::unique_lock<std::mutex> lock{ this->_lock };
+                    this->_cond.wait(lock, ready);
+                }
+                this->_waiters--;
+            }
+
+            /** Wake the other side if it is sleeping; called after a seq_cst store
+             *  the sleeper waits for (see wait_for())
+             */
+            void wake() {
+                if (this->_waiters.load() > 0) {
+                    std::lock_guard<std::mutex> lock{ this->_lock };
+                    this->_cond.notify_all();
+                }
+            }
+
+            std::vector<Block> _slots;
+            const size_t _block_size;
+
+            /** Number of blocks taken by the consumer */
+            alignas(64) std::atomic<size_t> _head{ 0 };
+
+            /** Number of blocks published by the producer */
+            alignas(64) std::atomic<size_t> _tail{ 0 };
+
+            alignas(64) Block _producer_block;
+            Block _consumer_block;
+            size_t _consumer_pos = 0;
+
+            std::atomic<bool> _is_waitable{ false };
+            std::atomic<bool> _abandoned{ false };
+            std::atomic<int> _waiters{ 0 };
             std::mutex _lock;
             std::condition_variable _cond;
-            std::deque<T> data;
         };
 
         constexpr const int UNINITIALIZED_FIELD = -1;
     }
 
-    /** Standard type for storing collection of rows */
-    using RowCollection = internals::ThreadSafeDeque<CSVRow>;
+    /** Standard type for handing parsed rows to a reader */
+    using RowCollection = internals::SPSCRing<CSVRow>;
 
     namespace internals {
         /** Abstract base class which provides CSV parsing logic.
@@ -6036,7 +6453,8 @@ namespace csv {
             IBasicCSVParser() = default;
             IBasicCSVParser(const CSVFormat&, const ColNamesPtr&);
             IBasicCSVParser(const ParseFlagMap& parse_flags, const WhitespaceMap& ws_flags
-            ) : _parse_flags(parse_flags), _ws_flags(ws_flags) {};
+            ) : _parse_flags(parse_flags), _ws_flags(ws_flags),
+                _scanner(StructuralScanner::from_parse_flags(parse_flags)) {};
 
             virtual ~IBasicCSVParser() {}
 
@@ -6067,6 +6485,7 @@ namespace csv {
             ///@{
             CSVRow current_row;
             RawCSVDataPtr data_ptr = nullptr;
+            std::shared_ptr<RawCSVDataArena> _arena = std::make_shared<RawCSVDataArena>();
             ColNamesPtr _col_names = nullptr;
             CSVFieldList* fields = nullptr;
             int field_start = UNINITIALIZED_FIELD;
@@ -6078,14 +6497,15 @@ namespace csv {
 
             /** @name Current Stream/File State */
             ///@{
-            bool _eof = false;
+            /** Set by the parsing thread, read by the reading thread */
+            std::atomic<bool> _eof{ false };
 
             /** The size of the incoming CSV */
             size_t source_size = 0;
             ///@}
 
-            /** Whether or not source needs to be read in chunks */
-            CONSTEXPR bool no_chunk() const { return this->source_size < ITERATION_CHUNK_SIZE; }
+            /** Whether or not the whole source fits in a chunk of `bytes` */
+            CONSTEXPR bool no_chunk(size_t bytes) const { return this->source_size < bytes; }
 
             /** Parse the current chunk of data *
              *
@@ -6100,6 +6520,10 @@ namespace csv {
              *  be trimmed
              */
             WhitespaceMap _ws_flags;
+
+            /** Locates delimiters, quotes and newlines for parse_field() */
+            StructuralScanner _scanner;
+
             bool quote_escape = false;
             bool field_has_double_quote = false;
 
@@ -6138,8 +6562,6 @@ namespace csv {
          */
         template<typename TStream>
         class StreamParser: public IBasicCSVParser {
-            using RowCollection = ThreadSafeDeque<CSVRow>;
-
         public:
             StreamParser(TStream& source,
                 const CSVFormat& format,
@@ -6159,8 +6581,10 @@ namespace csv {
             void next(size_t bytes = ITERATION_CHUNK_SIZE) override {
                 if (this->eof()) return;
 
+                // Reset parser state: a field cut off by the last chunk is parsed again
+                this->field_start = UNINITIALIZED_FIELD;
+                this->field_length = 0;
                 this->reset_data_ptr();
-                this->data_ptr->_data = std::make_shared<std::string>();
 
                 if (source_size == 0) {
                     const auto start = _source.tellg();
@@ -6171,22 +6595,22 @@ namespace csv {
                     source_size = end - start;
                 }
 
-                // Read data into buffer
+                // Read data straight into the chunk's (possibly recycled) buffer
                 size_t length = std::min(source_size - stream_pos, bytes);
-                std::unique_ptr<char[]> buff(new char[length]);
+                auto& buffer = this->data_ptr->buffer;
+                buffer.resize(length);
                 _source.seekg(stream_pos, std::ios::beg);
-                _source.read(buff.get(), length);
+                _source.read(&buffer[0], length);
                 stream_pos = _source.tellg();
-                ((std::string*)(this->data_ptr->_data.get()))->assign(buff.get(), length);
 
                 // Create string_view
-                this->data_ptr->data = *((std::string*)this->data_ptr->_data.get());
+                this->data_ptr->data = csv::string_view(buffer.data(), buffer.size());
 
                 // Parse
                 this->current_row = CSVRow(this->data_ptr);
                 size_t remainder = this->parse();
 
-                if (stream_pos == source_size || no_chunk()) {
+                if (stream_pos == source_size || no_chunk(bytes)) {
                     this->_eof = true;
                     this->end_feed();
                 }
@@ -6211,12 +6635,14 @@ namespace csv {
          */
         class MmapParser : public IBasicCSVParser {
         public:
+            /** Parses the first source_size bytes of filename */
             MmapParser(csv::string_view filename,
                 const CSVFormat& format,
-                const ColNamesPtr& col_names = nullptr
+                const ColNamesPtr& col_names,
+                size_t source_size
             ) : IBasicCSVParser(format, col_names) {
                 this->_filename = filename.data();
-                this->source_size = get_file_size(filename);
+                this->source_size = source_size;
             };
 
             ~MmapParser() {}
@@ -6226,6 +6652,27 @@ namespace csv {
         private:
             std::string _filename;
             size_t mmap_pos = 0;
+
+            /** Tell the kernel this window is read front to back, and start
+             *  reading in the next window while this one is parsed
+             */
+            void advise(const mio::basic_mmap_source<char>& window, size_t bytes) const noexcept {
+#if !defined(_WIN32)
+                if (window.mapped_length() == 0) return;
+
+                void* start = (void*)(window.data() - window.mapping_offset());
+                ::madvise(start, window.mapped_length(), MADV_SEQUENTIAL);
+                ::madvise(start, window.mapped_length(), MADV_WILLNEED);
+#if defined(__linux__)
+                if (this->mmap_pos < this->source_size)
+                    ::posix_fadvise(window.file_handle(), (off_t)this->mmap_pos,
+                        (off_t)std::min(bytes, this->source_size - this->mmap_pos), POSIX_FADV_WILLNEED);
+#endif
+#else
+                (void)window;
+                (void)bytes;
+#endif
+            }
         };
     }
 }
@@ -6319,6 +6766,11 @@ namespace csv {
          ///@{
         CSVReader(csv::string_view filename, CSVFormat format = CSVFormat::guess_csv());
 
+        /** Reads only the first source_size bytes of filename, e.g. the lines
+         *  complete so far of a file that is still being appended to
+         */
+        CSVReader(csv::string_view filename, CSVFormat format, size_t source_size);
+
         /** Allows parsing stream sources such as `std::stringstream` or `std::ifstream`
          *
          *  @tparam TStream An input stream deriving from `std::istream`
@@ -6335,6 +6787,16 @@ namespace csv {
 
             this->parser = std::unique_ptr<Parser>(
                 new Parser(source, format, col_names)); // For C++11
+
+            if (this->_format.tune) {
+                const auto start = source.tellg();
+                source.seekg(0, std::ios::end);
+                const auto end = source.tellg();
+                source.seekg(start, std::ios::beg);
+                this->tune(start < 0 || end < start ? 0 : (size_t)(end - start), "");
+            }
+
+            this->apply_read_ahead();
             this->initial_read();
         }
         ///@}
@@ -6345,6 +6807,8 @@ namespace csv {
         CSVReader& operator=(CSVReader&& other) = default;
         ~CSVReader() {
             if (this->read_csv_worker.joinable()) {
+                // Release a parser blocked on a full queue
+                if (this->records) this->records->abandon();
                 this->read_csv_worker.join();
             }
         }
@@ -6408,7 +6872,7 @@ namespace csv {
         std::unique_ptr<internals::IBasicCSVParser> parser = nullptr;
 
         /** Queue of parsed CSV rows */
-        std::unique_ptr<RowCollection> records{new RowCollection(100)};
+        std::unique_ptr<RowCollection> records{new RowCollection()};
 
         size_t n_cols = 0;  /**< The number of columns in this CSV */
         size_t _n_rows = 0; /**< How many rows (minus header) have been read so far */
@@ -6416,6 +6880,8 @@ namespace csv {
         /** @name Multi-Threaded File Reading Functions */
         ///@{
         bool read_csv(size_t bytes = internals::ITERATION_CHUNK_SIZE);
+        static bool read_csv(internals::IBasicCSVParser& parser, RowCollection& records, size_t bytes);
+        static void read_csv_ahead(internals::IBasicCSVParser& parser, RowCollection& records, size_t bytes);
         ///@}
 
         /**@}*/
@@ -6426,15 +6892,71 @@ namespace csv {
 
         /** @name Multi-Threaded File Reading: Flags and State */
         ///@{
-        std::thread read_csv_worker; /**< Worker thread for read_csv() */
+        std::thread read_csv_worker; /**< Worker thread for read_csv_ahead() */
         ///@}
 
-        /** Read initial chunk to get metadata */
+        /** Start the parsing thread, which keeps parsing chunks of `bytes` until
+         *  the end of the source. The bounded row queue paces it, so parsing the
+         *  next chunk overlaps reading the rows of the current one.
+         *
+         *  The worker only holds pointers to the heap-allocated parser and queue,
+         *  so a CSVReader may be moved while it runs.
+         */
+        void start_read_csv_worker(size_t bytes) {
+            if (this->read_csv_worker.joinable())
+                this->read_csv_worker.join();
+
+            // Mark the queue as active before the thread starts so read_row() waits for it
+            this->records->notify_all();
+
+            auto parser_ptr = this->parser.get();
+            auto records_ptr = this->records.get();
+            this->read_csv_worker = std::thread([parser_ptr, records_ptr, bytes] {
+                read_csv_ahead(*parser_ptr, *records_ptr, bytes);
+            });
+        }
+
+        /** Parse the rest of the source on read_csv_worker, or only the next
+         *  chunk if threading is disabled
+         */
+        void read_next_chunk() {
+            if (this->_format.use_threads) {
+                this->start_read_csv_worker(this->_format.chunk_bytes);
+                return;
+            }
+
+            // Nobody is waiting on the queue, so it grows to hold the whole chunk
+            this->parser->set_output(*this->records);
+            this->parser->next(this->_format.chunk_bytes);
+            this->records->kill_all();
+        }
+
+        /** Start reading and consume the rows up to the header to get metadata */
         void initial_read() {
-            this->read_csv_worker = std::thread(&CSVReader::read_csv, this, internals::ITERATION_CHUNK_SIZE);
-            this->read_csv_worker.join();
+            this->read_next_chunk();
+            this->trim_header();
         }
 
+        /** Choose chunk size, read-ahead and threading for CSVFormat::auto_tune()
+         *
+         *  @param[in] source_size Size of the input in bytes, 0 if unknown
+         *  @param[in] head        The start of the input, used to estimate the row length
+         */
+        void tune(size_t source_size, csv::string_view head);
+
+        /** Size the row queue for CSVFormat::read_ahead() */
+        void apply_read_ahead() {
+            if (this->_format.read_ahead_rows == 0) return;
+
+            const size_t block_size = RowCollection::DEFAULT_BLOCK_SIZE;
+            this->records.reset(new RowCollection((this->_format.read_ahead_rows + block_size - 1) / block_size));
+        }
+
+        /** Retrieve the next parsed row without column count checks, starting new
+         *  read_csv() workers as needed
+         */
+        bool next_record(CSVRow& row);
+
         void trim_header();
     };
 }
@@ -6472,7 +6994,31 @@ namespace csv {
 
         CSVStat(csv::string_view filename, CSVFormat format = CSVFormat::guess_csv());
         CSVStat(std::stringstream& source, CSVFormat format = CSVFormat());
+
+        /** @name Row-Parallel Mode
+         *  Instead of one thread per column, rows are partitioned across
+         *  `n_threads` workers (0 = one per core) that each keep their own
+         *  statistics for every column, merged once per chunk.
+         */
+        ///@{
+        CSVStat(csv::string_view filename, CSVFormat format, unsigned n_threads);
+        CSVStat(std::stringstream& source, CSVFormat format, unsigned n_threads);
+        ///@}
     private:
+        /** Statistics for one column gathered by one worker in row-parallel mode.
+         *  Frequency keys view into the rows of the current chunk, so they are
+         *  only valid until the chunk is merged.
+         */
+        struct PartialColumnStat {
+            long double n = 0;
+            long double mean = 0;
+            long double var = 0;
+            long double min = NAN;
+            long double max = NAN;
+            std::unordered_map<csv::string_view, size_t> counts;
+            TypeCount dtypes;
+        };
+
         // An array of rolling averages
         // Each index corresponds to the rolling mean for the column at said index
         std::vector<long double> rolling_means;
@@ -6493,8 +7039,21 @@ namespace csv {
         void calc_chunk();
         void calc_worker(const size_t&);
 
+        void init_columns();
+        void calc_parallel();
+        void calc_parallel_chunk(std::vector<std::vector<PartialColumnStat>>& partials);
+        void calc_parallel_worker(size_t begin, size_t end, std::vector<PartialColumnStat>& partial,
+            const std::vector<bool>& counting);
+        void merge_partial(std::vector<PartialColumnStat>& partial);
+
         CSVReader reader;
         std::deque<CSVRow> records = {};
+
+        /** Workers used in row-parallel mode, 0 when using one thread per column */
+        unsigned n_threads = 0;
+
+        /** Rows processed so far, used to decide when to stop counting frequencies */
+        size_t rows_processed = 0;
     };
 }
 
@@ -6987,13 +7546,14 @@ namespace csv {
             _ws_flags = internals::make_ws_flags(
                 format.trim_chars.data(), format.trim_chars.size()
             );
+
+            _scanner = StructuralScanner::from_parse_flags(_parse_flags);
         }
 
         CSV_INLINE void IBasicCSVParser::end_feed() {
             using internals::ParseFlags;
 
             bool empty_last_field = this->data_ptr
-                && this->data_ptr->_data
                 && !this->data_ptr->data.empty()
                 && (parse_flag(this->data_ptr->data.back()) == ParseFlags::DELIMITER
                     || parse_flag(this->data_ptr->data.back()) == ParseFlags::QUOTE);
@@ -7020,10 +7580,12 @@ namespace csv {
                 field_start = (int)(data_pos - current_row_start());
 
             // Optimization: Since NOT_SPECIAL characters tend to occur in contiguous
-            // sequences, use the loop below to avoid having to go through the outer
-            // switch statement as much as possible
+            // sequences, jump straight to the next structural character instead of
+            // going through the outer switch statement for every byte. Inside quotes
+            // delimiters and newlines are NOT_SPECIAL, so scanning resumes past them.
+            data_pos = _scanner.find(in.data(), data_pos, in.size());
             while (data_pos < in.size() && compound_parse_flag(in[data_pos]) == ParseFlags::NOT_SPECIAL)
-                data_pos++;
+                data_pos = _scanner.find(in.data(), data_pos + 1, in.size());
 
             field_length = data_pos - (field_start + current_row_start());
 
@@ -7067,6 +7629,7 @@ namespace csv {
             this->quote_escape = false;
             this->data_pos = 0;
             this->current_row_start() = 0;
+            this->_scanner.reset();
             this->trim_utf8_bom();
 
             auto& in = this->data_ptr->data;
@@ -7146,7 +7709,7 @@ namespace csv {
         }
 
         CSV_INLINE void IBasicCSVParser::reset_data_ptr() {
-            this->data_ptr = std::make_shared<RawCSVData>();
+            this->data_ptr = this->_arena->acquire();
             this->data_ptr->parse_flags = this->_parse_flags;
             this->data_ptr->col_names = this->_col_names;
             this->fields = &(this->data_ptr->fields);
@@ -7185,6 +7748,7 @@ namespace csv {
             if (error) throw error;
 
             auto mmap_ptr = (mio::basic_mmap_source<char>*)(this->data_ptr->_data.get());
+            this->advise(*mmap_ptr, bytes);
 
             // Create string view
             this->data_ptr->data = csv::string_view(mmap_ptr->data(), mmap_ptr->length());
@@ -7193,7 +7757,7 @@ namespace csv {
             this->current_row = CSVRow(this->data_ptr);
             size_t remainder = this->parse();            
 
-            if (this->mmap_pos == this->source_size || no_chunk()) {
+            if (this->mmap_pos == this->source_size || no_chunk(bytes)) {
                 this->_eof = true;
                 this->end_feed();
             }
@@ -7283,6 +7847,14 @@ namespace csv {
         return *this;
     }
 
+    CSV_INLINE CSVFormat& CSVFormat::chunk_size(size_t bytes) {
+        if (bytes < internals::MIN_CHUNK_SIZE)
+            throw std::runtime_error("Chunk size must be at least " + std::to_string(internals::MIN_CHUNK_SIZE) + " bytes");
+
+        this->chunk_bytes = bytes;
+        return *this;
+    }
+
     CSV_INLINE void CSVFormat::assert_no_char_overlap()
     {
         auto delims = std::set<char>(
@@ -7361,8 +7933,15 @@ namespace csv {
             StreamParser<std::stringstream> parser(source, format);
             parser.set_output(rows);
             parser.next();
+            rows.kill_all();
+
+            for (int i = 0; i < format.get_header() && !rows.empty(); i++)
+                rows.pop_front();
+
+            if (rows.empty())
+                return {};
 
-            return CSVRow(std::move(rows[format.get_header()]));
+            return CSVRow(rows.pop_front());
         }
 
         CSV_INLINE GuessScore calculate_score(csv::string_view head, const CSVFormat& format) {
@@ -7379,9 +7958,10 @@ namespace csv {
             StreamParser<std::stringstream> parser(source, format);
             parser.set_output(rows);
             parser.next();
+            rows.kill_all();
 
-            for (size_t i = 0; i < rows.size(); i++) {
-                auto& row = rows[i];
+            for (size_t i = 0; !rows.empty(); i++) {
+                auto row = rows.pop_front();
 
                 // Ignore zero-length rows
                 if (row.size() > 0) {
@@ -7478,8 +8058,11 @@ namespace csv {
      *  \snippet tests/test_read_csv.cpp CSVField Example
      *
      */
-	CSV_INLINE CSVReader::CSVReader(csv::string_view filename, CSVFormat format) : _format(format) {
-        auto head = internals::get_csv_head(filename);
+	CSV_INLINE CSVReader::CSVReader(csv::string_view filename, CSVFormat format)
+        : CSVReader(filename, format, internals::get_file_size(filename)) {}
+
+    CSV_INLINE CSVReader::CSVReader(csv::string_view filename, CSVFormat format, size_t source_size) : _format(format) {
+        auto head = internals::get_csv_head(filename, source_size);
         using Parser = internals::MmapParser;
 
         /** Guess delimiter and header row */
@@ -7493,10 +8076,44 @@ namespace csv {
         if (!format.col_names.empty())
             this->set_col_names(format.col_names);
 
-        this->parser = std::unique_ptr<Parser>(new Parser(filename, format, this->col_names)); // For C++11
+        this->parser = std::unique_ptr<Parser>(new Parser(filename, format, this->col_names, source_size)); // For C++11
+
+        if (this->_format.tune)
+            this->tune(source_size, head);
+
+        this->apply_read_ahead();
         this->initial_read();
     }
 
+    CSV_INLINE void CSVReader::tune(size_t source_size, csv::string_view head) {
+        const size_t MB = 1000000;
+        const unsigned cores = std::thread::hardware_concurrency();
+
+        // A background thread does not pay off on a single core or for input
+        // parsed in one small chunk
+        this->_format.use_threads = cores > 1 && (source_size == 0 || source_size > MB);
+
+        // Threaded: aim for around 8 chunks so parsing overlaps reading for most
+        // of the input. Synchronous: every row of a chunk is queued at once, so
+        // keep chunks small enough for those rows to stay in cache.
+        size_t chunk = std::max(source_size / 8, MB);
+        chunk = std::min(chunk, this->_format.use_threads ? internals::ITERATION_CHUNK_SIZE : MB);
+        this->_format.chunk_bytes = chunk;
+
+        // Queue about 1MB of rows ahead of the reader; rows read soon after
+        // being parsed are still in cache
+        size_t row_length = 100;
+        const size_t newlines = (size_t)std::count(head.begin(), head.end(), '\n');
+        if (newlines > 0)
+            row_length = std::max<size_t>(1, head.size() / newlines);
+
+        const size_t block_size = RowCollection::DEFAULT_BLOCK_SIZE;
+        size_t rows = MB / row_length;
+        rows = std::max(rows, 2 * block_size);
+        rows = std::min(rows, 64 * block_size);
+        this->_format.read_ahead_rows = rows;
+    }
+
     /** Return the format of the original raw CSV */
     CSV_INLINE CSVFormat CSVReader::get_format() const {
         CSVFormat new_format = this->_format;
@@ -7532,12 +8149,10 @@ namespace csv {
 
     CSV_INLINE void CSVReader::trim_header() {
         if (!this->header_trimmed) {
-            for (int i = 0; i <= this->_format.header && !this->records->empty(); i++) {
+            CSVRow row;
+            for (int i = 0; i <= this->_format.header && this->next_record(row); i++) {
                 if (i == this->_format.header && this->col_names->empty()) {
-                    this->set_col_names(this->records->pop_front());
-                }
-                else {
-                    this->records->pop_front();
+                    this->set_col_names(row);
                 }
             }
 
@@ -7566,27 +8181,65 @@ namespace csv {
      * @see CSVReader::read_row()
      */
     CSV_INLINE bool CSVReader::read_csv(size_t bytes) {
+        return read_csv(*this->parser, *this->records, bytes);
+    }
+
+    /** Parse a chunk of CSV data from `parser` into `records` */
+    CSV_INLINE bool CSVReader::read_csv(internals::IBasicCSVParser& parser, RowCollection& records, size_t bytes) {
         // Tell read_row() to listen for CSV rows
-        this->records->notify_all();
+        records.notify_all();
 
-        this->parser->set_output(*this->records);
-        this->parser->next(bytes);
+        parser.set_output(records);
+        parser.next(bytes);
 
-        if (!this->header_trimmed) {
-            this->trim_header();
-        }
-
-        // Tell read_row() to stop waiting
-        this->records->kill_all();
+        // Publish the last rows and tell read_row() to stop waiting
+        records.kill_all();
 
         return true;
     }
 
+    /** Parse chunks of `bytes` from `parser` into `records` until the end of the
+     *  source or until the reader abandons `records`
+     */
+    CSV_INLINE void CSVReader::read_csv_ahead(internals::IBasicCSVParser& parser, RowCollection& records, size_t bytes) {
+        records.notify_all();
+        parser.set_output(records);
+
+        while (!parser.eof() && !records.is_abandoned())
+            parser.next(bytes);
+
+        records.kill_all();
+    }
+
+    CSV_INLINE bool CSVReader::next_record(CSVRow &row) {
+        while (true) {
+            if (!this->records->empty()) {
+                row = this->records->pop_front();
+                return true;
+            }
+
+            if (this->records->is_waitable()) {
+                // Reading thread is currently active => wait for it to populate records
+                this->records->wait();
+            }
+            else if (this->records->empty()) {
+                // The worker may have published its last rows just before stopping
+                if (this->parser->eof())
+                    // End of file and no more records
+                    return false;
+
+                // Parsing is not active (first chunk, or threading is disabled) => start it
+                this->read_next_chunk();
+            }
+        }
+    }
+
     /**
      * Retrieve rows as CSVRow objects, returning true if more rows are available.
      *
      * @par Performance Notes
-     *  - Reads chunks of data that are csv::internals::ITERATION_CHUNK_SIZE bytes large at a time
+     *  - Reads chunks of data that are CSVFormat::chunk_size() bytes large at a time
+     *    (csv::internals::ITERATION_CHUNK_SIZE unless changed)
      *  - For performance details, read the documentation for CSVRow and CSVField.
      *
      * @param[out] row The variable where the parsed row will be stored
@@ -7597,38 +8250,21 @@ namespace csv {
      *
      */
     CSV_INLINE bool CSVReader::read_row(CSVRow &row) {
-        while (true) {
-            if (this->records->empty()) {
-                if (this->records->is_waitable())
-                    // Reading thread is currently active => wait for it to populate records
-                    this->records->wait();
-                else if (this->parser->eof())
-                    // End of file and no more records
-                    return false;
-                else {
-                    // Reading thread is not active => start another one
-                    if (this->read_csv_worker.joinable())
-                        this->read_csv_worker.join();
-
-                    this->read_csv_worker = std::thread(&CSVReader::read_csv, this, internals::ITERATION_CHUNK_SIZE);
-                }
-            }
-            else if (this->records->front().size() != this->n_cols &&
+        while (this->next_record(row)) {
+            if (row.size() != this->n_cols &&
                 this->_format.variable_column_policy != VariableColumnPolicy::KEEP) {
-                auto errored_row = this->records->pop_front();
-
                 if (this->_format.variable_column_policy == VariableColumnPolicy::THROW) {
-                    if (errored_row.size() < this->n_cols)
-                        throw std::runtime_error("Line too short " + internals::format_row(errored_row));
+                    if (row.size() < this->n_cols)
+                        throw std::runtime_error("Line too short " + internals::format_row(row));
 
-                    throw std::runtime_error("Line too long " + internals::format_row(errored_row));
+                    throw std::runtime_error("Line too long " + internals::format_row(row));
                 }
+
+                continue;
             }
-            else {
-                row = this->records->pop_front();
-                this->_n_rows++;
-                return true;
-            }
+
+            this->_n_rows++;
+            return true;
         }
 
         return false;
@@ -7643,16 +8279,10 @@ namespace csv {
 namespace csv {
     /** Return an iterator to the first row in the reader */
     CSV_INLINE CSVReader::iterator CSVReader::begin() {
-        if (this->records->empty()) {
-            this->read_csv_worker = std::thread(&CSVReader::read_csv, this, internals::ITERATION_CHUNK_SIZE);
-            this->read_csv_worker.join();
-
-            // Still empty => return end iterator
-            if (this->records->empty()) return this->end();
-        }
+        CSVRow row;
+        if (!this->read_row(row)) return this->end();
 
-        this->_n_rows++;
-        CSVReader::iterator ret(this, this->records->pop_front());
+        CSVReader::iterator ret(this, std::move(row));
         return ret;
     }
 
@@ -7710,13 +8340,35 @@ namespace csv {
         CSV_INLINE RawCSVField& CSVFieldList::operator[](size_t n) const {
             const size_t page_no = n / _single_buffer_capacity;
             const size_t buffer_idx = (page_no < 1) ? n : n % _single_buffer_capacity;
-            return this->buffers[page_no][buffer_idx];
+            return this->_table.load(std::memory_order_acquire)[page_no][buffer_idx];
         }
 
         CSV_INLINE void CSVFieldList::allocate() {
+            _current_buffer_size = 0;
+
+            // Reuse a block kept by clear(), it is already in the block table
+            if (_blocks_used < buffers.size()) {
+                _back = buffers[_blocks_used++].get();
+                return;
+            }
+
             buffers.push_back(std::unique_ptr<RawCSVField[]>(new RawCSVField[_single_buffer_capacity]));
+            _blocks_used++;
+
+            RawCSVField** table = _table.load(std::memory_order_relaxed);
+            if (buffers.size() > _table_capacity) {
+                const size_t capacity = std::max<size_t>(16, _table_capacity * 2);
+                std::unique_ptr<RawCSVField*[]> grown(new RawCSVField*[capacity]);
+                if (table) std::copy(table, table + _table_capacity, grown.get());
+
+                table = grown.get();
+                _tables.push_back(std::move(grown));
+                _table_capacity = capacity;
+            }
+
+            table[buffers.size() - 1] = buffers.back().get();
+            _table.store(table, std::memory_order_release);
 
-            _current_buffer_size = 0;
             _back = buffers.back().get();
         }
     }
@@ -7773,6 +8425,7 @@ namespace csv {
         auto field_str = csv::string_view(this->data->data).substr(this->data_start + field.start);
 
         if (field.has_double_quote) {
+            std::lock_guard<std::mutex> lock{ this->data->double_quote_fields_lock };
             auto& value = this->data->double_quote_fields[field_index];
             if (value.empty()) {
                 bool prev_ch_quote = false;
@@ -8258,6 +8911,24 @@ namespace csv {
         this->calc();
     }
 
+    /** Calculate statistics for an arbitrarily large file, partitioning rows
+     *  across `n_threads` workers (0 = one per core)
+     */
+    CSV_INLINE CSVStat::CSVStat(csv::string_view filename, CSVFormat format, unsigned n_threads) :
+        reader(filename, format),
+        n_threads(n_threads ? n_threads : std::max(1u, std::thread::hardware_concurrency())) {
+        this->calc();
+    }
+
+    /** Calculate statistics for a CSV stored in a std::stringstream, partitioning
+     *  rows across `n_threads` workers (0 = one per core)
+     */
+    CSV_INLINE CSVStat::CSVStat(std::stringstream& stream, CSVFormat format, unsigned n_threads) :
+        reader(stream, format),
+        n_threads(n_threads ? n_threads : std::max(1u, std::thread::hardware_concurrency())) {
+        this->calc();
+    }
+
     /** Return current means */
     CSV_INLINE std::vector<long double> CSVStat::get_mean() const {
         std::vector<long double> ret;        
@@ -8312,7 +8983,7 @@ namespace csv {
         return ret;
     }
 
-    CSV_INLINE void CSVStat::calc_chunk() {
+    CSV_INLINE void CSVStat::init_columns() {
         /** Only create stats counters the first time **/
         if (dtypes.empty()) {
             /** Go through all records and calculate specified statistics */
@@ -8326,6 +8997,10 @@ namespace csv {
                 n.push_back(0);
             }
         }
+    }
+
+    CSV_INLINE void CSVStat::calc_chunk() {
+        this->init_columns();
 
         // Start threads
         std::vector<std::thread> pool;
@@ -8342,6 +9017,11 @@ namespace csv {
     CSV_INLINE void CSVStat::calc() {
         constexpr size_t CALC_CHUNK_SIZE = 5000;
 
+        if (this->n_threads > 0) {
+            this->calc_parallel();
+            return;
+        }
+
         for (auto& row : reader) {
             this->records.push_back(std::move(row));
 
@@ -8391,6 +9071,142 @@ namespace csv {
         }
     }
 
+    CSV_INLINE void CSVStat::calc_parallel() {
+        /** Each worker gets this many rows per chunk, so threads are started
+         *  once per chunk rather than once per column per 5000 rows
+         */
+        constexpr size_t ROWS_PER_WORKER = 20000;
+        const size_t chunk_size = ROWS_PER_WORKER * this->n_threads;
+
+        std::vector<std::vector<PartialColumnStat>> partials(this->n_threads);
+
+        for (auto& row : reader) {
+            this->records.push_back(std::move(row));
+
+            if (this->records.size() == chunk_size) {
+                calc_parallel_chunk(partials);
+            }
+        }
+
+        if (!this->records.empty()) {
+            calc_parallel_chunk(partials);
+        }
+    }
+
+    CSV_INLINE void CSVStat::calc_parallel_chunk(std::vector<std::vector<PartialColumnStat>>& partials) {
+        this->init_columns();
+        const size_t n_cols = this->get_col_names().size();
+
+        // Same heuristic as calc_worker(): stop counting columns with too many distinct values
+        std::vector<bool> counting(n_cols);
+        for (size_t i = 0; i < n_cols; i++)
+            counting[i] = this->rows_processed < 1000 || this->counts[i].size() <= 500;
+
+        const size_t slice = (this->records.size() + this->n_threads - 1) / this->n_threads;
+        std::vector<std::thread> pool;
+        for (size_t t = 0; t < partials.size(); t++) {
+            const size_t begin = std::min(this->records.size(), t * slice);
+            const size_t end = std::min(this->records.size(), begin + slice);
+            if (begin == end) break;
+
+            if (partials[t].size() != n_cols)
+                partials[t].resize(n_cols);
+
+            pool.push_back(std::thread(&CSVStat::calc_parallel_worker, this,
+                begin, end, std::ref(partials[t]), std::cref(counting)));
+        }
+
+        // Block until done
+        for (auto& th : pool)
+            th.join();
+
+        // Merge while the rows (and the string_views into them) are still alive
+        for (size_t t = 0; t < pool.size(); t++)
+            this->merge_partial(partials[t]);
+
+        this->rows_processed += this->records.size();
+        this->records.clear();
+    }
+
+    CSV_INLINE void CSVStat::calc_parallel_worker(size_t begin, size_t end,
+        std::vector<PartialColumnStat>& partial, const std::vector<bool>& counting) {
+        /** Worker thread for CSVStat::calc_parallel() which calculates statistics for
+         *  every column over records [begin, end)
+         */
+        const size_t n_cols = partial.size();
+
+        for (size_t r = begin; r < end; r++) {
+            auto& current_record = this->records[r];
+
+            if (current_record.size() == n_cols) {
+                for (size_t i = 0; i < n_cols; i++) {
+                    auto current_field = current_record[i];
+                    auto& stat = partial[i];
+
+                    if (counting[i] && (this->rows_processed + r < 1000
+                        || this->counts[i].size() + stat.counts.size() <= 500))
+                        stat.counts[current_field.get<csv::string_view>()]++;
+
+                    stat.dtypes[current_field.type()]++;
+
+                    // Numeric Stuff
+                    if (current_field.is_num()) {
+                        long double x_n = current_field.get<long double>();
+
+                        // Welford's Algorithm
+                        stat.n++;
+                        long double delta = x_n - stat.mean;
+                        stat.mean += delta / stat.n;
+                        stat.var += delta * (x_n - stat.mean);
+
+                        if (std::isnan(stat.min) || x_n < stat.min)
+                            stat.min = x_n;
+                        if (std::isnan(stat.max) || x_n > stat.max)
+                            stat.max = x_n;
+                    }
+                }
+            }
+            else if (this->reader.get_format().get_variable_column_policy() == VariableColumnPolicy::THROW) {
+                throw std::runtime_error("Line has different length than the others " + internals::format_row(current_record));
+            }
+        }
+    }
+
+    CSV_INLINE void CSVStat::merge_partial(std::vector<PartialColumnStat>& partial) {
+        /** Fold one worker's statistics into the totals and reset them for the next chunk */
+        for (size_t i = 0; i < partial.size(); i++) {
+            auto& stat = partial[i];
+
+            for (auto& item : stat.counts)
+                this->counts[i][std::string(item.first)] += item.second;
+
+            for (auto& item : stat.dtypes)
+                this->dtypes[i][item.first] += item.second;
+
+            if (stat.n > 0) {
+                // Combine Welford states (Chan et al.)
+                const long double total = this->n[i] + stat.n;
+                const long double delta = stat.mean - this->rolling_means[i];
+                this->rolling_means[i] += delta * stat.n / total;
+                this->rolling_vars[i] += stat.var + delta * delta * this->n[i] * stat.n / total;
+                this->n[i] = total;
+
+                if (std::isnan(this->mins[i]) || stat.min < this->mins[i])
+                    this->mins[i] = stat.min;
+                if (std::isnan(this->maxes[i]) || stat.max > this->maxes[i])
+                    this->maxes[i] = stat.max;
+            }
+
+            stat.n = 0;
+            stat.mean = 0;
+            stat.var = 0;
+            stat.min = NAN;
+            stat.max = NAN;
+            stat.counts.clear();
+            stat.dtypes.clear();
+        }
+    }
+
     CSV_INLINE void CSVStat::dtype(CSVField& data, const size_t &i) {
         /** Given a record update the type counter
          *  @param[in]  record Data observation
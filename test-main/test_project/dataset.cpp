@@ -2,44 +2,186 @@
 #include "WaterSample.hpp"
 #include "PollutantSample.hpp"
 #include "csv.hpp"
+#include "ColumnarCache.hpp"
+#include "SampleSort.hpp"
+#include "MemoryUsage.hpp"
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <sstream>
 #include <stdexcept>
 #include <iostream>
 
-void WaterDataset::loadData(const std::string& filename) {
-    csv::CSVReader reader(filename);
+namespace {
 
-    data.clear();
+// Rows converted before each filter/aggregate pass in streamQuery
+constexpr size_t STREAM_BATCH_ROWS = 50000;
+// Rows parsed between cancellation checks in loadData
+constexpr size_t CANCEL_CHECK_ROWS = 16384;
+// Bytes read at a time when looking for the end of the last row of a file
+constexpr size_t ROW_SCAN_BYTES = 1 << 20;
+
+// Offset just past the last line break in text[0, size) that ends a CSV row,
+// npos if none does. A line break inside a quoted field is part of the field,
+// not a row end. quoted says whether text starts inside quotes and is left
+// saying whether it ends inside them; every quote flips it, which also holds
+// for the doubled "" of an escaped quote.
+size_t lastRowEnd(const char* text, size_t size, bool& quoted) {
+    size_t end = std::string::npos;
+    for (size_t i = 0; i < size; ++i) {
+        if (text[i] == '"')
+            quoted = !quoted;
+        else if (text[i] == '\n' && !quoted)
+            end = i + 1;
+    }
+    return end;
+}
+
+// Offset just past the last complete row of filename, 0 if it has none. Read
+// from the start, since only there is it known to be outside quotes.
+uint64_t completeRowsEnd(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Cannot open file " + filename);
+    uint64_t end = 0;
+    uint64_t start = 0;
+    bool quoted = false;
+    std::string buffer(ROW_SCAN_BYTES, '\0');
+    while (file.read(&buffer[0], static_cast<std::streamsize>(buffer.size())) || file.gcount() > 0) {
+        size_t size = static_cast<size_t>(file.gcount());
+        size_t rowEnd = lastRowEnd(buffer.data(), size, quoted);
+        if (rowEnd != std::string::npos)
+            end = start + rowEnd;
+        start += size;
+    }
+    return end;
+}
+
+} // namespace
+
+WaterDataset::PositionColumns WaterDataset::positionColumns(const csv::CSVReader& reader) {
+    // Looked up once per file: older exports lack the columns
+    PositionColumns columns;
+    columns.easting = reader.index_of("sample.samplingPoint.easting");
+    columns.northing = reader.index_of("sample.samplingPoint.northing");
+    return columns;
+}
+
+WaterSample WaterDataset::sampleFromRow(const csv::CSVRow& row, const PositionColumns& columns) {
+    double level = 0.0;
+    if (!row["result"].is_null()) {
+        level = row["result"].get<double>();
+    }
+
+    WaterSample sample(
+        row["sample.samplingPoint.label"].get<>(),
+        row["determinand.label"].get<>(),
+        level,
+        row["determinand.unit.label"].get<>(),
+        row["sample.isComplianceSample"].get(),
+        row["sample.sampleDateTime"].get<std::string>()
+    );
+
+    // A blank or non-numeric coordinate leaves the position unknown
+    if (columns.easting != csv::CSV_NOT_FOUND && columns.northing != csv::CSV_NOT_FOUND) {
+        csv::CSVField easting = row[static_cast<size_t>(columns.easting)];
+        csv::CSVField northing = row[static_cast<size_t>(columns.northing)];
+        if (easting.is_num() && northing.is_num())
+            sample.setPosition(easting.get<double>(), northing.get<double>());
+    }
+    return sample;
+}
+
+WaterDataset::CsvSource WaterDataset::readRows(const std::string& filename, std::vector<WaterSample>& rows,
+                                               const CancelToken* cancel) {
+    // The file may be being appended to: the rows complete now are read and
+    // the rest is left to appendFromFile(), so no row is read twice or cut
+    CsvSource source;
+    source.bytes = completeRowsEnd(filename);
+    if (source.bytes == 0)
+        return source;
+
+    // Chunk size, read-ahead and threading are picked from the file size and core count
+    csv::CSVFormat format = csv::CSVFormat::guess_csv();
+    format.auto_tune();
+    csv::CSVReader reader(filename, format, static_cast<size_t>(source.bytes));
+    source.delimiter = reader.get_format().get_delim();
+    source.columns = reader.get_col_names();
+    PositionColumns columns = positionColumns(reader);
 
+    size_t read = 0;
     for (const auto& row : reader) {
+        if (cancel && ++read % CANCEL_CHECK_ROWS == 0)
+            cancel->check();
         try {
-            double level = 0.0;
-            if (!row["result"].is_null()) {
-                level = row["result"].get<double>();
-            }
-
-            WaterSample sample(
-            row["sample.samplingPoint.label"].get<>(),
-            row["determinand.label"].get<>(),
-            level,
-            row["determinand.unit.label"].get<>(),
-            row["sample.isComplianceSample"].get(),
-            row["sample.sampleDateTime"].get<std::string>()
-            
-             );
-            std::cout << "Created WaterSample: "
-            << sample.getLocation() << ", "
-            << sample.getPollutant() << ", "
-            << sample.getLevel() << ", "
-            << sample.getUnit() << ", "
-            << sample.getComplianceStatus() << std::endl
-            << sample.getSampleDate() << std::endl;
-
-            data.push_back(sample);
+            rows.push_back(sampleFromRow(row, columns));
         } catch (const std::exception& e) {
             std::cerr << "Error processing row: " << e.what() << std::endl;
             continue;
         }
     }
+    return source;
+}
+
+void WaterDataset::loadData(const std::string& filename, const CancelToken* cancel) {
+    data.clear();
+    aggregates.clear();
+    sketches.clear();
+    pendingColumnar.reset();
+    spatialIndex.clear();
+    timeSeries.reset();
+    pendingSeries = PendingSeries();
+    anomalyDetector.clear();
+    anomalyScores.clear();
+    holdsEveryRow = true;
+
+    source = readRows(filename, data, cancel);
+    aggregates.add(data);
+    sketches.add(data);
+    spatialIndex.add(data);
+    scoreAnomalies(0);
+}
+
+void WaterDataset::loadMerged(const std::vector<std::string>& filenames) {
+    data.clear();
+    aggregates.clear();
+    sketches.clear();
+    pendingColumnar.reset();
+    spatialIndex.clear();
+    timeSeries.reset();
+    pendingSeries = PendingSeries();
+    anomalyDetector.clear();
+    anomalyScores.clear();
+    holdsEveryRow = true;
+    source = CsvSource();
+
+    for (const std::string& filename : filenames)
+        readRows(filename, data);
+    ::sortAndDeduplicate(data);
+    aggregates.add(data);
+    sketches.add(data);
+    spatialIndex.add(data);
+    scoreAnomalies(0);
+}
+
+size_t WaterDataset::sortAndDeduplicate() {
+    if (!holdsEveryRow)
+        throw std::runtime_error("Only a dataset holding every row can be sorted and deduplicated");
+    size_t removed = ::sortAndDeduplicate(data);
+    if (removed > 0) {
+        timeSeries.reset();
+        // The aggregates counted the duplicates too
+        aggregates.clear();
+        sketches.clear();
+        aggregates.add(data);
+        sketches.add(data);
+    }
+    // Rescored in the new order, which is time order within each series
+    anomalyDetector.clear();
+    anomalyScores.clear();
+    scoreAnomalies(0);
+    return removed;
 }
 
 std::vector<WaterSample>& WaterDataset::getData() {
@@ -54,7 +196,415 @@ void WaterDataset::checkDataExists() const {
 }
 
 void WaterDataset::appendData(const std::vector<WaterSample>& newSamples) {
+    buildPendingAggregates();
+    if (timeSeries)
+        timeSeries->add(newSamples);
     data.insert(data.end(), newSamples.begin(), newSamples.end());
+    aggregates.add(newSamples);
+    sketches.add(newSamples);
+    spatialIndex.add(newSamples);
+    // New rows are scored against the baselines the earlier rows left
+    scoreAnomalies(data.size() - newSamples.size());
+}
+
+size_t WaterDataset::appendFromFile(const std::string& filename, uint64_t& offset) {
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file)
+        throw std::runtime_error("Cannot read " + filename);
+    uint64_t size = static_cast<uint64_t>(file.tellg());
+    if (size < offset)
+        throw std::runtime_error(filename + " is shorter than the rows already read");
+
+    std::string header;
+    file.seekg(0);
+    if (!std::getline(file, header) || file.eof())
+        return 0; // Not even the header is complete yet
+    offset = std::max(offset, static_cast<uint64_t>(file.tellg()));
+    if (size == offset)
+        return 0;
+
+    std::string region(size - offset, '\0');
+    file.seekg(static_cast<std::streamoff>(offset));
+    if (!file.read(&region[0], static_cast<std::streamsize>(region.size())))
+        throw std::runtime_error("Cannot read " + filename);
+    // offset is the start of a row, so outside quotes
+    bool quoted = false;
+    size_t end = lastRowEnd(region.data(), region.size(), quoted);
+    if (end == std::string::npos)
+        return 0;
+    region.resize(end);
+    offset += region.size();
+    source.bytes = offset;
+
+    // Parsed as loadData() parsed the start of the file; after a load from
+    // the columnar cache the delimiter and columns are guessed from it once
+    if (source.columns.empty()) {
+        source.delimiter = csv::guess_format(filename).delim;
+        source.columns = csv::get_col_names(filename);
+    }
+    csv::CSVFormat format;
+    format.delimiter(source.delimiter).column_names(source.columns);
+    std::stringstream appended(region);
+    csv::CSVReader reader(appended, format);
+    PositionColumns columns = positionColumns(reader);
+    std::vector<WaterSample> rows;
+    for (const auto& row : reader) {
+        try {
+            rows.push_back(sampleFromRow(row, columns));
+        } catch (const std::exception& e) {
+            std::cerr << "Error processing row: " << e.what() << std::endl;
+        }
+    }
+    if (!rows.empty())
+        appendData(rows);
+    return rows.size();
+}
+
+void WaterDataset::scoreAnomalies(size_t firstRow) {
+    anomalyScores.reserve(data.size());
+    for (size_t i = firstRow; i < data.size(); ++i)
+        anomalyScores.push_back(anomalyDetector.add(data[i]));
+}
+
+FilterResult WaterDataset::streamQuery(const std::vector<std::string>& filenames, const ComplianceRules& rules,
+                                      const SampleFilter& filter, size_t sampleLimit, const CancelToken* cancel) {
+    data.clear();
+    aggregates.clear();
+    sketches.clear();
+    pendingColumnar.reset();
+    spatialIndex.clear();
+    timeSeries.reset();
+    pendingSeries = PendingSeries();
+    anomalyDetector.clear();
+    anomalyScores.clear();
+    holdsEveryRow = false;
+    source = CsvSource();
+
+    StatsAccumulator stats;
+    std::vector<ComplianceStatus> statuses;
+    std::vector<double> scores;
+    std::vector<size_t> matchIndex; // Position of each kept row among all matches
+    size_t matched = 0;
+    std::mt19937_64 random(0x5eed); // Fixed seed, the same query shows the same rows
+
+    std::vector<WaterSample> batch;
+    batch.reserve(STREAM_BATCH_ROWS);
+
+    // Reservoir sampling (Algorithm R) keeps every match with equal probability
+    auto processBatch = [&]() {
+        if (cancel)
+            cancel->check();
+        FilterPartial partial = filterSamples(batch, rules, filter);
+        aggregates.add(batch);
+        sketches.add(batch);
+        spatialIndex.add(batch);
+        stats.merge(partial.stats);
+        std::vector<double> batchScores(batch.size());
+        for (size_t i = 0; i < batch.size(); ++i)
+            batchScores[i] = anomalyDetector.add(batch[i]);
+
+        for (size_t i = 0; i < partial.rows.size() && sampleLimit > 0; ++i) {
+            size_t seen = matched++;
+            const WaterSample& sample = batch[partial.rows[i]];
+            if (data.size() < sampleLimit) {
+                data.push_back(sample);
+                statuses.push_back(partial.statuses[i]);
+                scores.push_back(batchScores[partial.rows[i]]);
+                matchIndex.push_back(seen);
+                continue;
+            }
+
+            size_t slot = std::uniform_int_distribution<size_t>(0, seen)(random);
+            if (slot < sampleLimit) {
+                data[slot] = sample;
+                statuses[slot] = partial.statuses[i];
+                scores[slot] = batchScores[partial.rows[i]];
+                matchIndex[slot] = seen;
+            }
+        }
+        batch.clear();
+    };
+
+    for (const std::string& filename : filenames) {
+        try {
+            csv::CSVFormat format = csv::CSVFormat::guess_csv();
+            format.auto_tune();
+            csv::CSVReader reader(filename, format);
+            PositionColumns columns = positionColumns(reader);
+
+            for (const auto& row : reader) {
+                try {
+                    batch.push_back(sampleFromRow(row, columns));
+                } catch (const std::exception& e) {
+                    std::cerr << "Error processing row: " << e.what() << std::endl;
+                    continue;
+                }
+
+                if (batch.size() == STREAM_BATCH_ROWS)
+                    processBatch();
+            }
+        } catch (const QueryCancelled&) {
+            throw;
+        } catch (const std::exception& e) {
+            std::cerr << "Skipping " << filename << ": " << e.what() << std::endl;
+        }
+    }
+    processBatch();
+
+    // Put the sample back in file order
+    std::vector<size_t> order(data.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return matchIndex[a] < matchIndex[b]; });
+
+    std::vector<WaterSample> sorted;
+    FilterResult result;
+    sorted.reserve(order.size());
+    result.statuses.reserve(order.size());
+    anomalyScores.reserve(order.size());
+    for (size_t i : order) {
+        sorted.push_back(std::move(data[i]));
+        result.statuses.push_back(statuses[i]);
+        anomalyScores.push_back(scores[i]);
+    }
+    data.swap(sorted);
+
+    result.rows.resize(data.size());
+    std::iota(result.rows.begin(), result.rows.end(), 0);
+    result.stats = stats.result();
+    result.accumulator = std::move(stats);
+    return result;
+}
+
+void WaterDataset::saveColumnar(const std::string& path, uint32_t blockRows) const {
+    columnar::writeFile(path, data, blockRows, source.bytes);
+}
+
+FilterResult WaterDataset::loadColumnar(const std::string& path, const ComplianceRules& rules,
+                                        const SampleFilter& filter, const CancelToken* cancel) {
+    using columnar::Column;
+    auto file = std::make_shared<const columnar::ColumnarFile>(path);
+
+    data.clear();
+    aggregates.clear();
+    sketches.clear();
+    // Aggregates and sketches are built from the file when first asked for
+    pendingColumnar = file;
+    spatialIndex.clear();
+    for (uint32_t id = 0; id < file->dictionarySize(Column::Location); ++id)
+        spatialIndex.add(file->dictionaryValue(Column::Location, id), file->locationPosition(id));
+    timeSeries.reset();
+    pendingSeries = PendingSeries();
+    anomalyDetector.clear();
+    anomalyScores.clear();
+    holdsEveryRow = false;
+    source = CsvSource();
+    source.bytes = file->sourceBytes();
+
+    // Filter strings resolved to dictionary ids once, -1 when absent from the file
+    int64_t locationId = filter.location.empty() ? -1 : file->findId(Column::Location, filter.location);
+    int64_t pollutantId = filter.pollutant.empty() ? -1 : file->findId(Column::Pollutant, filter.pollutant);
+
+    // Blocks are skipped by location, pollutant and year only: rows the
+    // status filter rejects still feed the anomaly baselines
+    SampleFilter seriesFilter = filter;
+    seriesFilter.status.reset();
+
+    // Whether each location id lies in the area, worked out once per point
+    std::vector<bool> inArea;
+    if (filter.area)
+        for (uint32_t id = 0; id < file->dictionarySize(Column::Location); ++id)
+            inArea.push_back(filter.area->contains(file->locationPosition(id)));
+
+    StatsAccumulator stats;
+    FilterResult result;
+    std::vector<uint32_t> candidates;
+    for (size_t block = 0; block < file->blockCount(); ++block) {
+        if (cancel)
+            cancel->check();
+        if (!file->blockMayMatch(block, seriesFilter, rules))
+            continue;
+
+        // Each filter narrows the candidate rows using only its own column, so
+        // a block stops being read as soon as nothing in it can match
+        candidates.resize(file->zoneMap(block).rows);
+        std::iota(candidates.begin(), candidates.end(), 0);
+        auto narrow = [&](auto keep) {
+            candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                            [&](uint32_t row) { return !keep(row); }),
+                             candidates.end());
+        };
+
+        std::vector<uint32_t> locations;
+        if (!filter.location.empty()) {
+            locations = file->readIds(block, Column::Location);
+            narrow([&](uint32_t row) { return locations[row] == locationId; });
+        }
+        if (!candidates.empty() && filter.area) {
+            if (locations.empty())
+                locations = file->readIds(block, Column::Location);
+            narrow([&](uint32_t row) { return inArea[locations[row]]; });
+        }
+
+        std::vector<uint32_t> pollutants;
+        if (!candidates.empty() && !filter.pollutant.empty()) {
+            pollutants = file->readIds(block, Column::Pollutant);
+            narrow([&](uint32_t row) { return pollutants[row] == pollutantId; });
+        }
+
+        std::vector<int64_t> dates;
+        if (!candidates.empty() && filter.year != 0) {
+            dates = file->readDates(block);
+            narrow([&](uint32_t row) { return file->yearMonth(dates[row]) / 100 == filter.year; });
+        }
+
+        if (candidates.empty())
+            continue;
+        if (locations.empty())
+            locations = file->readIds(block, Column::Location);
+        if (pollutants.empty())
+            pollutants = file->readIds(block, Column::Pollutant);
+        std::vector<double> levels = file->readLevels(block);
+
+        // The file is in location, pollutant and time order, so each series
+        // reaches the detector in time order
+        std::vector<double> blockScores(levels.size());
+        for (uint32_t row : candidates)
+            blockScores[row] = anomalyDetector.add(file->dictionaryValue(Column::Location, locations[row]),
+                                                   file->dictionaryValue(Column::Pollutant, pollutants[row]),
+                                                   levels[row]);
+
+        std::vector<ComplianceStatus> blockStatuses(levels.size(), ComplianceStatus::Missing);
+        narrow([&](uint32_t row) {
+            blockStatuses[row] = rules.assess(file->dictionaryValue(Column::Pollutant, pollutants[row]), levels[row]);
+            return !filter.status || blockStatuses[row] == *filter.status;
+        });
+
+        if (candidates.empty())
+            continue;
+        if (dates.empty())
+            dates = file->readDates(block);
+        std::vector<uint32_t> units = file->readIds(block, Column::Unit);
+        std::vector<uint32_t> compliance = file->readIds(block, Column::Compliance);
+
+        for (uint32_t row : candidates) {
+            data.emplace_back(file->dictionaryValue(Column::Location, locations[row]),
+                              file->dictionaryValue(Column::Pollutant, pollutants[row]), levels[row],
+                              file->dictionaryValue(Column::Unit, units[row]),
+                              file->dictionaryValue(Column::Compliance, compliance[row]),
+                              file->dateString(dates[row]));
+            const GridPoint& position = file->locationPosition(locations[row]);
+            data.back().setPosition(position.easting, position.northing);
+            result.statuses.push_back(blockStatuses[row]);
+            anomalyScores.push_back(blockScores[row]);
+            stats.add(data.back(), blockStatuses[row]);
+        }
+    }
+
+    pendingSeries = PendingSeries{file, seriesFilter, data.size()};
+    result.rows.resize(data.size());
+    std::iota(result.rows.begin(), result.rows.end(), 0);
+    result.stats = stats.result();
+    result.accumulator = std::move(stats);
+    return result;
+}
+
+void WaterDataset::buildPendingAggregates() const {
+    if (!pendingColumnar)
+        return;
+
+    // Only the four columns the aggregates use are paged in
+    using columnar::Column;
+    const columnar::ColumnarFile& file = *pendingColumnar;
+    for (size_t block = 0; block < file.blockCount(); ++block) {
+        std::vector<uint32_t> locations = file.readIds(block, Column::Location);
+        std::vector<uint32_t> pollutants = file.readIds(block, Column::Pollutant);
+        std::vector<double> levels = file.readLevels(block);
+        std::vector<int64_t> dates = file.readDates(block);
+        for (size_t i = 0; i < levels.size(); ++i) {
+            const std::string& location = file.dictionaryValue(Column::Location, locations[i]);
+            const std::string& pollutant = file.dictionaryValue(Column::Pollutant, pollutants[i]);
+            int yearMonth = file.yearMonth(dates[i]);
+            aggregates.add(location, pollutant, yearMonth, levels[i]);
+            sketches.add(location, pollutant, yearMonth, levels[i]);
+        }
+    }
+    pendingColumnar.reset();
+}
+
+const TimeSeriesEngine& WaterDataset::getTimeSeries() const {
+    if (timeSeries)
+        return *timeSeries;
+    if (!pendingSeries.file) {
+        timeSeries = std::make_unique<TimeSeriesEngine>(data);
+        return *timeSeries;
+    }
+
+    // The data holds only the rows of the status asked for, so the rows of
+    // the series are read from the file again, without the status filter
+    using columnar::Column;
+    const columnar::ColumnarFile& file = *pendingSeries.file;
+    const SampleFilter& filter = pendingSeries.filter;
+    timeSeries = std::make_unique<TimeSeriesEngine>(std::vector<WaterSample>());
+    std::vector<WaterSample> rows;
+    for (size_t block = 0; block < file.blockCount(); ++block) {
+        if (!file.blockMayMatch(block, filter, ComplianceRules()))
+            continue;
+        std::vector<uint32_t> locations = file.readIds(block, Column::Location);
+        std::vector<uint32_t> pollutants = file.readIds(block, Column::Pollutant);
+        std::vector<double> levels = file.readLevels(block);
+        std::vector<int64_t> dates = file.readDates(block);
+        rows.clear();
+        for (size_t i = 0; i < levels.size(); ++i) {
+            const std::string& location = file.dictionaryValue(Column::Location, locations[i]);
+            const std::string& pollutant = file.dictionaryValue(Column::Pollutant, pollutants[i]);
+            if ((!filter.location.empty() && location != filter.location) ||
+                (!filter.pollutant.empty() && pollutant != filter.pollutant) ||
+                (filter.year != 0 && file.yearMonth(dates[i]) / 100 != filter.year) ||
+                (filter.area && !filter.area->contains(file.locationPosition(locations[i]))))
+                continue;
+            // Only what a series is built from
+            rows.emplace_back(location, pollutant, levels[i], "", "", file.dateString(dates[i]));
+        }
+        timeSeries->add(rows);
+    }
+    timeSeries->add(std::vector<WaterSample>(data.begin() + pendingSeries.firstAppended, data.end()));
+    pendingSeries = PendingSeries();
+    return *timeSeries;
+}
+
+const std::vector<double>& WaterDataset::getAnomalyScores() const {
+    return anomalyScores;
+}
+
+size_t WaterDataset::approximateBytes() const {
+    size_t bytes = data.capacity() * sizeof(WaterSample) + anomalyScores.capacity() * sizeof(double);
+    for (const WaterSample& sample : data)
+        bytes += heapBytes(sample.getLocation()) + heapBytes(sample.getPollutant()) + heapBytes(sample.getUnit()) +
+                 heapBytes(sample.getComplianceStatus()) + heapBytes(sample.getSampleDate());
+    bytes += aggregates.approximateBytes() + sketches.approximateBytes() + spatialIndex.approximateBytes() +
+             anomalyDetector.approximateBytes() + source.columns.capacity() * sizeof(std::string);
+    if (timeSeries)
+        bytes += sizeof(TimeSeriesEngine) + timeSeries->approximateBytes();
+    // A file shared by both is counted once
+    if (pendingColumnar)
+        bytes += sizeof(columnar::ColumnarFile) + pendingColumnar->approximateBytes();
+    else if (pendingSeries.file)
+        bytes += sizeof(columnar::ColumnarFile) + pendingSeries.file->approximateBytes();
+    return bytes;
+}
+
+const SpatialIndex& WaterDataset::getSpatialIndex() const {
+    return spatialIndex;
+}
+
+const DatasetAggregates& WaterDataset::getAggregates() const {
+    buildPendingAggregates();
+    return aggregates;
+}
+
+const DatasetSketches& WaterDataset::getSketches() const {
+    buildPendingAggregates();
+    return sketches;
 }
 
 std::vector<PollutantSample> WaterDataset::loadPollutantSamples(const std::string& filename, int rowCount) {
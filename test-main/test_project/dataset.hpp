@@ -1,22 +1,129 @@
 #ifndef WATERDATASET_HPP
 #define WATERDATASET_HPP
 
+#include <memory>
 #include <vector>
 #include <string>
 #include "WaterSample.hpp"
 #include "PollutantSample.hpp"
+#include "DatasetAggregates.hpp"
+#include "Sketches.hpp"
+#include "StatsEngine.hpp"
+#include "ColumnarCache.hpp"
+#include "TimeSeries.hpp"
+#include "AnomalyDetector.hpp"
+#include "SpatialIndex.hpp"
+#include "Cancellation.hpp"
 
+namespace csv {
+class CSVRow;
+class CSVReader;
+}
+
+// The loaders taking a CancelToken check it as they go and throw
+// QueryCancelled once it is cancelled, leaving the dataset partly loaded.
 class WaterDataset {
 public:
-    void loadData(const std::string& filename);
+    // Reads the complete rows of filename; a partly written last row (or one
+    // without a final line break) is left for appendFromFile(). A line break
+    // inside a quoted field does not end a row.
+    void loadData(const std::string& filename, const CancelToken* cancel = nullptr);
+    // Loads several files, e.g. overlapping yearly exports, ordered by
+    // location, pollutant and time with exact duplicates removed
+    void loadMerged(const std::vector<std::string>& filenames);
+    // Puts the loaded rows in the loadMerged() order; returns the number of
+    // duplicates removed. Throws after streamQuery() or loadColumnar(): their
+    // data is a subset of the rows the aggregates, sketches and anomaly
+    // baselines cover, which could not be corrected from it.
+    size_t sortAndDeduplicate();
+    // Reads the files row by row without keeping them all. Aggregates and
+    // sketches cover every row and the returned statistics every row passing
+    // the filter, but only a uniform sample of at most sampleLimit matching
+    // rows is kept as the data, in file order. Unreadable files are skipped.
+    FilterResult streamQuery(const std::vector<std::string>& filenames, const ComplianceRules& rules,
+                             const SampleFilter& filter, size_t sampleLimit, const CancelToken* cancel = nullptr);
+    // Writes the loaded rows to a columnar cache file (see ColumnarCache.hpp),
+    // recording sourceBytes()
+    void saveColumnar(const std::string& path, uint32_t blockRows = columnar::DEFAULT_BLOCK_ROWS) const;
+    // Queries a columnar cache file written by saveColumnar(). The file is
+    // mapped and only the blocks and columns the filter needs are decoded;
+    // only the rows passing it are kept as the data, in file order. Aggregates
+    // and sketches cover every row and are built on first use. sourceBytes()
+    // is the one recorded when the file was written.
+    FilterResult loadColumnar(const std::string& path, const ComplianceRules& rules, const SampleFilter& filter,
+                              const CancelToken* cancel = nullptr);
     std::vector<WaterSample>& getData();
     void appendData(const std::vector<WaterSample>& newSamples);
+    // Appends the complete rows written to filename after byte offset (the
+    // end of the rows already read) and moves offset past them; a partly
+    // written last row, even one cut inside a quoted field, is left for the
+    // next call. Only the new bytes are
+    // read and parsed, with the delimiter and columns loadData() found.
+    // Returns the number of rows appended; throws when the file is shorter
+    // than offset, i.e. it was replaced or truncated.
+    size_t appendFromFile(const std::string& filename, uint64_t& offset);
+    // End of the CSV lines the rows were read from: set by loadData() and
+    // appendFromFile(), and kept in the columnar cache. Rows written to the
+    // CSV after it are not loaded yet. 0 for the other loads.
+    uint64_t sourceBytes() const { return source.bytes; }
     std::vector<PollutantSample> loadPollutantSamples(const std::string& filename, int rowCount = 10);
+    const DatasetAggregates& getAggregates() const;
+    const DatasetSketches& getSketches() const;
+    // Sampling points of the loaded rows by position, kept up to date on
+    // every load and append (for loadColumnar(), every point in the file)
+    const SpatialIndex& getSpatialIndex() const;
+    // Trend lines of the loaded rows, built on first use after each load and
+    // extended by appends. After loadColumnar() they cover every row of the
+    // filter's location, pollutant, year and area whatever its status, as
+    // loadData() keeps every row, so a status filter does not change them.
+    const TimeSeriesEngine& getTimeSeries() const;
+    // AnomalyDetector score of each row of getData(), computed as the rows
+    // are loaded or appended. streamQuery() scores every row it reads and
+    // loadColumnar() every row of the filter's location, pollutant and year,
+    // so the baselines do not depend on the status filter or the sampling.
+    const std::vector<double>& getAnomalyScores() const;
+    // Approximate heap bytes held: rows, scores, aggregates, sketches and
+    // every index built over them
+    size_t approximateBytes() const;
 
 private:
     std::vector<WaterSample> data;
     std::vector<PollutantSample> PollutantData;
+    // Maintained on every load/append, or built lazily from pendingColumnar
+    mutable DatasetAggregates aggregates;
+    mutable DatasetSketches sketches;
+    mutable std::shared_ptr<const columnar::ColumnarFile> pendingColumnar;
+    mutable std::unique_ptr<TimeSeriesEngine> timeSeries;
+    // What getTimeSeries() is built from after loadColumnar()
+    struct PendingSeries {
+        std::shared_ptr<const columnar::ColumnarFile> file;
+        SampleFilter filter; // The query's filter without its status
+        size_t firstAppended = 0; // Rows of data from here on were appended, not read from file
+    };
+    mutable PendingSeries pendingSeries;
+    SpatialIndex spatialIndex;
+    AnomalyDetector anomalyDetector;
+    std::vector<double> anomalyScores;
+    bool holdsEveryRow = true; // False when data is a sample or a filter's matches
     void checkDataExists() const;
+    void buildPendingAggregates() const;
+    void scoreAnomalies(size_t firstRow);
+    // Positions of the optional coordinate columns, -1 when absent
+    struct PositionColumns {
+        int easting = -1;
+        int northing = -1;
+    };
+    static PositionColumns positionColumns(const csv::CSVReader& reader);
+    static WaterSample sampleFromRow(const csv::CSVRow& row, const PositionColumns& columns);
+    // How much of a CSV was read, and how, so appended rows are parsed alike
+    struct CsvSource {
+        uint64_t bytes = 0;
+        char delimiter = ',';
+        std::vector<std::string> columns; // Empty until known
+    };
+    CsvSource source;
+    static CsvSource readRows(const std::string& filename, std::vector<WaterSample>& rows,
+                              const CancelToken* cancel = nullptr);
 };
 
 #endif // WATERDATASET_HPP
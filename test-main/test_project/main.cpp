@@ -1,7 +1,11 @@
 #include <QApplication>
 #include "ComplianceDashboard.hpp"
+#include "BatchCli.hpp"
 
 int main(int argc, char *argv[]) {
+    if (isBatchInvocation(argc, argv))
+        return runBatch(argc, argv);
+
     QApplication app(argc, argv);
 
     ComplianceDashboard dashboard;
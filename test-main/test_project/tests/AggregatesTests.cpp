@@ -0,0 +1,93 @@
+#include "Check.hpp"
+#include "TestData.hpp"
+#include "DatasetAggregates.hpp"
+#include "dataset.hpp"
+#include <algorithm>
+
+namespace {
+
+void checkSameSummary(const RunningStats& a, const RunningStats& b) {
+    CHECK(a.count == b.count);
+    CHECK_NEAR(a.sum, b.sum, 1e-6);
+    CHECK_NEAR(a.mean, b.mean, 1e-9);
+    CHECK_NEAR(a.variance(), b.variance(), 1e-6);
+    CHECK(a.min == b.min);
+    CHECK(a.max == b.max);
+}
+
+} // namespace
+
+TEST(summarizeMatchesTheLevelsOfTheMatchingRows) {
+    std::vector<WaterSample> samples = randomSamples(3000, 10);
+    DatasetAggregates aggregates;
+    aggregates.add(samples);
+
+    std::vector<double> levels;
+    for (const WaterSample& sample : samples)
+        if (sample.getPollutant() == "Nitrate" && sample.getYear() == 2024)
+            levels.push_back(sample.getLevel());
+    REQUIRE(levels.size() > 1);
+    double mean = 0.0;
+    for (double level : levels)
+        mean += level / static_cast<double>(levels.size());
+    double squares = 0.0;
+    for (double level : levels)
+        squares += (level - mean) * (level - mean);
+
+    RunningStats summary = aggregates.summarize("", "Nitrate", 2024);
+    CHECK(summary.count == levels.size());
+    CHECK_NEAR(summary.mean, mean, 1e-9);
+    CHECK_NEAR(summary.variance(), squares / static_cast<double>(levels.size() - 1), 1e-6);
+    CHECK(summary.min == *std::min_element(levels.begin(), levels.end()));
+    CHECK(summary.max == *std::max_element(levels.begin(), levels.end()));
+}
+
+TEST(aggregatesAddedInBatchesMatchOneBuild) {
+    std::vector<WaterSample> samples = randomSamples(4000, 11);
+    DatasetAggregates whole;
+    whole.add(samples);
+
+    DatasetAggregates first;
+    DatasetAggregates second;
+    DatasetAggregates appended;
+    for (size_t i = 0; i < samples.size(); ++i) {
+        (i < 1500 ? first : second).add(samples[i]);
+        appended.add(samples[i]);
+    }
+    first.merge(second);
+
+    CHECK(first.getCells().size() == whole.getCells().size());
+    for (const char* location : {"", "SITE 5", "SITE 3, \"UPPER\""}) {
+        for (const char* pollutant : {"", "pH", "Temperature"}) {
+            for (int year : {0, 2022, 2024}) {
+                checkSameSummary(first.summarize(location, pollutant, year),
+                                 whole.summarize(location, pollutant, year));
+                checkSameSummary(appended.summarize(location, pollutant, year),
+                                 whole.summarize(location, pollutant, year));
+            }
+        }
+    }
+}
+
+TEST(datasetAggregatesFollowAppendedRows) {
+    TempDirectory directory;
+    std::vector<WaterSample> samples = randomSamples(2000, 12);
+    std::vector<WaterSample> head(samples.begin(), samples.begin() + 1200);
+    std::vector<WaterSample> tail(samples.begin() + 1200, samples.end());
+    writeText(directory.path("head.csv"), csvText(head));
+    writeText(directory.path("all.csv"), csvText(samples));
+
+    WaterDataset appended;
+    appended.loadData(directory.path("head.csv"));
+    WaterDataset loadedTail;
+    writeText(directory.path("tail.csv"), csvText(tail));
+    loadedTail.loadData(directory.path("tail.csv"));
+    appended.appendData(loadedTail.getData());
+
+    WaterDataset whole;
+    whole.loadData(directory.path("all.csv"));
+    for (const char* pollutant : {"", "pH", "Ammonia(N)"})
+        for (int year : {0, 2023})
+            checkSameSummary(appended.getAggregates().summarize("", pollutant, year),
+                             whole.getAggregates().summarize("", pollutant, year));
+}
@@ -0,0 +1,116 @@
+#include "Check.hpp"
+#include "TestData.hpp"
+#include "AnomalyDetector.hpp"
+#include "dataset.hpp"
+#include <cmath>
+#include <map>
+
+namespace {
+
+// Scores of samples from one detector each
+std::vector<double> scoresOf(const std::vector<WaterSample>& samples) {
+    AnomalyDetector detector;
+    std::vector<double> scores;
+    for (const WaterSample& sample : samples)
+        scores.push_back(detector.add(sample));
+    return scores;
+}
+
+bool sameScores(const std::vector<double>& a, const std::vector<double>& b) {
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i)
+        if (!check::near(a[i], b[i], 0.0))
+            return false;
+    return true;
+}
+
+} // namespace
+
+TEST(anomalyScoresWarmUpAndFlagSpikes) {
+    AnomalyDetector detector;
+    for (uint32_t i = 0; i < AnomalyDetector::WARM_UP; ++i) {
+        CHECK(std::isnan(detector.add("SITE", "pH", 7.0 + 0.01 * (i % 3))));
+        // Missing levels neither score nor count towards the warm-up
+        CHECK(std::isnan(detector.add("SITE", "pH", std::nan(""))));
+    }
+    double usual = detector.add("SITE", "pH", 7.01);
+    CHECK(!std::isnan(usual) && !AnomalyDetector::isAnomaly(usual));
+    CHECK(AnomalyDetector::isAnomaly(detector.add("SITE", "pH", 12.0)));
+    // A series of its own, still warming up
+    CHECK(std::isnan(detector.add("SITE", "Nitrate", 120.0)));
+    CHECK(!AnomalyDetector::isAnomaly(std::nan("")));
+
+    // A flat series is not flagged for a change within the minimum spread
+    AnomalyDetector flat;
+    for (uint32_t i = 0; i < AnomalyDetector::WARM_UP; ++i)
+        flat.add("SITE", "Nitrate", 20.0);
+    CHECK(!AnomalyDetector::isAnomaly(flat.add("SITE", "Nitrate", 21.0)));
+    CHECK(AnomalyDetector::isAnomaly(flat.add("SITE", "Nitrate", 40.0)));
+}
+
+TEST(anomalyScoresDependOnlyOnTheirOwnSeries) {
+    std::vector<WaterSample> samples = randomSamples(20000, 130, 5);
+    std::vector<double> mixed = scoresOf(samples);
+
+    std::map<std::pair<std::string, std::string>, AnomalyDetector> alone;
+    size_t scored = 0;
+    for (size_t i = 0; i < samples.size(); ++i) {
+        AnomalyDetector& detector = alone[{samples[i].getLocation(), samples[i].getPollutant()}];
+        CHECK(check::near(detector.add(samples[i]), mixed[i], 0.0));
+        scored += !std::isnan(mixed[i]);
+    }
+    CHECK(scored == samples.size() - alone.size() * AnomalyDetector::WARM_UP);
+}
+
+TEST(datasetScoresAreTheSameLoadedOrAppended) {
+    TempDirectory directory;
+    std::vector<WaterSample> samples = randomSamples(6000, 131, 8);
+    std::vector<WaterSample> head(samples.begin(), samples.begin() + 2500);
+    std::vector<WaterSample> tail(samples.begin() + 2500, samples.end());
+    writeText(directory.path("all.csv"), csvText(samples));
+
+    WaterDataset loaded;
+    loaded.loadData(directory.path("all.csv"));
+    std::vector<double> expected = scoresOf(loaded.getData());
+    CHECK(sameScores(loaded.getAnomalyScores(), expected));
+
+    writeText(directory.path("grown.csv"), csvText(head));
+    WaterDataset grown;
+    grown.loadData(directory.path("grown.csv"));
+    uint64_t offset = grown.sourceBytes();
+    writeText(directory.path("grown.csv"), csvText(tail, false), true);
+    CHECK(grown.appendFromFile(directory.path("grown.csv"), offset) == tail.size());
+    CHECK(sameSamples(grown.getData(), loaded.getData()));
+    CHECK(sameScores(grown.getAnomalyScores(), expected));
+
+    WaterDataset appended;
+    appended.appendData(head);
+    appended.appendData(tail);
+    CHECK(sameScores(appended.getAnomalyScores(), scoresOf(appended.getData())));
+
+    // Sorting rescores the rows in their new order
+    loaded.sortAndDeduplicate();
+    CHECK(sameScores(loaded.getAnomalyScores(), scoresOf(loaded.getData())));
+}
+
+TEST(streamQueryScoresEveryRowRead) {
+    TempDirectory directory;
+    writeText(directory.path("all.csv"), csvText(randomSamples(6000, 132, 8)));
+    WaterDataset loaded;
+    loaded.loadData(directory.path("all.csv"));
+    std::vector<double> expected = scoresOf(loaded.getData());
+    ComplianceRules rules = testRules();
+
+    for (const SampleFilter& filter : testFilters()) {
+        FilterResult matches = computeStats(loaded.getData(), rules, filter);
+        std::vector<double> matchScores;
+        for (size_t row : matches.rows)
+            matchScores.push_back(expected[row]);
+
+        WaterDataset streamed;
+        streamed.streamQuery({directory.path("all.csv")}, rules, filter, matches.rows.size());
+        // Scored against every earlier row, not only the earlier matches
+        CHECK(sameScores(streamed.getAnomalyScores(), matchScores));
+    }
+}
@@ -0,0 +1,48 @@
+#include "Check.hpp"
+#include "TestData.hpp"
+#include "BatchCli.hpp"
+#include "csv.hpp"
+#include <iostream>
+#include <set>
+#include <sstream>
+
+namespace {
+
+// What runBatch() prints on stdout for the arguments
+std::string batchOutput(std::vector<std::string> arguments) {
+    arguments.insert(arguments.begin(), "test");
+    std::vector<char*> argv;
+    for (std::string& argument : arguments)
+        argv.push_back(&argument[0]);
+    std::ostringstream output;
+    std::streambuf* stdoutBuffer = std::cout.rdbuf(output.rdbuf());
+    int status = runBatch(static_cast<int>(argv.size()), argv.data());
+    std::cout.rdbuf(stdoutBuffer);
+    CHECK(status == 0);
+    return output.str();
+}
+
+} // namespace
+
+TEST(summaryFieldsSurviveQuotesInNames) {
+    TempDirectory directory;
+    std::vector<WaterSample> samples = randomSamples(2000, 210);
+    writeText(directory.path("samples.csv"), csvText(samples));
+    std::string output = batchOutput({"--summary", directory.path("samples.csv")});
+
+    // The first table, up to the blank line, read back as CSV
+    csv::CSVReader reader = csv::parse(output.substr(0, output.find("\n\n") + 1));
+    std::set<std::string> locations;
+    size_t rows = 0;
+    for (csv::CSVRow& row : reader) {
+        CHECK(row.size() == 6);
+        locations.insert(row["Location"].get<std::string>());
+        rows++;
+    }
+    std::set<std::string> expected;
+    for (const WaterSample& sample : samples)
+        expected.insert(sample.getLocation());
+    CHECK(locations == expected);
+    CHECK(expected.count("SITE 3, \"UPPER\"") == 1);
+    CHECK(rows > expected.size());
+}
@@ -0,0 +1,75 @@
+#include "Check.hpp"
+#include "TestData.hpp"
+#include "Cancellation.hpp"
+#include "dataset.hpp"
+#include <atomic>
+#include <thread>
+
+namespace {
+
+// Runs query and reports whether it threw QueryCancelled
+template <typename Query>
+bool cancels(Query query) {
+    try {
+        query();
+    } catch (const QueryCancelled&) {
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+TEST(cancelledQueriesStopAndOthersAreUnaffected) {
+    TempDirectory directory;
+    // More rows than loadData parses between checks
+    std::string path = directory.path("samples.csv");
+    writeText(path, csvText(randomSamples(20000, 160)));
+    WaterDataset loaded;
+    loaded.loadData(path);
+    loaded.saveColumnar(directory.path("samples.wqc"));
+    ComplianceRules rules = testRules();
+    SampleFilter filter = testFilters()[1];
+
+    CancelToken running;
+    WaterDataset dataset;
+    dataset.loadData(path, &running);
+    CHECK(sameSamples(dataset.getData(), loaded.getData()));
+    FilterResult expected = computeStats(loaded.getData(), rules, filter);
+    CHECK(sameStats(dataset.streamQuery({path}, rules, filter, 100, &running).stats, expected.stats));
+    CHECK(sameStats(dataset.loadColumnar(directory.path("samples.wqc"), rules, filter, &running).stats,
+                    expected.stats));
+
+    // Copies share the flag, so the owner's copy cancels the query's
+    CancelToken cancelled;
+    CancelToken copy = cancelled;
+    copy.cancel();
+    CHECK(cancelled.isCancelled() && !running.isCancelled());
+    CHECK(cancels([&] { dataset.loadData(path, &cancelled); }));
+    CHECK(cancels([&] { dataset.streamQuery({path}, rules, filter, 100, &cancelled); }));
+    CHECK(cancels([&] { dataset.loadColumnar(directory.path("samples.wqc"), rules, filter, &cancelled); }));
+}
+
+TEST(aQueryOnAnotherThreadStopsOnceCancelled) {
+    TempDirectory directory;
+    std::string path = directory.path("samples.csv");
+    writeText(path, csvText(randomSamples(20000, 161)));
+
+    CancelToken token;
+    std::atomic<int> loads(0);
+    std::atomic<bool> stopped(false);
+    std::thread worker([&, token] {
+        WaterDataset dataset;
+        stopped = cancels([&] {
+            for (;;) {
+                dataset.loadData(path, &token);
+                loads++;
+            }
+        });
+    });
+    while (loads == 0)
+        std::this_thread::yield();
+    token.cancel();
+    worker.join();
+    CHECK(stopped);
+}
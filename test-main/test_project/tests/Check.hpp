@@ -0,0 +1,61 @@
+#ifndef CHECK_HPP
+#define CHECK_HPP
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+// A small test runner, so the logic can be tested without Qt or a framework.
+// TEST(name) { ... } registers a test. CHECK records a failure and carries
+// on; REQUIRE also ends the test. A test that throws fails.
+namespace check {
+
+struct Test {
+    const char* name;
+    void (*run)();
+};
+
+std::vector<Test>& registry();
+
+struct Registration {
+    Registration(const char* name, void (*run)()) { registry().push_back(Test{name, run}); }
+};
+
+struct Stop {}; // Thrown by a failed REQUIRE
+
+void fail(const char* file, int line, const std::string& message);
+
+inline bool near(double a, double b, double tolerance) {
+    return (std::isnan(a) && std::isnan(b)) || std::fabs(a - b) <= tolerance;
+}
+
+} // namespace check
+
+#define TEST(name)                                                                                                 \
+    static void name();                                                                                            \
+    static const check::Registration name##Registration(#name, name);                                              \
+    static void name()
+
+#define CHECK(condition)                                                                                           \
+    do {                                                                                                           \
+        if (!(condition))                                                                                          \
+            check::fail(__FILE__, __LINE__, #condition);                                                           \
+    } while (0)
+
+#define REQUIRE(condition)                                                                                         \
+    do {                                                                                                           \
+        if (!(condition)) {                                                                                        \
+            check::fail(__FILE__, __LINE__, #condition);                                                           \
+            throw check::Stop();                                                                                   \
+        }                                                                                                          \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tolerance)                                                                                \
+    do {                                                                                                           \
+        double checkA = (a), checkB = (b);                                                                         \
+        if (!check::near(checkA, checkB, (tolerance)))                                                             \
+            check::fail(__FILE__, __LINE__,                                                                        \
+                        std::string(#a " near " #b ": ") + std::to_string(checkA) + " vs " + std::to_string(checkB)); \
+    } while (0)
+
+#endif // CHECK_HPP
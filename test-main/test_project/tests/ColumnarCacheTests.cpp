@@ -0,0 +1,259 @@
+#include "Check.hpp"
+#include "TestData.hpp"
+#include "ColumnarCache.hpp"
+#include "SampleTime.hpp"
+#include "TimeSeries.hpp"
+#include "dataset.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+
+using columnar::Column;
+using columnar::ColumnarFile;
+
+namespace {
+
+// Loads samples into dataset through a CSV, as the dashboard reads them
+void loadSamples(WaterDataset& dataset, const TempDirectory& directory, const std::vector<WaterSample>& samples) {
+    writeText(directory.path("samples.csv"), csvText(samples));
+    dataset.loadData(directory.path("samples.csv"));
+}
+
+} // namespace
+
+TEST(loadColumnarMatchesComputeStatsOverTheSameRows) {
+    TempDirectory directory;
+    WaterDataset loaded;
+    loadSamples(loaded, directory, randomSamples(6000, 80));
+    std::vector<WaterSample> rows = loaded.getData();
+    ComplianceRules rules = testRules();
+
+    for (uint32_t blockRows : {64u, 1000u, columnar::DEFAULT_BLOCK_ROWS}) {
+        std::string path = directory.path("samples.wqc");
+        loaded.saveColumnar(path, blockRows);
+        for (const SampleFilter& filter : testFilters()) {
+            FilterResult expected = computeStats(rows, rules, filter);
+            std::vector<WaterSample> matches;
+            for (size_t row : expected.rows)
+                matches.push_back(rows[row]);
+
+            WaterDataset cached;
+            FilterResult result = cached.loadColumnar(path, rules, filter);
+            CHECK(sameStats(result.stats, expected.stats));
+            CHECK(sameSamples(cached.getData(), matches));
+            CHECK(result.statuses == expected.statuses);
+            CHECK(result.rows.size() == matches.size());
+        }
+    }
+}
+
+TEST(zoneMapsBoundTheirBlocksAndSkipOnlyBlocksWithoutMatches) {
+    TempDirectory directory;
+    WaterDataset loaded;
+    loadSamples(loaded, directory, randomSamples(5000, 81));
+    // Grouped by location, so a location filter rules most blocks out
+    loaded.sortAndDeduplicate();
+    std::string path = directory.path("samples.wqc");
+    loaded.saveColumnar(path, 128);
+    const std::vector<WaterSample>& rows = loaded.getData();
+    ColumnarFile file(path);
+    ComplianceRules rules = testRules();
+    REQUIRE(file.rowCount() == rows.size());
+
+    size_t first = 0;
+    size_t skipped = 0;
+    for (size_t block = 0; block < file.blockCount(); ++block) {
+        const columnar::ZoneMap& zone = file.zoneMap(block);
+        for (size_t row = first; row < first + zone.rows; ++row) {
+            const WaterSample& sample = rows[row];
+            CHECK(sample.getLevel() >= zone.minLevel && sample.getLevel() <= zone.maxLevel);
+            CHECK(sample.getYearMonth() >= zone.minYearMonth && sample.getYearMonth() <= zone.maxYearMonth);
+            CHECK(std::binary_search(zone.locations.begin(), zone.locations.end(),
+                                     static_cast<uint32_t>(file.findId(Column::Location, sample.getLocation()))));
+        }
+        for (const SampleFilter& filter : testFilters()) {
+            bool matches = false;
+            for (size_t row = first; row < first + zone.rows; ++row)
+                matches |= computeStats(std::vector<WaterSample>{rows[row]}, rules, filter, 1).rows.size() == 1;
+            bool mayMatch = file.blockMayMatch(block, filter, rules);
+            CHECK(mayMatch || !matches);
+            skipped += !mayMatch;
+        }
+        first += zone.rows;
+    }
+    CHECK(first == rows.size());
+    CHECK(skipped > 0);
+}
+
+TEST(columnarLoadBuildsAggregatesOverEveryRowOnFirstUse) {
+    TempDirectory directory;
+    WaterDataset loaded;
+    loadSamples(loaded, directory, randomSamples(4000, 82));
+    std::string path = directory.path("samples.wqc");
+    loaded.saveColumnar(path, 500);
+
+    SampleFilter narrow;
+    narrow.location = "SITE 5";
+    WaterDataset cached;
+    cached.loadColumnar(path, testRules(), narrow);
+    CHECK(cached.getData().size() < loaded.getData().size());
+    CHECK(cached.sourceBytes() == loaded.sourceBytes());
+    CHECK(cached.sourceBytes() > 0);
+
+    for (const char* pollutant : {"", "Nitrate"}) {
+        for (int year : {0, 2022}) {
+            RunningStats expected = loaded.getAggregates().summarize("", pollutant, year);
+            RunningStats built = cached.getAggregates().summarize("", pollutant, year);
+            CHECK(built.count == expected.count);
+            CHECK_NEAR(built.mean, expected.mean, 1e-9);
+            CHECK(built.min == expected.min);
+            CHECK(built.max == expected.max);
+            CHECK_NEAR(cached.getSketches().distinctSamplingPoints(pollutant, year),
+                       loaded.getSketches().distinctSamplingPoints(pollutant, year), 1e-9);
+        }
+    }
+    CHECK(cached.getSpatialIndex().size() == loaded.getSpatialIndex().size());
+    for (const auto& point : loaded.getSpatialIndex().points()) {
+        GridPoint found = cached.getSpatialIndex().find(point.first);
+        CHECK(found.easting == point.second.easting && found.northing == point.second.northing);
+    }
+}
+
+TEST(trendSeriesAreTheSameFromTheCsvOrTheCache) {
+    TempDirectory directory;
+    // One year, as the dashboard's files hold
+    std::vector<WaterSample> samples;
+    for (const WaterSample& sample : randomSamples(12000, 83, 8))
+        if (sample.getYear() == 2023)
+            samples.push_back(sample);
+    std::vector<WaterSample> head(samples.begin(), samples.begin() + samples.size() / 2);
+    std::vector<WaterSample> tail(samples.begin() + samples.size() / 2, samples.end());
+    std::string csvPath = directory.path("samples.csv");
+    writeText(csvPath, csvText(head));
+    WaterDataset loaded;
+    loaded.loadData(csvPath);
+    loaded.saveColumnar(directory.path("samples.wqc"), 300);
+
+    std::vector<SampleFilter> filters(3);
+    filters[0].location = "SITE 3, \"UPPER\"";
+    filters[0].pollutant = "pH";
+    filters[0].status = ComplianceStatus::Bad;
+    filters[1] = filters[0];
+    filters[1].year = 2023;
+    filters[2].location = "SITE 5";
+    filters[2].pollutant = "Nitrate";
+    filters[2].status = ComplianceStatus::Good;
+    filters[2].area = SpatialArea::box(GridBox{400000, 500000, 460000, 560000});
+
+    auto checkSame = [](const TimeSeries& actual, const TimeSeries& expected) {
+        REQUIRE(actual.size() == expected.size());
+        CHECK(actual.times == expected.times);
+        CHECK(actual.counts == expected.counts);
+        for (size_t i = 0; i < actual.size(); ++i)
+            CHECK_NEAR(actual.values[i], expected.values[i], 1e-9);
+    };
+    for (const SampleFilter& filter : filters) {
+        WaterDataset cached;
+        cached.loadColumnar(directory.path("samples.wqc"), testRules(), filter);
+        const TimeSeries& expected = loaded.getTimeSeries().series(filter.location, filter.pollutant);
+        // The status filter narrows the data but not the series
+        CHECK(cached.getData().size() < expected.size());
+        checkSame(cached.getTimeSeries().series(filter.location, filter.pollutant), expected);
+    }
+
+    // Rows appended before the series is first built are in it too
+    WaterDataset cached;
+    cached.loadColumnar(directory.path("samples.wqc"), testRules(), filters[0]);
+    writeText(csvPath, csvText(tail, false), true);
+    uint64_t offset = cached.sourceBytes();
+    CHECK(cached.appendFromFile(csvPath, offset) == tail.size());
+    WaterDataset whole;
+    whole.loadData(csvPath);
+    checkSame(cached.getTimeSeries().series(filters[0].location, filters[0].pollutant),
+              whole.getTimeSeries().series(filters[0].location, filters[0].pollutant));
+}
+
+TEST(columnarFileRejectsTruncatedAndForeignFiles) {
+    TempDirectory directory;
+    WaterDataset loaded;
+    loadSamples(loaded, directory, randomSamples(500, 83));
+    std::string path = directory.path("samples.wqc");
+    loaded.saveColumnar(path);
+    std::string bytes;
+    {
+        std::ifstream file(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    auto rejects = [&directory](const std::string& contents) {
+        std::string bad = directory.path("bad.wqc");
+        writeText(bad, contents);
+        try {
+            ColumnarFile file(bad);
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+    CHECK(rejects(""));
+    CHECK(rejects(bytes.substr(0, 20)));
+    CHECK(rejects(bytes.substr(0, bytes.size() / 2)));
+    CHECK(rejects(std::string(bytes.size(), 'x')));
+    CHECK(!rejects(bytes));
+}
+
+TEST(codecsRoundTripEveryKindOfColumn) {
+    // One block per kind of column, so each chunk is packed its own way
+    const uint32_t blockRows = 256;
+    std::vector<WaterSample> samples;
+    auto add = [&samples](const std::string& location, double level, const std::string& date) {
+        WaterSample sample = makeSample(location, samples.size() % 3 ? "Nitrate" : "pH", level, date);
+        size_t site = std::hash<std::string>()(location) % 1000;
+        if (site % 10 != 0)
+            sample.setPosition(400000.0 + site, 500000.0 + site * 3);
+        samples.push_back(sample);
+    };
+    for (uint32_t i = 0; i < blockRows; ++i) // Constant level and location, dates a minute apart
+        add("ONE SITE", 7.25, sampletime::format(1700000000 + 60 * i));
+    for (uint32_t i = 0; i < blockRows; ++i) // Thousandths, shuffled dates
+        add("SITE " + std::to_string(i % 7), (i * 7919 % 100000) / 1000.0,
+            sampletime::format(1600000000 + static_cast<int64_t>(i * 104729 % 5000) * 3600));
+    for (uint32_t i = 0; i < blockRows; ++i) // Not decimal: stored as they are
+        add("SITE " + std::to_string(i), 1.0 / (i + 3) - (i % 2 ? 1e9 : 0.0), "2024-02-29T23:59:59");
+    for (uint32_t i = 0; i < blockRows; ++i) // Negative, huge and NaN levels, odd dates
+        add("SITE " + std::to_string(i * 13), i % 5 == 0 ? std::nan("") : (i % 2 ? -1.0 : 1.0) * i * 1e7,
+            i % 3 == 0 ? "not a date" : i % 3 == 1 ? "2023-02-30T00:00:00" : "1900-01-01T00:00:00");
+    samples.push_back(samples.front()); // A last block of one row
+
+    TempDirectory directory;
+    std::string path = directory.path("codecs.wqc");
+    columnar::writeFile(path, samples, blockRows, 1234);
+
+    ColumnarFile file(path);
+    REQUIRE(file.rowCount() == samples.size());
+    CHECK(file.blockCount() == 5);
+    CHECK(file.sourceBytes() == 1234);
+    size_t row = 0;
+    for (size_t block = 0; block < file.blockCount(); ++block) {
+        std::vector<uint32_t> locations = file.readIds(block, Column::Location);
+        std::vector<uint32_t> pollutants = file.readIds(block, Column::Pollutant);
+        std::vector<double> levels = file.readLevels(block);
+        std::vector<int64_t> dates = file.readDates(block);
+        REQUIRE(levels.size() == file.zoneMap(block).rows);
+        for (size_t i = 0; i < levels.size(); ++i, ++row) {
+            const WaterSample& sample = samples[row];
+            CHECK(file.dictionaryValue(Column::Location, locations[i]) == sample.getLocation());
+            CHECK(file.dictionaryValue(Column::Pollutant, pollutants[i]) == sample.getPollutant());
+            CHECK(levels[i] == sample.getLevel() || (std::isnan(levels[i]) && std::isnan(sample.getLevel())));
+            CHECK(file.dateString(dates[i]) == sample.getSampleDate());
+            CHECK(file.yearMonth(dates[i]) == sample.getYearMonth());
+        }
+    }
+
+    WaterDataset cached;
+    cached.loadColumnar(path, testRules(), SampleFilter());
+    CHECK(sameSamples(cached.getData(), samples));
+}
@@ -0,0 +1,248 @@
+#include "Check.hpp"
+#include "TestData.hpp"
+#include "csv.hpp"
+#include <random>
+#include <sstream>
+#include <thread>
+
+TEST(csvStatRowParallelMatchesPerColumnMode) {
+    std::string text = csvText(randomSamples(30000, 30));
+    std::stringstream columnSource(text);
+    std::stringstream rowSource(text);
+    csv::CSVStat perColumn(columnSource, csv::CSVFormat());
+    csv::CSVStat rowParallel(rowSource, csv::CSVFormat(), 4);
+
+    REQUIRE(perColumn.get_col_names() == rowParallel.get_col_names());
+    auto means = perColumn.get_mean();
+    auto variances = perColumn.get_variance();
+    auto parallelMeans = rowParallel.get_mean();
+    auto parallelVariances = rowParallel.get_variance();
+    REQUIRE(means.size() == parallelMeans.size());
+    for (size_t column = 0; column < means.size(); ++column) {
+        CHECK_NEAR(static_cast<double>(parallelMeans[column]), static_cast<double>(means[column]),
+                   1e-9 * (1 + std::fabs(static_cast<double>(means[column]))));
+        CHECK_NEAR(static_cast<double>(parallelVariances[column]), static_cast<double>(variances[column]),
+                   1e-6 * (1 + std::fabs(static_cast<double>(variances[column]))));
+    }
+    auto mins = perColumn.get_mins();
+    auto maxes = perColumn.get_maxes();
+    auto parallelMins = rowParallel.get_mins();
+    auto parallelMaxes = rowParallel.get_maxes();
+    for (size_t column = 0; column < mins.size(); ++column) {
+        CHECK_NEAR(static_cast<double>(parallelMins[column]), static_cast<double>(mins[column]), 0.0);
+        CHECK_NEAR(static_cast<double>(parallelMaxes[column]), static_cast<double>(maxes[column]), 0.0);
+    }
+    // Counting stops for columns with too many distinct values, after a
+    // different number of rows in each mode, so only full counts compare
+    auto counts = perColumn.get_counts();
+    auto parallelCounts = rowParallel.get_counts();
+    for (size_t column = 0; column < counts.size(); ++column)
+        if (counts[column].size() <= 500)
+            CHECK(parallelCounts[column] == counts[column]);
+    CHECK(rowParallel.get_dtypes() == perColumn.get_dtypes());
+}
+
+TEST(spscRingHandsItemsOverInOrder) {
+    csv::internals::SPSCRing<size_t> ring(4, 16);
+    const size_t count = 200000;
+    ring.notify_all();
+    std::thread producer([&ring, count] {
+        for (size_t i = 0; i < count; ++i)
+            ring.push_back(size_t(i));
+        ring.kill_all();
+    });
+
+    size_t expected = 0;
+    bool inOrder = true;
+    for (bool done = false; !done;) {
+        ring.wait();
+        // Everything is published before the producer stops
+        done = !ring.is_waitable();
+        while (!ring.empty())
+            inOrder &= ring.pop_front() == expected++;
+    }
+    producer.join();
+    CHECK(inOrder);
+    CHECK(expected == count);
+}
+
+TEST(spscRingGrowsWithoutAConsumerAndReleasesAnAbandonedProducer) {
+    // Nobody listening: the producer grows the ring instead of blocking
+    csv::internals::SPSCRing<size_t> unheard(2, 4);
+    for (size_t i = 0; i < 1000; ++i)
+        unheard.push_back(size_t(i));
+    unheard.flush();
+    size_t expected = 0;
+    while (!unheard.empty())
+        CHECK(unheard.pop_front() == expected++);
+    CHECK(expected == 1000);
+
+    // A producer blocked on a full ring returns once the consumer gives up
+    csv::internals::SPSCRing<size_t> ring(2, 1);
+    ring.notify_all();
+    std::thread producer([&ring] {
+        for (size_t i = 0; i < 1000; ++i)
+            ring.push_back(size_t(i));
+        ring.kill_all();
+    });
+    ring.wait();
+    ring.abandon();
+    producer.join();
+    CHECK(ring.is_abandoned());
+}
+
+namespace {
+
+// Rows of random fields with delimiters, quotes, line breaks and UTF-8 at
+// every offset, so the scanner's vector blocks split them every way
+std::vector<std::vector<std::string>> randomTable(size_t rows, size_t columns, uint32_t seed) {
+    const std::string alphabet[] = {"a", "b", "7", " ", ",", ";", "\"", "\n", "\r\n", "\xc3\xa9", "xxxxxxxxxxxxxxxx"};
+    std::mt19937 random(seed);
+    std::vector<std::vector<std::string>> table(rows, std::vector<std::string>(columns));
+    for (auto& row : table) {
+        for (std::string& field : row) {
+            size_t length = random() % 4 == 0 ? random() % 80 : random() % 6;
+            for (size_t i = 0; i < length; ++i)
+                field += alphabet[random() % 11];
+        }
+    }
+    return table;
+}
+
+std::string tableText(const std::vector<std::vector<std::string>>& table, char delimiter, uint32_t seed) {
+    std::mt19937 random(seed);
+    std::string text;
+    for (size_t column = 0; column < table[0].size(); ++column)
+        text += (column ? std::string(1, delimiter) : "") + "c" + std::to_string(column);
+    text += "\n";
+    for (const auto& row : table) {
+        for (size_t column = 0; column < row.size(); ++column) {
+            if (column)
+                text += delimiter;
+            const std::string& field = row[column];
+            if (field.find_first_of(std::string("\"\r\n") + delimiter) == std::string::npos) {
+                text += field;
+                continue;
+            }
+            text += '"';
+            for (char c : field)
+                text += c == '"' ? "\"\"" : std::string(1, c);
+            text += '"';
+        }
+        text += random() % 2 ? "\r\n" : "\n";
+    }
+    return text;
+}
+
+std::vector<std::vector<std::string>> readTable(csv::CSVReader& reader) {
+    std::vector<std::vector<std::string>> table;
+    for (csv::CSVRow& row : reader) {
+        table.emplace_back();
+        for (csv::CSVField field : row)
+            table.back().push_back(field.get<std::string>());
+    }
+    return table;
+}
+
+} // namespace
+
+TEST(scannerFindsEveryFieldOfQuotedText) {
+    TempDirectory directory;
+    for (uint32_t seed = 0; seed < 8; ++seed) {
+        char delimiter = seed % 2 ? ';' : ',';
+        // Two columns or more: a one-column row left empty is a blank line, which is skipped
+        std::vector<std::vector<std::string>> table = randomTable(2000, 2 + seed % 5, seed);
+        std::string text = tableText(table, delimiter, seed);
+
+        csv::CSVReader parsed = csv::parse(text, csv::CSVFormat().delimiter(delimiter));
+        CHECK(readTable(parsed) == table);
+
+        std::string path = directory.path("table.csv");
+        writeText(path, text);
+        csv::CSVReader mapped(path, csv::CSVFormat().delimiter(delimiter));
+        CHECK(readTable(mapped) == table);
+    }
+}
+
+TEST(scannerHandlesFieldsAroundVectorBoundaries) {
+    // A delimiter, quote or line break at each position of a 64-byte span
+    for (size_t position = 0; position < 64; ++position) {
+        for (const char* special : {",", "\"\"", "\n"}) {
+            std::string field(position, 'x');
+            field += special[0] == '"' ? "\"" : special;
+            field += std::string(64 - position, 'y');
+            std::vector<std::vector<std::string>> table = {{field, "z"}, {"", field}};
+            csv::CSVReader reader = csv::parse(tableText(table, ',', 0));
+            CHECK(readTable(reader) == table);
+        }
+    }
+}
+
+TEST(rowsKeptByTheReaderOutliveTheirRecycledChunks) {
+    // Small chunks, so most are recycled while some of their rows are held
+    TempDirectory directory;
+    std::vector<std::vector<std::string>> table = randomTable(20000, 4, 40);
+    std::string path = directory.path("table.csv");
+    writeText(path, tableText(table, ',', 40));
+
+    std::vector<csv::CSVRow> kept;
+    csv::CSVReader reader(path, csv::CSVFormat().chunk_size(csv::internals::MIN_CHUNK_SIZE));
+    size_t read = 0;
+    for (csv::CSVRow& row : reader)
+        if (read++ % 97 == 0)
+            kept.push_back(row);
+
+    CHECK(read == table.size());
+    for (size_t i = 0; i < kept.size(); ++i) {
+        std::vector<std::string> fields;
+        for (csv::CSVField field : kept[i])
+            fields.push_back(field.get<std::string>());
+        CHECK(fields == table[i * 97]);
+    }
+}
+
+TEST(readerGivesTheSameRowsWithAnyChunkingOrThreading) {
+    // Fields cut off at chunk ends are parsed again from the next chunk
+    TempDirectory directory;
+    std::vector<std::vector<std::string>> table = randomTable(20000, 3, 50);
+    std::string text = tableText(table, ',', 50);
+    std::string path = directory.path("table.csv");
+    writeText(path, text);
+
+    const size_t chunk = csv::internals::MIN_CHUNK_SIZE;
+    for (csv::CSVFormat format : {csv::CSVFormat(), csv::CSVFormat().threading(false),
+                                  csv::CSVFormat().chunk_size(chunk), csv::CSVFormat().chunk_size(chunk).read_ahead(1),
+                                  csv::CSVFormat().chunk_size(chunk + 7).threading(false),
+                                  csv::CSVFormat().auto_tune()}) {
+        csv::CSVReader mapped(path, format);
+        CHECK(readTable(mapped) == table);
+        std::stringstream stream(text);
+        csv::CSVReader streamed(stream, format);
+        CHECK(readTable(streamed) == table);
+        csv::CSVReader parsed = csv::parse(text, format);
+        CHECK(readTable(parsed) == table);
+    }
+}
+
+TEST(readerLeftEarlyStopsItsParsingThread) {
+    // The parsing thread may be blocked on a full ring when the reader goes
+    TempDirectory directory;
+    std::vector<std::vector<std::string>> table = randomTable(20000, 3, 60);
+    std::string path = directory.path("table.csv");
+    writeText(path, tableText(table, ',', 60));
+
+    for (size_t stopAfter : {0u, 1u, 500u, 5000u}) {
+        csv::CSVReader reader(path, csv::CSVFormat().chunk_size(csv::internals::MIN_CHUNK_SIZE).read_ahead(1));
+        size_t read = 0;
+        for (csv::CSVRow& row : reader) {
+            if (read == stopAfter)
+                break;
+            std::vector<std::string> fields;
+            for (csv::CSVField field : row)
+                fields.push_back(field.get<std::string>());
+            CHECK(fields == table[read]);
+            read++;
+        }
+        CHECK(read == stopAfter);
+    }
+}
@@ -0,0 +1,157 @@
+#include "Check.hpp"
+#include "TestData.hpp"
+#include "dataset.hpp"
+#include "StatsEngine.hpp"
+#include <stdexcept>
+
+namespace {
+
+// The rows a load of path keeps, as loadData() reads them
+std::vector<WaterSample> loadedRows(const std::string& path) {
+    WaterDataset dataset;
+    dataset.loadData(path);
+    return dataset.getData();
+}
+
+// True if part is a subsequence of whole
+bool inOrderWithin(const std::vector<WaterSample>& part, const std::vector<WaterSample>& whole) {
+    size_t next = 0;
+    for (const WaterSample& sample : part) {
+        while (next < whole.size() && !sameSample(whole[next], sample))
+            next++;
+        if (next++ == whole.size())
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(streamQueryCountsEveryRowAndSamplesTheMatches) {
+    TempDirectory directory;
+    std::vector<WaterSample> samples = randomSamples(8000, 70);
+    std::vector<std::string> files = {directory.path("a.csv"), directory.path("b.csv")};
+    writeText(files[0], csvText(std::vector<WaterSample>(samples.begin(), samples.begin() + 5000)));
+    writeText(files[1], csvText(std::vector<WaterSample>(samples.begin() + 5000, samples.end())));
+    std::vector<WaterSample> rows = loadedRows(files[0]);
+    std::vector<WaterSample> second = loadedRows(files[1]);
+    rows.insert(rows.end(), second.begin(), second.end());
+    ComplianceRules rules = testRules();
+
+    for (const SampleFilter& filter : testFilters()) {
+        FilterResult expected = computeStats(rows, rules, filter);
+        std::vector<WaterSample> matches;
+        for (size_t row : expected.rows)
+            matches.push_back(rows[row]);
+
+        for (size_t limit : {size_t(50), matches.size()}) {
+            WaterDataset dataset;
+            FilterResult result = dataset.streamQuery(files, rules, filter, limit);
+            CHECK(sameStats(result.stats, expected.stats));
+            CHECK(dataset.getData().size() == std::min(limit, matches.size()));
+            CHECK(result.rows.size() == dataset.getData().size());
+            CHECK(inOrderWithin(dataset.getData(), matches));
+            if (limit == matches.size())
+                CHECK(sameSamples(dataset.getData(), matches));
+            // Aggregates cover every row read, not only the sample
+            CHECK(dataset.getAggregates().summarize("", "", 0).count == rows.size());
+        }
+    }
+}
+
+TEST(appendFromFileWaitsForAPartlyWrittenLine) {
+    TempDirectory directory;
+    std::string path = directory.path("growing.csv");
+    std::vector<WaterSample> samples = randomSamples(3000, 140);
+    std::vector<WaterSample> head(samples.begin(), samples.begin() + 1000);
+    std::vector<WaterSample> tail(samples.begin() + 1000, samples.end());
+
+    for (char delimiter : {',', ';'}) {
+        writeText(path, csvText(head, true, delimiter));
+        WaterDataset dataset;
+        dataset.loadData(path);
+        uint64_t offset = dataset.sourceBytes();
+        CHECK(dataset.appendFromFile(path, offset) == 0);
+
+        // The last line is cut in two, the way a writer may leave it
+        std::string text = csvText(tail, false, delimiter);
+        size_t cut = text.rfind('\n', text.size() - 2) + 20;
+        writeText(path, text.substr(0, cut), true);
+        CHECK(dataset.appendFromFile(path, offset) == tail.size() - 1);
+        CHECK(offset == dataset.sourceBytes());
+        CHECK(dataset.appendFromFile(path, offset) == 0);
+        writeText(path, text.substr(cut), true);
+        CHECK(dataset.appendFromFile(path, offset) == 1);
+        CHECK(sameSamples(dataset.getData(), loadedRows(path)));
+        CHECK(dataset.getAggregates().summarize("", "", 0).count == samples.size());
+
+        // A file replaced by a shorter one is not read from the old offset
+        writeText(path, csvText(head, true, delimiter));
+        bool threw = false;
+        try {
+            dataset.appendFromFile(path, offset);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+}
+
+TEST(rowsEndOnlyAtLineBreaksOutsideQuotes) {
+    TempDirectory directory;
+    std::string path = directory.path("growing.csv");
+    // A name over two lines, with an escaped quote, starts the tail and ends it
+    const std::string name = "SITE \"NEW\"\nLOWER";
+    std::vector<WaterSample> head = randomSamples(500, 142);
+    std::vector<WaterSample> tail = randomSamples(300, 143);
+    tail.front() = makeSample(name, "pH", 7.5, "2023-05-01T10:00:00");
+    tail.back() = makeSample(name, "Nitrate", 12.5, "2023-06-01T10:00:00");
+    std::string headText = csvText(head);
+    std::string tailText = csvText(tail, false);
+
+    // Written up to just after the line break inside the first name
+    size_t firstCut = tailText.find("LOWER");
+    writeText(path, headText + tailText.substr(0, firstCut));
+    WaterDataset dataset;
+    dataset.loadData(path);
+    CHECK(dataset.getData().size() == head.size());
+    uint64_t offset = dataset.sourceBytes();
+    CHECK(offset == headText.size());
+    CHECK(dataset.appendFromFile(path, offset) == 0);
+    CHECK(offset == headText.size());
+
+    // Then up to just after the one inside the last
+    size_t lastCut = tailText.rfind("LOWER");
+    writeText(path, tailText.substr(firstCut, lastCut - firstCut), true);
+    CHECK(dataset.appendFromFile(path, offset) == tail.size() - 1);
+    writeText(path, tailText.substr(lastCut), true);
+    CHECK(dataset.appendFromFile(path, offset) == 1);
+
+    std::vector<WaterSample> rows = loadedRows(path);
+    CHECK(rows.size() == head.size() + tail.size());
+    CHECK(sameSamples(dataset.getData(), rows));
+    CHECK(rows[head.size()].getLocation() == name);
+    CHECK(rows.back().getLocation() == name);
+}
+
+TEST(appendFromFileCarriesOnFromTheColumnarCache) {
+    TempDirectory directory;
+    std::string path = directory.path("growing.csv");
+    std::vector<WaterSample> samples = randomSamples(3000, 141);
+    std::vector<WaterSample> head(samples.begin(), samples.begin() + 2000);
+    std::vector<WaterSample> tail(samples.begin() + 2000, samples.end());
+    writeText(path, csvText(head));
+
+    WaterDataset loaded;
+    loaded.loadData(path);
+    loaded.saveColumnar(directory.path("growing.wqc"));
+    writeText(path, csvText(tail, false), true);
+
+    // The cache records where the CSV rows it holds end
+    WaterDataset cached;
+    cached.loadColumnar(directory.path("growing.wqc"), testRules(), SampleFilter());
+    CHECK(cached.sourceBytes() == loaded.sourceBytes());
+    uint64_t offset = cached.sourceBytes();
+    CHECK(cached.appendFromFile(path, offset) == tail.size());
+    CHECK(sameSamples(cached.getData(), loadedRows(path)));
+}
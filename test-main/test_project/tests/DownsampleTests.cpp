@@ -0,0 +1,125 @@
+#include "Check.hpp"
+#include "Downsample.hpp"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+
+namespace {
+
+const double SPIKE = 1e6;
+
+// A noisy daily series with NaN gaps and one spike
+TimeSeries noisySeries(size_t count, unsigned seed, size_t spikeAt) {
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<double> noise(0.0, 1.0);
+    TimeSeries series;
+    for (size_t i = 0; i < count; ++i) {
+        series.times.push_back(static_cast<int64_t>(i) * 86400);
+        series.values.push_back(i == spikeAt ? SPIKE : i % 97 < 5 ? std::nan("") : noise(random));
+        series.counts.push_back(std::isnan(series.values.back()) ? 0 : 1);
+    }
+    return series;
+}
+
+std::vector<SeriesPoint> points(const TimeSeries& series) {
+    std::vector<SeriesPoint> result;
+    for (size_t i = 0; i < series.size(); ++i)
+        if (!std::isnan(series.values[i]))
+            result.push_back(SeriesPoint{series.times[i], series.values[i]});
+    return result;
+}
+
+bool hasSpike(const std::vector<SeriesPoint>& sampled) {
+    return std::any_of(sampled.begin(), sampled.end(), [](const SeriesPoint& point) { return point.value == SPIKE; });
+}
+
+} // namespace
+
+TEST(lttbKeepsTheEndsTheSpikeAndThresholdPoints) {
+    std::vector<SeriesPoint> input = points(noisySeries(10000, 120, 4321));
+    std::map<int64_t, double> byTime;
+    for (const SeriesPoint& point : input)
+        byTime[point.time] = point.value;
+
+    for (size_t threshold : {3, 10, 500, 9000}) {
+        std::vector<SeriesPoint> sampled = lttb(input, threshold);
+        REQUIRE(sampled.size() == threshold);
+        CHECK(sampled.front().time == input.front().time);
+        CHECK(sampled.back().time == input.back().time);
+        for (size_t i = 0; i < sampled.size(); ++i) {
+            CHECK(i == 0 || sampled[i - 1].time < sampled[i].time);
+            auto original = byTime.find(sampled[i].time);
+            CHECK(original != byTime.end() && original->second == sampled[i].value);
+        }
+        if (threshold > 3)
+            CHECK(hasSpike(sampled));
+    }
+
+    std::vector<SeriesPoint> few(input.begin(), input.begin() + 50);
+    std::vector<SeriesPoint> same = lttb(few, 50);
+    CHECK(same.size() == 50);
+    CHECK(std::equal(same.begin(), same.end(), few.begin(),
+                     [](const SeriesPoint& a, const SeriesPoint& b) { return a.time == b.time && a.value == b.value; }));
+}
+
+TEST(pyramidQueriesStayInBoundsAndKeepSpikes) {
+    const size_t count = 100000;
+    const int64_t spikeTime = int64_t{77777} * 86400;
+    TimeSeries series = noisySeries(count, 121, 77777);
+    std::vector<SeriesPoint> input = points(series);
+    std::map<int64_t, double> byTime;
+    for (const SeriesPoint& point : input)
+        byTime[point.time] = point.value;
+
+    SeriesPyramid pyramid(series);
+    CHECK(pyramid.levelCount() > 3);
+    CHECK(pyramid.firstTime() == input.front().time);
+    CHECK(pyramid.lastTime() == input.back().time);
+
+    std::mt19937 random(122);
+    std::uniform_int_distribution<int64_t> day(-100, static_cast<int64_t>(count) + 100);
+    for (int query = 0; query < 300; ++query) {
+        int64_t from = day(random) * 86400;
+        int64_t to = from + day(random) * 86400 / (query % 3 == 0 ? 200 : 1);
+        size_t maxPoints = 3 + query % 400;
+        std::vector<SeriesPoint> sampled = pyramid.query(from, to, maxPoints);
+        CHECK(sampled.size() <= maxPoints);
+
+        auto inFirst = std::lower_bound(input.begin(), input.end(), from,
+                                        [](const SeriesPoint& point, int64_t time) { return point.time < time; });
+        auto inLast = std::upper_bound(input.begin(), input.end(), to,
+                                       [](int64_t time, const SeriesPoint& point) { return time < point.time; });
+        if (inFirst == inLast) {
+            // Nothing in range: at most the neighbours either side
+            CHECK(sampled.size() <= 2);
+            continue;
+        }
+        REQUIRE(!sampled.empty());
+        for (size_t i = 0; i < sampled.size(); ++i) {
+            CHECK(i == 0 || sampled[i - 1].time < sampled[i].time);
+            auto original = byTime.find(sampled[i].time);
+            CHECK(original != byTime.end() && original->second == sampled[i].value);
+            // Only the ends may lie outside the range
+            if (i > 0 && i + 1 < sampled.size())
+                CHECK(sampled[i].time >= from && sampled[i].time <= to);
+        }
+
+        // Few enough points in range are returned exactly, with a neighbour
+        // at either end
+        size_t first = inFirst - input.begin();
+        size_t last = inLast - input.begin();
+        first = first > 0 ? first - 1 : 0;
+        last = std::min(last + 1, input.size());
+        if (last - first <= maxPoints) {
+            REQUIRE(sampled.size() == last - first);
+            for (size_t i = 0; i < sampled.size(); ++i)
+                CHECK(sampled[i].time == input[first + i].time);
+        }
+        if (from <= spikeTime && to >= spikeTime && maxPoints > 3)
+            CHECK(hasSpike(sampled));
+    }
+
+    CHECK(pyramid.query(10, 5, 100).empty());
+    CHECK(SeriesPyramid(TimeSeries()).query(0, 1000, 100).empty());
+}
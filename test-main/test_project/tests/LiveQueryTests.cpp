@@ -0,0 +1,94 @@
+#include "Check.hpp"
+#include "TestData.hpp"
+#include "AnomalyDetector.hpp"
+#include "LiveQuery.hpp"
+#include <algorithm>
+#include <map>
+
+namespace {
+
+// Random samples with every 40th level far above the rest, so some are flagged
+std::vector<WaterSample> samplesWithSpikes(size_t count, uint32_t seed) {
+    std::vector<WaterSample> samples = randomSamples(count, seed, 6);
+    for (size_t i = 39; i < samples.size(); i += 40)
+        samples[i].setLevel(samples[i].getLevel() * 100.0 + 1000.0);
+    return samples;
+}
+
+// The series with the most flagged selected rows, the slow way
+std::vector<std::pair<SeriesKey, int>> expectedAnomalous(const std::vector<WaterSample>& samples,
+                                                         const std::vector<double>& scores,
+                                                         const FilterResult& result) {
+    std::map<std::pair<std::string, std::string>, int> counts;
+    for (size_t row : result.rows)
+        if (AnomalyDetector::isAnomaly(scores[row]))
+            counts[{samples[row].getLocation(), samples[row].getPollutant()}]++;
+    std::vector<std::pair<SeriesKey, int>> ranked;
+    for (const auto& entry : counts)
+        ranked.push_back({SeriesKey{entry.first.first, entry.first.second}, entry.second});
+    // By name within a count: the map is in name order already
+    std::stable_sort(ranked.begin(), ranked.end(),
+                     [](const std::pair<SeriesKey, int>& a, const std::pair<SeriesKey, int>& b) {
+                         return a.second > b.second;
+                     });
+    return ranked;
+}
+
+} // namespace
+
+TEST(liveQueryUpdatesMatchAQueryOverEveryRow) {
+    std::vector<WaterSample> all = samplesWithSpikes(6000, 150);
+    ComplianceRules rules = testRules();
+    bool anyFlagged = false;
+
+    for (const SampleFilter& filter : testFilters()) {
+        std::vector<WaterSample> samples(all.begin(), all.begin() + 1000);
+        std::vector<double> scores;
+        AnomalyDetector detector;
+        for (const WaterSample& sample : samples)
+            scores.push_back(detector.add(sample));
+        LiveQuery query(rules, filter, computeStats(samples, rules, filter), samples, scores);
+
+        // Appends of one row, a few, none and many
+        for (size_t appended : {1, 7, 0, 500, 1, 4491}) {
+            size_t selected = query.result().rows.size();
+            for (size_t i = samples.size(); i < samples.size() + appended; ++i)
+                scores.push_back(detector.add(all[i]));
+            samples.insert(samples.end(), all.begin() + samples.size(), all.begin() + samples.size() + appended);
+            CHECK(query.update(samples, scores) == selected);
+
+            FilterResult expected = computeStats(samples, rules, filter);
+            CHECK(query.result().rows == expected.rows);
+            CHECK(query.result().statuses == expected.statuses);
+            CHECK(sameStats(query.result().stats, expected.stats));
+
+            std::vector<std::pair<SeriesKey, int>> anomalous = expectedAnomalous(samples, scores, expected);
+            int flagged = 0;
+            for (const auto& series : anomalous)
+                flagged += series.second;
+            CHECK(query.anomalyCount() == flagged);
+            std::vector<std::pair<SeriesKey, int>> most = query.mostAnomalous(5);
+            anomalous.resize(std::min<size_t>(anomalous.size(), 5));
+            CHECK(most == anomalous);
+        }
+        CHECK(samples.size() == all.size());
+        anyFlagged = anyFlagged || query.anomalyCount() > 0;
+    }
+    CHECK(anyFlagged);
+}
+
+TEST(extendStatsMatchesComputeStatsOverEveryRow) {
+    std::vector<WaterSample> samples = randomSamples(5000, 151);
+    ComplianceRules rules = testRules();
+    for (const SampleFilter& filter : testFilters()) {
+        for (size_t first : {size_t(0), size_t(1), size_t(2500), samples.size()}) {
+            std::vector<WaterSample> head(samples.begin(), samples.begin() + first);
+            FilterResult result = computeStats(head, rules, filter);
+            extendStats(result, samples, first, rules, filter);
+            FilterResult expected = computeStats(samples, rules, filter);
+            CHECK(result.rows == expected.rows);
+            CHECK(result.statuses == expected.statuses);
+            CHECK(sameStats(result.stats, expected.stats));
+        }
+    }
+}
@@ -0,0 +1,132 @@
+#include "Check.hpp"
+#include "LocationSearch.hpp"
+#include <algorithm>
+#include <cctype>
+#include <random>
+#include <set>
+
+namespace {
+
+std::string lower(std::string text) {
+    for (char& c : text)
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return text;
+}
+
+std::set<std::string> trigramSet(const std::string& text) {
+    std::set<std::string> result;
+    for (size_t i = 0; i + 3 <= text.size(); ++i)
+        result.insert(text.substr(i, 3));
+    return result;
+}
+
+// The documented order, by scanning every name: prefix matches by lowercase
+// name, then other names containing the query, then names sharing enough of
+// its trigrams, most first
+// Lowercase names and their trigrams, worked out once for every query
+struct ScannedNames {
+    std::vector<std::string> folded;
+    std::vector<std::set<std::string>> trigrams;
+};
+
+ScannedNames scanned(const std::vector<std::string>& names) {
+    ScannedNames result;
+    for (const std::string& name : names) {
+        result.folded.push_back(lower(name));
+        result.trigrams.push_back(trigramSet(result.folded.back()));
+    }
+    return result;
+}
+
+std::vector<size_t> expectedMatches(const ScannedNames& names, const std::string& query, size_t limit) {
+    const std::vector<std::string>& folded = names.folded;
+    std::string key = lower(query);
+    std::vector<size_t> matches;
+    std::vector<bool> taken(folded.size(), false);
+    auto take = [&](size_t position) {
+        if (!taken[position] && matches.size() < limit) {
+            taken[position] = true;
+            matches.push_back(position);
+        }
+    };
+
+    std::vector<size_t> prefixed;
+    for (size_t position = 0; position < folded.size(); ++position)
+        if (folded[position].compare(0, key.size(), key) == 0)
+            prefixed.push_back(position);
+    std::stable_sort(prefixed.begin(), prefixed.end(),
+                     [&](size_t a, size_t b) { return folded[a] < folded[b]; });
+    for (size_t position : prefixed)
+        take(position);
+
+    for (size_t position = 0; position < folded.size(); ++position)
+        if (folded[position].find(key) != std::string::npos)
+            take(position);
+
+    std::set<std::string> queryTrigrams = trigramSet(key);
+    if (queryTrigrams.empty())
+        return matches;
+    std::vector<std::pair<size_t, size_t>> fuzzy; // Shared trigrams, position
+    for (size_t position = 0; position < folded.size(); ++position) {
+        size_t shared = 0;
+        for (const std::string& trigram : queryTrigrams)
+            shared += names.trigrams[position].count(trigram);
+        if (shared > 0 && shared >= LocationSearch::FUZZY_MIN_SHARED * queryTrigrams.size())
+            fuzzy.push_back({shared, position});
+    }
+    std::stable_sort(fuzzy.begin(), fuzzy.end(),
+                     [](const std::pair<size_t, size_t>& a, const std::pair<size_t, size_t>& b) {
+                         return a.first > b.first;
+                     });
+    for (const auto& match : fuzzy)
+        take(match.second);
+    return matches;
+}
+
+} // namespace
+
+TEST(locationSearchMatchesAScanOfEveryName) {
+    const std::vector<std::string> words = {"River", "THAMES", "at", "Bridge", "mill", "Brook", "Aire",
+                                            "LEEDS", "weir", "Ouse", "st", "Sewage", "works", "No."};
+    std::mt19937 random(180);
+    std::vector<std::string> input;
+    for (int i = 0; i < 3000; ++i) {
+        std::string name;
+        for (size_t word = 0, count = 1 + random() % 4; word < count; ++word)
+            name += (word ? " " : "") + words[random() % words.size()];
+        if (random() % 2)
+            name += " " + std::to_string(random() % 100);
+        input.push_back(name);
+    }
+    LocationSearch search(input);
+    const std::vector<std::string>& names = search.names();
+    CHECK(std::is_sorted(names.begin(), names.end()));
+    CHECK(std::adjacent_find(names.begin(), names.end()) == names.end());
+    CHECK(std::set<std::string>(input.begin(), input.end()).size() == names.size());
+
+    std::vector<std::string> queries = {"", "r", "RI", "riv", "river thames", "THAMES AT", "bridge 4", "leeds weir",
+                                        "nothing like it", "sewage  works", "Rvier", "Thmaes at", "mill 9"};
+    for (int i = 0; i < 300; ++i) {
+        const std::string& name = names[random() % names.size()];
+        size_t start = random() % name.size();
+        std::string query = name.substr(i % 2 ? 0 : start, 1 + random() % 12);
+        if (i % 3 == 0)
+            query[random() % query.size()] = static_cast<char>('a' + random() % 26); // A typo
+        if (i % 5 == 0)
+            query = lower(query);
+        queries.push_back(query);
+    }
+
+    ScannedNames scan = scanned(names);
+    for (const std::string& query : queries) {
+        std::vector<size_t> all = expectedMatches(scan, query, names.size());
+        for (size_t limit : {1, 5, 10000}) {
+            std::vector<size_t> expected(all.begin(), all.begin() + std::min(limit, all.size()));
+            // Twice, so scratch space left by the first search would show
+            CHECK(search.search(query, limit) == expected);
+            CHECK(search.search(query, limit) == expected);
+        }
+    }
+    CHECK(search.search("", 10000).size() == names.size());
+    CHECK(LocationSearch().search("river", 10).empty());
+}
@@ -0,0 +1,132 @@
+#include "Check.hpp"
+#include "TestData.hpp"
+#include "QueryCache.hpp"
+#include <algorithm>
+#include <random>
+
+namespace {
+
+struct ModelEntry {
+    size_t key;
+    std::shared_ptr<QueryOutcome> outcome;
+    size_t bytes;
+};
+
+// Distinct keys, each differing from another in one field
+std::vector<QueryKey> testKeys() {
+    std::vector<QueryKey> keys;
+    for (const SampleFilter& filter : testFilters())
+        for (const char* version : {"10@1;", "12@2;"})
+            keys.push_back(QueryKey{"All Years", filter, version});
+    keys.push_back(QueryKey{"2023", testFilters()[0], "10@1;"});
+    return keys;
+}
+
+std::shared_ptr<QueryOutcome> outcomeOf(const std::vector<WaterSample>& samples) {
+    auto outcome = std::make_shared<QueryOutcome>();
+    if (!samples.empty())
+        outcome->dataset->appendData(samples);
+    outcome->result = computeStats(samples, testRules(), SampleFilter());
+    return outcome;
+}
+
+} // namespace
+
+TEST(queryKeysAreEqualOnlyWhenEveryFieldIs) {
+    std::vector<QueryKey> keys = testKeys();
+    for (size_t a = 0; a < keys.size(); ++a) {
+        for (size_t b = 0; b < keys.size(); ++b)
+            CHECK((keys[a] == keys[b]) == (a == b));
+        QueryKey copy = keys[a];
+        CHECK(copy == keys[a] && QueryKeyHash()(copy) == QueryKeyHash()(keys[a]));
+    }
+}
+
+TEST(sourceVersionChangesWithTheFiles) {
+    TempDirectory directory;
+    std::string path = directory.path("samples.csv");
+    CHECK(sourceVersion({path}) == "-;");
+    writeText(path, csvText(randomSamples(10, 170)));
+    std::string written = sourceVersion({path, directory.path("missing.csv")});
+    CHECK(written == sourceVersion({path, directory.path("missing.csv")}));
+    writeText(path, csvText(randomSamples(1, 171), false), true);
+    CHECK(written != sourceVersion({path, directory.path("missing.csv")}));
+}
+
+TEST(approximateBytesGrowWithTheRows) {
+    std::vector<WaterSample> samples = randomSamples(4000, 172);
+    size_t empty = approximateBytes(*outcomeOf({}));
+    size_t small = approximateBytes(*outcomeOf(std::vector<WaterSample>(samples.begin(), samples.begin() + 400)));
+    size_t large = approximateBytes(*outcomeOf(samples));
+    CHECK(empty >= sizeof(QueryOutcome) + sizeof(WaterDataset));
+    // Each row holds at least the sample itself
+    CHECK(small >= empty + 400 * sizeof(WaterSample));
+    CHECK(large >= small + 3600 * sizeof(WaterSample));
+}
+
+TEST(queryCacheEvictsTheLeastRecentlyUsedPastItsBudget) {
+    std::vector<QueryKey> keys = testKeys();
+    std::vector<WaterSample> samples = randomSamples(2000, 173);
+    std::vector<std::shared_ptr<QueryOutcome>> outcomes;
+    for (size_t rows : {0, 10, 100, 300, 1000, 2000})
+        outcomes.push_back(outcomeOf(std::vector<WaterSample>(samples.begin(), samples.begin() + rows)));
+    const size_t budget = approximateBytes(*outcomes[4]) + approximateBytes(*outcomes[3]);
+
+    // Checked against a list, most recent first, trimmed the same way
+    QueryCache cache(budget);
+    std::vector<ModelEntry> model;
+    auto modelFind = [&](size_t key) {
+        return std::find_if(model.begin(), model.end(), [key](const ModelEntry& entry) { return entry.key == key; });
+    };
+    std::mt19937 random(174);
+    for (int step = 0; step < 5000; ++step) {
+        size_t key = random() % keys.size();
+        auto found = modelFind(key);
+        switch (random() % 4) {
+        case 0:
+        case 1: {
+            std::shared_ptr<QueryOutcome> hit = cache.find(keys[key]);
+            CHECK(hit == (found == model.end() ? nullptr : found->outcome));
+            if (found != model.end())
+                std::rotate(model.begin(), found, found + 1);
+            break;
+        }
+        case 2: {
+            std::shared_ptr<QueryOutcome> outcome = outcomes[random() % outcomes.size()];
+            cache.insert(keys[key], outcome);
+            if (found != model.end())
+                model.erase(found);
+            size_t bytes = approximateBytes(*outcome);
+            if (bytes > budget)
+                break;
+            size_t used = 0;
+            for (const ModelEntry& entry : model)
+                used += entry.bytes;
+            while (!model.empty() && used + bytes > budget) {
+                used -= model.back().bytes;
+                model.pop_back();
+            }
+            model.insert(model.begin(), ModelEntry{key, outcome, bytes});
+            break;
+        }
+        default:
+            cache.erase(keys[key]);
+            if (found != model.end())
+                model.erase(found);
+        }
+
+        size_t used = 0;
+        for (const ModelEntry& entry : model)
+            used += entry.bytes;
+        REQUIRE(cache.size() == model.size());
+        CHECK(cache.bytes() == used);
+        CHECK(cache.bytes() <= budget);
+    }
+
+    // An outcome larger than the budget is not kept, and evicts nothing
+    CHECK(approximateBytes(*outcomes[5]) > budget);
+    size_t before = cache.size();
+    cache.insert(keys[0], outcomes[5]);
+    CHECK(cache.find(keys[0]) == nullptr);
+    CHECK(cache.size() == before - (modelFind(0) != model.end()));
+}
@@ -0,0 +1,202 @@
+#include "Check.hpp"
+#include "TestData.hpp"
+#include "SampleSort.hpp"
+#include "dataset.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+
+namespace {
+
+// "YYYY-MM-DDTHH:MM:SS" by its digits and separators alone
+bool wellFormedDate(const std::string& date) {
+    static const char PATTERN[] = "0000-00-00T00:00:00";
+    if (date.size() != sizeof(PATTERN) - 1)
+        return false;
+    for (size_t i = 0; i < date.size(); ++i)
+        if (PATTERN[i] == '0' ? !std::isdigit(static_cast<unsigned char>(date[i])) : date[i] != PATTERN[i])
+            return false;
+    return true;
+}
+
+// Location, pollutant, then other date text before well-formed dates, each
+// in string order, which for well-formed dates is time order
+auto sortKey(const WaterSample& sample) {
+    return std::make_tuple(std::cref(sample.getLocation()), std::cref(sample.getPollutant()),
+                           wellFormedDate(sample.getSampleDate()), std::cref(sample.getSampleDate()));
+}
+
+bool duplicate(const WaterSample& a, const WaterSample& b) {
+    double levelA = a.getLevel();
+    double levelB = b.getLevel();
+    return std::memcmp(&levelA, &levelB, sizeof(double)) == 0 && a.getUnit() == b.getUnit() &&
+           a.getComplianceStatus() == b.getComplianceStatus() && sortKey(a) == sortKey(b);
+}
+
+// What sortAndDeduplicate() promises, the slow way
+std::vector<WaterSample> sortedUnique(std::vector<WaterSample> samples) {
+    std::stable_sort(samples.begin(), samples.end(),
+                     [](const WaterSample& a, const WaterSample& b) { return sortKey(a) < sortKey(b); });
+    std::vector<WaterSample> unique;
+    size_t runBegin = 0;
+    for (const WaterSample& sample : samples) {
+        if (runBegin < unique.size() && sortKey(unique[runBegin]) != sortKey(sample))
+            runBegin = unique.size();
+        if (std::none_of(unique.begin() + runBegin, unique.end(),
+                         [&sample](const WaterSample& kept) { return duplicate(kept, sample); }))
+            unique.push_back(sample);
+    }
+    return unique;
+}
+
+// Random samples with repeated rows, rows differing only in level or
+// compliance, and malformed dates
+std::vector<WaterSample> samplesWithDuplicates(size_t count, uint32_t seed) {
+    std::vector<WaterSample> samples = randomSamples(count, seed, 60);
+    std::mt19937 random(seed);
+    const char* oddDates[] = {"", "n/a", "2023-1-5", "2023-02-30T00:00:00", "2023-01-01 10:00:00"};
+    for (size_t i = 0; i < count / 10; ++i) {
+        WaterSample copy = samples[random() % samples.size()];
+        switch (random() % 5) {
+        case 0:
+            copy.setLevel(copy.getLevel() + 1);
+            break;
+        case 1:
+            copy.setComplianceStatus("true");
+            break;
+        case 2:
+            copy.setSampleDate(oddDates[random() % 5]);
+            break;
+        case 3:
+            copy.setLevel(std::nan(""));
+            break;
+        }
+        samples.insert(samples.begin() + random() % samples.size(), copy);
+    }
+    return samples;
+}
+
+} // namespace
+
+TEST(sortAndDeduplicateMatchesAStableSortThenUnique) {
+    for (uint32_t seed : {90u, 91u}) {
+        std::vector<WaterSample> samples = samplesWithDuplicates(8000, seed);
+        std::vector<WaterSample> expected = sortedUnique(samples);
+        CHECK(expected.size() < samples.size());
+        for (unsigned threads : {1u, 3u, 0u}) {
+            std::vector<WaterSample> sorted = samples;
+            size_t removed = sortAndDeduplicate(sorted, threads);
+            CHECK(removed == samples.size() - expected.size());
+            CHECK(sameSamples(sorted, expected));
+        }
+    }
+    std::vector<WaterSample> none;
+    CHECK(sortAndDeduplicate(none) == 0);
+}
+
+TEST(loadMergedSortsOverlappingExportsAndDropsTheOverlap) {
+    TempDirectory directory;
+    std::vector<WaterSample> samples = randomSamples(3000, 92);
+    // The exports overlap by a thousand rows, as consecutive yearly ones can
+    std::vector<WaterSample> first(samples.begin(), samples.begin() + 2000);
+    std::vector<WaterSample> second(samples.begin() + 1000, samples.end());
+    writeText(directory.path("first.csv"), csvText(first));
+    writeText(directory.path("second.csv"), csvText(second));
+
+    WaterDataset merged;
+    merged.loadMerged({directory.path("first.csv"), directory.path("second.csv")});
+    WaterDataset whole;
+    writeText(directory.path("whole.csv"), csvText(samples));
+    whole.loadData(directory.path("whole.csv"));
+    CHECK(sameSamples(merged.getData(), sortedUnique(whole.getData())));
+}
+
+TEST(datasetSortsOnlyWhenItHoldsEveryRow) {
+    TempDirectory directory;
+    std::vector<WaterSample> samples = samplesWithDuplicates(3000, 93);
+    writeText(directory.path("samples.csv"), csvText(samples));
+    WaterDataset loaded;
+    loaded.loadData(directory.path("samples.csv"));
+    std::vector<WaterSample> expected = sortedUnique(loaded.getData());
+    size_t rows = loaded.getData().size();
+    CHECK(rows > expected.size());
+    CHECK(loaded.sortAndDeduplicate() == rows - expected.size());
+    CHECK(sameSamples(loaded.getData(), expected));
+    CHECK(loaded.getAggregates().summarize("", "", 0).count == expected.size());
+    loaded.saveColumnar(directory.path("samples.wqc"));
+
+    // A sample or a filter's matches cannot correct the aggregates, sketches
+    // and baselines, which cover every row
+    ComplianceRules rules = testRules();
+    SampleFilter filter = testFilters()[1];
+    WaterDataset streamed;
+    streamed.streamQuery({directory.path("samples.csv")}, rules, filter, 100);
+    WaterDataset cached;
+    cached.loadColumnar(directory.path("samples.wqc"), rules, filter);
+    for (WaterDataset* subset : {&streamed, &cached}) {
+        std::vector<WaterSample> before = subset->getData();
+        bool threw = false;
+        try {
+            subset->sortAndDeduplicate();
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        CHECK(threw);
+        CHECK(sameSamples(subset->getData(), before));
+    }
+}
+
+TEST(sortedRowOrderMatchesAStableSortOfEachColumn) {
+    std::vector<WaterSample> samples = samplesWithDuplicates(6000, 93);
+    samples[10].setLevel(-0.0);
+    samples[11].setLevel(0.0);
+    ComplianceRules rules = testRules();
+    std::vector<size_t> rows;
+    std::vector<ComplianceStatus> statuses;
+    for (size_t i = 0; i < samples.size(); i += 2) {
+        rows.push_back(i);
+        statuses.push_back(rules.assess(samples[i]));
+    }
+
+    // Levels with NaN last; -0.0 and 0.0 are equal
+    auto level = [](const WaterSample& sample) {
+        double value = sample.getLevel();
+        return std::make_pair(std::isnan(value), std::isnan(value) ? 0.0 : value);
+    };
+    for (SampleColumn column : {SampleColumn::Location, SampleColumn::Pollutant, SampleColumn::Level,
+                                SampleColumn::Unit, SampleColumn::Date, SampleColumn::Compliance}) {
+        auto less = [&](size_t a, size_t b) {
+            const WaterSample& first = samples[rows[a]];
+            const WaterSample& second = samples[rows[b]];
+            switch (column) {
+            case SampleColumn::Location:
+                return first.getLocation() < second.getLocation();
+            case SampleColumn::Pollutant:
+                return first.getPollutant() < second.getPollutant();
+            case SampleColumn::Level:
+                return level(first) < level(second);
+            case SampleColumn::Unit:
+                return first.getUnit() < second.getUnit();
+            case SampleColumn::Date:
+                return std::make_pair(wellFormedDate(first.getSampleDate()), first.getSampleDate()) <
+                       std::make_pair(wellFormedDate(second.getSampleDate()), second.getSampleDate());
+            case SampleColumn::Compliance:
+                return std::string(complianceStatusName(statuses[a])) < complianceStatusName(statuses[b]);
+            }
+            return false;
+        };
+        for (bool descending : {false, true}) {
+            std::vector<size_t> expected(rows.size());
+            for (size_t i = 0; i < expected.size(); ++i)
+                expected[i] = i;
+            std::stable_sort(expected.begin(), expected.end(),
+                             [&](size_t a, size_t b) { return descending ? less(b, a) : less(a, b); });
+            for (unsigned threads : {1u, 4u})
+                CHECK(sortedRowOrder(samples, rows, statuses, column, descending, threads) == expected);
+        }
+    }
+}
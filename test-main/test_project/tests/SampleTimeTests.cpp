@@ -0,0 +1,56 @@
+#include "Check.hpp"
+#include "SampleTime.hpp"
+#include <random>
+
+TEST(parseAndFormatRoundTripAnyTime) {
+    std::mt19937_64 random(100);
+    // 1900-01-01 to 2100-01-01
+    std::uniform_int_distribution<int64_t> times(-2208988800LL, 4102444800LL);
+    for (int i = 0; i < 100000; ++i) {
+        int64_t time = times(random);
+        int64_t parsed = 0;
+        REQUIRE(sampletime::parse(sampletime::format(time), parsed));
+        CHECK(parsed == time);
+    }
+    int64_t epoch = -1;
+    CHECK(sampletime::parse("1970-01-01T00:00:00", epoch) && epoch == 0);
+    int64_t known = 0;
+    CHECK(sampletime::parse("2024-02-29T12:34:56", known) && known == 1709210096);
+}
+
+TEST(parseRejectsAnythingButAValidTime) {
+    int64_t seconds = 0;
+    for (const char* text : {"", "2023-01-01", "2023-01-01 00:00:00", "2023-01-01T00:00:00Z", "2023-1-01T00:00:00",
+                             "2023-02-29T00:00:00", "1900-02-29T00:00:00", "2024-02-30T00:00:00",
+                             "2023-04-31T00:00:00", "2023-13-01T00:00:00", "2023-00-10T00:00:00",
+                             "2023-01-00T00:00:00", "2023-01-01T24:00:00", "2023-01-01T00:60:00",
+                             "2023-01-01T00:00:60", "2023-01-01T0a:00:00", "+023-01-01T00:00:00"})
+        CHECK(!sampletime::parse(text, seconds));
+    CHECK(sampletime::parse("2000-02-29T23:59:59", seconds));
+}
+
+TEST(civilDaysRoundTripAndMonthsStep) {
+    CHECK(sampletime::daysFromCivil(1970, 1, 1) == 0);
+    CHECK(sampletime::daysFromCivil(1969, 12, 31) == -1);
+    for (int64_t days = -100000; days <= 100000; days += 7) {
+        int64_t year;
+        unsigned month;
+        unsigned day;
+        sampletime::civilFromDays(days, year, month, day);
+        CHECK(sampletime::daysFromCivil(year, month, day) == days);
+    }
+
+    int64_t time = 0;
+    REQUIRE(sampletime::parse("2023-11-15T08:30:00", time));
+    int64_t month = sampletime::startOfMonth(time);
+    CHECK(sampletime::format(month) == "2023-11-01T00:00:00");
+    CHECK(sampletime::format(sampletime::startOfDay(time)) == "2023-11-15T00:00:00");
+    CHECK(sampletime::format(sampletime::addMonths(month, 2)) == "2024-01-01T00:00:00");
+    CHECK(sampletime::format(sampletime::addMonths(month, -11)) == "2022-12-01T00:00:00");
+    CHECK(sampletime::format(sampletime::addMonths(month, 27)) == "2026-02-01T00:00:00");
+    CHECK(sampletime::yearMonth(time) == 202311);
+    // Before 1970 days and months still start at midnight on the first
+    REQUIRE(sampletime::parse("1969-07-20T20:17:40", time));
+    CHECK(sampletime::format(sampletime::startOfDay(time)) == "1969-07-20T00:00:00");
+    CHECK(sampletime::format(sampletime::startOfMonth(time)) == "1969-07-01T00:00:00");
+}
@@ -0,0 +1,130 @@
+#include "Check.hpp"
+#include "SiteClusters.hpp"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+
+namespace {
+
+// Sites scattered over a region, bunched in places so clusters form at every
+// level, some without a position
+std::vector<MapSite> randomSites(size_t count, uint32_t seed) {
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<double> coordinate(300000.0, 500000.0);
+    std::normal_distribution<double> nearby(0.0, 400.0);
+    const ComplianceStatus statuses[] = {ComplianceStatus::Missing, ComplianceStatus::Good, ComplianceStatus::Medium,
+                                         ComplianceStatus::Bad};
+    std::vector<MapSite> sites;
+    for (size_t i = 0; i < count; ++i) {
+        MapSite site;
+        site.location = "SITE " + std::to_string(i);
+        site.position = GridPoint{coordinate(random), coordinate(random)};
+        if (i % 3 == 1)
+            site.position = GridPoint{sites[i - 1].position.easting + nearby(random),
+                                      sites[i - 1].position.northing + nearby(random)};
+        if (i % 17 == 5)
+            site.position = GridPoint();
+        // Mostly good, so a worse site decides its cluster
+        site.worst = statuses[random() % 8 < 5 ? 1 : random() % 4];
+        sites.push_back(site);
+    }
+    return sites;
+}
+
+int severity(ComplianceStatus status) {
+    return status == ComplianceStatus::Bad ? 3 : status == ComplianceStatus::Medium ? 2 :
+           status == ComplianceStatus::Good ? 1 : 0;
+}
+
+} // namespace
+
+TEST(worstStatusPicksTheWorstAssessedRow) {
+    StatusCounts counts;
+    CHECK(worstStatus(counts) == ComplianceStatus::Missing);
+    counts.missing = 4;
+    counts.good = 1;
+    CHECK(worstStatus(counts) == ComplianceStatus::Good);
+    counts.medium = 1;
+    CHECK(worstStatus(counts) == ComplianceStatus::Medium);
+    counts.bad = 1;
+    CHECK(worstStatus(counts) == ComplianceStatus::Bad);
+}
+
+TEST(siteClustersMatchAGroupingByCell) {
+    std::vector<MapSite> input = randomSites(4000, 200);
+    size_t known = std::count_if(input.begin(), input.end(), [](const MapSite& site) { return site.position.known(); });
+    SiteHierarchy hierarchy(input);
+    const std::vector<MapSite>& sites = hierarchy.sites();
+    REQUIRE(sites.size() == known);
+    REQUIRE(hierarchy.levelCount() > 2);
+    CHECK(hierarchy.clusterCount(0) == sites.size());
+    CHECK(hierarchy.clusterCount(hierarchy.levelCount() - 1) <= 4);
+
+    std::mt19937 random(201);
+    std::uniform_real_distribution<double> coordinate(250000.0, 550000.0);
+    for (size_t level = 0; level < hierarchy.levelCount(); ++level) {
+        std::vector<const SiteCluster*> clusters = hierarchy.visible(level, hierarchy.bounds());
+        REQUIRE(clusters.size() == hierarchy.clusterCount(level));
+        CHECK(level == 0 || clusters.size() <= hierarchy.clusterCount(level - 1));
+
+        // Level k >= 1 groups the sites by cells of FINEST_CELL_SIZE * 2^(k - 1)
+        double cellSize = level == 0 ? 0.0 : SiteHierarchy::FINEST_CELL_SIZE * std::pow(2.0, level - 1);
+        auto cellOf = [&](size_t site) {
+            return level == 0 ? static_cast<uint64_t>(site) : gridCellKey(sites[site].position, cellSize);
+        };
+        struct Group {
+            double easting = 0.0;
+            double northing = 0.0;
+            size_t count = 0;
+            ComplianceStatus worst = ComplianceStatus::Missing;
+        };
+        std::map<uint64_t, Group> groups;
+        for (size_t site = 0; site < sites.size(); ++site) {
+            Group& group = groups[cellOf(site)];
+            group.easting += sites[site].position.easting;
+            group.northing += sites[site].position.northing;
+            group.count++;
+            if (severity(sites[site].worst) > severity(group.worst))
+                group.worst = sites[site].worst;
+        }
+        CHECK(groups.size() == clusters.size());
+
+        size_t total = 0;
+        for (const SiteCluster* cluster : clusters) {
+            REQUIRE(cluster->site < sites.size());
+            const Group& group = groups[cellOf(cluster->site)];
+            CHECK(cluster->siteCount == group.count);
+            CHECK(cluster->worst == group.worst);
+            CHECK_NEAR(cluster->centre.easting, group.easting / group.count, 1e-6);
+            CHECK_NEAR(cluster->centre.northing, group.northing / group.count, 1e-6);
+            total += cluster->siteCount;
+        }
+        CHECK(total == sites.size());
+
+        // A view holds the clusters whose centre is inside it
+        for (int view = 0; view < 20; ++view) {
+            double east = coordinate(random);
+            double north = coordinate(random);
+            double size = std::uniform_real_distribution<double>(0.0, 120000.0)(random);
+            GridBox box{east, north, east + size, north + size};
+            std::vector<const SiteCluster*> expected;
+            for (const SiteCluster* cluster : clusters)
+                if (box.contains(cluster->centre))
+                    expected.push_back(cluster);
+            std::vector<const SiteCluster*> shown = hierarchy.visible(level, box);
+            std::sort(expected.begin(), expected.end());
+            std::sort(shown.begin(), shown.end());
+            CHECK(shown == expected);
+        }
+    }
+
+    CHECK(hierarchy.levelFor(0.0) == 0);
+    CHECK(hierarchy.levelFor(SiteHierarchy::FINEST_CELL_SIZE) == 1);
+    CHECK(hierarchy.levelFor(1e12) == hierarchy.levelCount() - 1);
+    CHECK(hierarchy.visible(hierarchy.levelCount(), hierarchy.bounds()).empty());
+
+    SiteHierarchy none(std::vector<MapSite>(3));
+    CHECK(none.empty() && none.levelCount() == 0);
+    CHECK(none.visible(0, hierarchy.bounds()).empty());
+}
@@ -0,0 +1,102 @@
+#include "Check.hpp"
+#include "TestData.hpp"
+#include "Sketches.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+
+namespace {
+
+// Share of values below the digest's estimate of quantile q
+double rankOf(const std::vector<double>& sorted, double value) {
+    return static_cast<double>(std::lower_bound(sorted.begin(), sorted.end(), value) - sorted.begin()) /
+           static_cast<double>(sorted.size());
+}
+
+} // namespace
+
+TEST(tdigestQuantilesAreCloseInRank) {
+    std::mt19937 random(20);
+    std::lognormal_distribution<double> levels(0.0, 1.0);
+    std::vector<double> values;
+    TDigest digest;
+    for (int i = 0; i < 100000; ++i) {
+        values.push_back(levels(random));
+        digest.add(values.back());
+    }
+    std::sort(values.begin(), values.end());
+
+    CHECK(digest.count() == values.size());
+    CHECK(digest.quantile(0.0) == values.front());
+    CHECK(digest.quantile(1.0) == values.back());
+    for (double q : {0.5, 0.25, 0.75})
+        CHECK_NEAR(rankOf(values, digest.quantile(q)), q, 0.01);
+    // Tighter at the tails
+    for (double q : {0.001, 0.01, 0.99, 0.999})
+        CHECK_NEAR(rankOf(values, digest.quantile(q)), q, 0.002);
+}
+
+TEST(tdigestMergedFromPartsMatchesOneDigest) {
+    std::mt19937 random(21);
+    std::normal_distribution<double> levels(7.0, 1.0);
+    std::vector<double> values;
+    TDigest whole;
+    TDigest parts[4];
+    for (int i = 0; i < 40000; ++i) {
+        values.push_back(levels(random));
+        whole.add(values.back());
+        parts[i % 4].add(values.back());
+    }
+    for (int i = 1; i < 4; ++i)
+        parts[0].merge(parts[i]);
+    std::sort(values.begin(), values.end());
+
+    CHECK(parts[0].count() == whole.count());
+    for (double q : {0.01, 0.1, 0.5, 0.9, 0.99})
+        CHECK_NEAR(rankOf(values, parts[0].quantile(q)), q, 0.01);
+    CHECK(std::isnan(TDigest().quantile(0.5)));
+}
+
+TEST(hyperLogLogEstimatesDistinctCounts) {
+    for (size_t distinct : {10u, 1000u, 100000u}) {
+        HyperLogLog counter;
+        HyperLogLog halves[2];
+        for (size_t i = 0; i < distinct; ++i) {
+            std::string value = "point-" + std::to_string(i);
+            // Repeats must not count again
+            counter.add(value);
+            counter.add(value);
+            halves[i % 2].add(value);
+        }
+        halves[0].merge(halves[1]);
+        // Standard error is 1.04 / sqrt(4096), about 1.6%; small counts are exact-ish
+        double tolerance = std::max(1.0, 0.05 * static_cast<double>(distinct));
+        CHECK_NEAR(counter.estimate(), static_cast<double>(distinct), tolerance);
+        CHECK_NEAR(halves[0].estimate(), counter.estimate(), 1e-9);
+    }
+}
+
+TEST(datasetSketchesCountSamplingPointsPerPollutantAndYear) {
+    std::vector<WaterSample> samples = randomSamples(20000, 22, 300);
+    DatasetSketches sketches;
+    sketches.add(samples);
+
+    std::set<std::string> all;
+    std::set<std::string> nitrate2023;
+    for (const WaterSample& sample : samples) {
+        all.insert(sample.getLocation());
+        if (sample.getPollutant() == "Nitrate" && sample.getYear() == 2023)
+            nitrate2023.insert(sample.getLocation());
+    }
+    CHECK_NEAR(sketches.distinctSamplingPoints(), static_cast<double>(all.size()), 0.05 * all.size());
+    CHECK_NEAR(sketches.distinctSamplingPoints("Nitrate", 2023), static_cast<double>(nitrate2023.size()),
+               0.05 * nitrate2023.size());
+
+    std::vector<double> levels;
+    for (const WaterSample& sample : samples)
+        if (sample.getPollutant() == "pH")
+            levels.push_back(sample.getLevel());
+    std::sort(levels.begin(), levels.end());
+    CHECK_NEAR(rankOf(levels, sketches.levelDigest("", "pH").quantile(0.95)), 0.95, 0.01);
+}
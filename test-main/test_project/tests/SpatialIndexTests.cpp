@@ -0,0 +1,107 @@
+#include "Check.hpp"
+#include "TestData.hpp"
+#include "SpatialIndex.hpp"
+#include <algorithm>
+#include <random>
+
+namespace {
+
+// Names of the points of index inside area, by checking every point
+std::vector<std::string> expectedWithin(const SpatialIndex& index, const SpatialArea& area) {
+    std::vector<std::string> names;
+    for (const auto& point : index.points())
+        if (area.contains(point.second))
+            names.push_back(point.first);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+// Boxes and circles of every size, some on cell edges or around no point
+std::vector<SpatialArea> randomAreas(std::mt19937& random, size_t count) {
+    std::uniform_real_distribution<double> coordinate(-50000.0, 750000.0);
+    std::vector<SpatialArea> areas;
+    for (size_t i = 0; i < count; ++i) {
+        double east = coordinate(random);
+        double north = coordinate(random);
+        double size = i % 4 == 0 ? 1000.0 * (random() % 20) : std::uniform_real_distribution<double>(0, 300000)(random);
+        if (i % 5 == 0) {
+            east = SpatialIndex::CELL_SIZE * (random() % 60);
+            north = SpatialIndex::CELL_SIZE * (random() % 60);
+        }
+        if (i % 2)
+            areas.push_back(SpatialArea::circle(GridPoint{east, north}, size));
+        else
+            areas.push_back(SpatialArea::box(GridBox{east, north, east + size, north + size / 2}));
+    }
+    return areas;
+}
+
+} // namespace
+
+TEST(areasContainTheirEdgesOnly) {
+    SpatialArea box = SpatialArea::box(GridBox{0.0, 0.0, 100.0, 50.0});
+    CHECK(box.contains(GridPoint{0.0, 0.0}) && box.contains(GridPoint{100.0, 50.0}));
+    CHECK(!box.contains(GridPoint{100.5, 50.0}) && !box.contains(GridPoint()));
+    SpatialArea circle = SpatialArea::circle(GridPoint{0.0, 0.0}, 100.0);
+    CHECK(circle.contains(GridPoint{0.0, 100.0}) && circle.contains(GridPoint{60.0, -80.0}));
+    CHECK(!circle.contains(GridPoint{100.0, 100.0}));
+}
+
+TEST(spatialIndexFindsThePointsAScanFinds) {
+    std::mt19937 random(190);
+    std::uniform_real_distribution<double> coordinate(0.0, 700000.0);
+    SpatialIndex index;
+    for (int site = 0; site < 3000; ++site) {
+        // Some on cell edges, some sharing a position
+        GridPoint point{coordinate(random), coordinate(random)};
+        if (site % 11 == 0)
+            point = GridPoint{SpatialIndex::CELL_SIZE * (random() % 70), SpatialIndex::CELL_SIZE * (random() % 70)};
+        if (site % 13 == 12)
+            point = index.points().begin()->second;
+        index.add("SITE " + std::to_string(site), point);
+    }
+    index.add("NOWHERE", GridPoint());
+    CHECK(index.size() == 3000);
+    CHECK(!index.find("NOWHERE").known());
+
+    std::vector<SpatialArea> areas = randomAreas(random, 400);
+    for (const SpatialArea& area : areas)
+        CHECK(index.within(area) == expectedWithin(index, area));
+
+    // Moved points are found at their new position only
+    for (int site = 0; site < 3000; site += 3) {
+        GridPoint moved{coordinate(random), coordinate(random)};
+        index.add("SITE " + std::to_string(site), moved);
+        index.add("SITE " + std::to_string(site), GridPoint()); // Ignored, the point stays
+        CHECK(index.find("SITE " + std::to_string(site)).easting == moved.easting);
+    }
+    CHECK(index.size() == 3000);
+    for (const SpatialArea& area : areas)
+        CHECK(index.within(area) == expectedWithin(index, area));
+    for (const auto& point : index.points())
+        CHECK(index.bounds().contains(point.second));
+
+    index.clear();
+    CHECK(index.size() == 0 && index.bounds().empty());
+    CHECK(index.within(areas.front()).empty());
+}
+
+TEST(countsWithinMatchesAnAreaQuery) {
+    std::vector<WaterSample> samples = randomSamples(8000, 191);
+    ComplianceRules rules = testRules();
+    FilterResult all = computeStats(samples, rules, SampleFilter());
+    SpatialIndex index;
+    index.add(samples);
+
+    std::mt19937 random(192);
+    for (const SpatialArea& area : randomAreas(random, 200)) {
+        StatusCounts expected;
+        for (const std::string& location : expectedWithin(index, area))
+            expected.merge(all.accumulator.locationCounts(location));
+        CHECK(sameCounts(all.accumulator.countsWithin(index, area), expected));
+
+        SampleFilter filter;
+        filter.area = area;
+        CHECK(sameCounts(all.accumulator.countsWithin(index, area), computeStats(samples, rules, filter).stats.totals));
+    }
+}
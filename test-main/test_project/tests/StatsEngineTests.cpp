@@ -0,0 +1,86 @@
+#include "Check.hpp"
+#include "TestData.hpp"
+#include "StatsEngine.hpp"
+#include <algorithm>
+#include <random>
+
+TEST(computeStatsMatchesARowByRowCount) {
+    std::vector<WaterSample> samples = randomSamples(5000, 1);
+    ComplianceRules rules = testRules();
+    SampleFilter filter;
+    filter.year = 2023;
+    filter.pollutant = "pH";
+
+    FilterResult result = computeStats(samples, rules, filter, 1);
+    StatusCounts expected;
+    std::vector<size_t> rows;
+    for (size_t i = 0; i < samples.size(); ++i) {
+        if (samples[i].getYear() == 2023 && samples[i].getPollutant() == "pH") {
+            expected.add(rules.assess(samples[i]));
+            rows.push_back(i);
+        }
+    }
+    CHECK(result.rows == rows);
+    CHECK(result.statuses.size() == rows.size());
+    CHECK(sameCounts(result.stats.totals, expected));
+}
+
+TEST(computeStatsIsTheSameOnAnyNumberOfThreads) {
+    std::vector<WaterSample> samples = randomSamples(20000, 2);
+    ComplianceRules rules = testRules();
+    for (int status = 0; status < 2; ++status) {
+        SampleFilter filter;
+        if (status)
+            filter.status = ComplianceStatus::Bad;
+        FilterResult serial = computeStats(samples, rules, filter, 1);
+        for (unsigned threads : {2u, 3u, 8u, 0u}) {
+            FilterResult parallel = computeStats(samples, rules, filter, threads);
+            CHECK(parallel.rows == serial.rows);
+            CHECK(parallel.statuses == serial.statuses);
+            CHECK(sameStats(parallel.stats, serial.stats));
+        }
+    }
+}
+
+TEST(rankingBreaksTiesTheSameWayForAnyRowOrder) {
+    // B and C tie on rate and assessed count; A has the same rate from fewer
+    std::vector<WaterSample> samples;
+    for (const char* location : {"C", "B"}) {
+        samples.push_back(makeSample(location, "pH", 7.0, "2023-01-01T00:00:00"));
+        samples.push_back(makeSample(location, "pH", 12.0, "2023-01-02T00:00:00"));
+    }
+    samples.push_back(makeSample("A", "pH", 7.0, "2023-01-03T00:00:00"));
+    samples.push_back(makeSample("A", "pH", 12.0, "2023-01-04T00:00:00"));
+    samples.push_back(makeSample("A", "pH", 7.0, "2023-01-05T00:00:00"));
+    samples.push_back(makeSample("A", "pH", 12.0, "2023-01-06T00:00:00"));
+    samples.push_back(makeSample("D", "pH", 7.0, "2023-01-07T00:00:00"));
+    samples.push_back(makeSample("E", "pH", 12.0, "2023-01-08T00:00:00"));
+
+    ComplianceRules rules = testRules();
+    std::mt19937 random(3);
+    for (int round = 0; round < 20; ++round) {
+        std::shuffle(samples.begin(), samples.end(), random);
+        DatasetStats stats = computeStats(samples, rules, SampleFilter(), 1 + round % 3).stats;
+        CHECK(stats.topLocation == "D");
+        CHECK(stats.bottomLocation == "E");
+    }
+
+    // Without D and E, the ties at 50% go to more assessed samples, then the name
+    samples.erase(std::remove_if(samples.begin(), samples.end(),
+                                 [](const WaterSample& sample) {
+                                     return sample.getLocation() == "D" || sample.getLocation() == "E";
+                                 }),
+                  samples.end());
+    for (int round = 0; round < 20; ++round) {
+        std::shuffle(samples.begin(), samples.end(), random);
+        DatasetStats stats = computeStats(samples, rules, SampleFilter(), 1 + round % 3).stats;
+        CHECK(stats.topLocation == "A");
+        CHECK(stats.bottomLocation == "A");
+    }
+    samples.erase(std::remove_if(samples.begin(), samples.end(),
+                                 [](const WaterSample& sample) { return sample.getLocation() == "A"; }),
+                  samples.end());
+    DatasetStats stats = computeStats(samples, rules, SampleFilter()).stats;
+    CHECK(stats.topLocation == "B");
+    CHECK(stats.bottomLocation == "B");
+}
@@ -0,0 +1,168 @@
+#include "TestData.hpp"
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+const char* const POLLUTANTS[] = {"pH", "Ammonia(N)", "Nitrate", "Temperature"};
+
+std::string quoted(const std::string& field, char delimiter) {
+    if (field.find_first_of(std::string("\"\n") + delimiter) == std::string::npos)
+        return field;
+    std::string result = "\"";
+    for (char c : field) {
+        if (c == '"')
+            result += '"';
+        result += c;
+    }
+    return result + "\"";
+}
+
+std::string number(double value) {
+    if (std::isnan(value))
+        return "";
+    char text[64];
+    std::snprintf(text, sizeof(text), "%.3f", value);
+    return text;
+}
+
+bool sameNumber(double a, double b) {
+    return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+} // namespace
+
+TempDirectory::TempDirectory() {
+    static std::atomic<int> created{0};
+    root = std::filesystem::temp_directory_path() /
+           ("water-tests-" + std::to_string(std::random_device()()) + "-" + std::to_string(created++));
+    std::filesystem::create_directories(root);
+}
+
+TempDirectory::~TempDirectory() {
+    std::error_code ignored;
+    std::filesystem::remove_all(root, ignored);
+}
+
+std::string TempDirectory::path(const std::string& name) const {
+    return (root / name).string();
+}
+
+std::vector<PollutantSample> testPollutants() {
+    return {PollutantSample("pH", "phunits", "6", "9", ""),
+            PollutantSample("Ammonia(N)", "mg/l", "0", "1", ""),
+            PollutantSample("Nitrate", "mg/l", "0", "50", ""),
+            PollutantSample("Temperature", "cel", "", "", "")};
+}
+
+ComplianceRules testRules() {
+    return ComplianceRules(testPollutants());
+}
+
+WaterSample makeSample(const std::string& location, const std::string& pollutant, double level,
+                       const std::string& date, double easting, double northing) {
+    WaterSample sample(location, pollutant, level, pollutant == "pH" ? "phunits" : "mg/l", "false", date);
+    sample.setPosition(easting, northing);
+    return sample;
+}
+
+std::vector<WaterSample> randomSamples(size_t count, uint32_t seed, size_t locationCount) {
+    std::mt19937 random(seed);
+    std::vector<WaterSample> samples;
+    samples.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        size_t site = random() % locationCount;
+        std::string location = "SITE " + std::to_string(site);
+        if (site % 7 == 3)
+            location += ", \"UPPER\"";
+
+        const char* pollutant = POLLUTANTS[random() % 4];
+        // Around each pollutant's range, so every status occurs
+        double scale = pollutant[0] == 'p' ? 12.0 : pollutant[0] == 'A' ? 2.0 : 80.0;
+        double level = std::round(std::uniform_real_distribution<double>(0.0, scale)(random) * 1000) / 1000;
+
+        char date[32];
+        std::snprintf(date, sizeof(date), "%04d-%02d-%02dT%02d:%02d:00", 2022 + static_cast<int>(random() % 3),
+                      1 + static_cast<int>(random() % 12), 1 + static_cast<int>(random() % 28),
+                      static_cast<int>(random() % 24), static_cast<int>(random() % 60));
+
+        WaterSample sample = makeSample(location, pollutant, level, date);
+        if (site % 10 != 9)
+            sample.setPosition(400000.0 + static_cast<double>(site * 7919 % 60000),
+                               500000.0 + static_cast<double>(site * 104729 % 60000));
+        samples.push_back(sample);
+    }
+    return samples;
+}
+
+std::vector<SampleFilter> testFilters() {
+    std::vector<SampleFilter> filters(5);
+    filters[1].pollutant = "pH";
+    filters[2].year = 2023;
+    filters[2].status = ComplianceStatus::Bad;
+    filters[3].location = "SITE 3, \"UPPER\"";
+    filters[4].year = 2024;
+    filters[4].area = SpatialArea::box(GridBox{400000, 500000, 430000, 530000});
+    return filters;
+}
+
+std::string csvText(const std::vector<WaterSample>& samples, bool header, char delimiter) {
+    const std::string d(1, delimiter);
+    std::string text;
+    if (header)
+        text = "@id" + d + "sample.samplingPoint.label" + d + "sample.sampleDateTime" + d + "determinand.label" +
+               d + "result" + d + "determinand.unit.label" + d + "sample.isComplianceSample" + d +
+               "sample.samplingPoint.easting" + d + "sample.samplingPoint.northing\n";
+    size_t id = 0;
+    for (const WaterSample& sample : samples) {
+        text += "http://x/" + std::to_string(id++) + d + quoted(sample.getLocation(), delimiter) + d +
+                sample.getSampleDate() + d + quoted(sample.getPollutant(), delimiter) + d +
+                number(sample.getLevel()) + d + sample.getUnit() + d + sample.getComplianceStatus() + d +
+                number(sample.getEasting()) + d + number(sample.getNorthing()) + "\n";
+    }
+    return text;
+}
+
+void writeText(const std::string& path, const std::string& text, bool append) {
+    std::ofstream file(path, std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+    file << text;
+    if (!file)
+        throw std::runtime_error("Cannot write " + path);
+}
+
+bool sameSample(const WaterSample& a, const WaterSample& b) {
+    return a.getLocation() == b.getLocation() && a.getPollutant() == b.getPollutant() &&
+           sameNumber(a.getLevel(), b.getLevel()) && a.getUnit() == b.getUnit() &&
+           a.getComplianceStatus() == b.getComplianceStatus() && a.getSampleDate() == b.getSampleDate() &&
+           sameNumber(a.getEasting(), b.getEasting()) && sameNumber(a.getNorthing(), b.getNorthing());
+}
+
+bool sameSamples(const std::vector<WaterSample>& a, const std::vector<WaterSample>& b) {
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i)
+        if (!sameSample(a[i], b[i]))
+            return false;
+    return true;
+}
+
+bool sameCounts(const StatusCounts& a, const StatusCounts& b) {
+    return a.missing == b.missing && a.good == b.good && a.medium == b.medium && a.bad == b.bad;
+}
+
+bool sameStats(const DatasetStats& a, const DatasetStats& b) {
+    if (a.byPollutant.size() != b.byPollutant.size())
+        return false;
+    for (const auto& entry : a.byPollutant) {
+        auto other = b.byPollutant.find(entry.first);
+        if (other == b.byPollutant.end() || !sameCounts(entry.second, other->second))
+            return false;
+    }
+    return sameCounts(a.totals, b.totals) && a.topLocation == b.topLocation &&
+           a.bottomLocation == b.bottomLocation && a.topYear == b.topYear && a.bottomYear == b.bottomYear &&
+           a.topPollutant == b.topPollutant && a.bottomPollutant == b.bottomPollutant;
+}
@@ -0,0 +1,58 @@
+#ifndef TESTDATA_HPP
+#define TESTDATA_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <vector>
+#include "WaterSample.hpp"
+#include "PollutantSample.hpp"
+#include "ComplianceRules.hpp"
+#include "StatsEngine.hpp"
+
+// Samples and files for the tests, generated from a seed so a failure repeats
+
+// Directory for a test's files, removed with everything in it on destruction
+class TempDirectory {
+public:
+    TempDirectory();
+    ~TempDirectory();
+    TempDirectory(const TempDirectory&) = delete;
+    TempDirectory& operator=(const TempDirectory&) = delete;
+
+    std::string path(const std::string& name) const;
+
+private:
+    std::filesystem::path root;
+};
+
+// pH, Ammonia(N) and Nitrate have thresholds; Temperature has none
+std::vector<PollutantSample> testPollutants();
+ComplianceRules testRules();
+
+WaterSample makeSample(const std::string& location, const std::string& pollutant, double level,
+                       const std::string& date, double easting = std::numeric_limits<double>::quiet_NaN(),
+                       double northing = std::numeric_limits<double>::quiet_NaN());
+
+// count samples over locationCount sites (every tenth without a position),
+// the test pollutants and 2022 to 2024, levels in thousandths so they survive
+// a CSV round trip. Some names hold commas and quotes.
+std::vector<WaterSample> randomSamples(size_t count, uint32_t seed, size_t locationCount = 40);
+
+// Filters a query is checked with: everything, and narrower ones of each kind
+std::vector<SampleFilter> testFilters();
+
+// samples as lines of an EA export with the columns WaterDataset reads, the
+// header first if header is set
+std::string csvText(const std::vector<WaterSample>& samples, bool header = true, char delimiter = ',');
+void writeText(const std::string& path, const std::string& text, bool append = false);
+
+// Every field equal, unknown positions included
+bool sameSample(const WaterSample& a, const WaterSample& b);
+bool sameSamples(const std::vector<WaterSample>& a, const std::vector<WaterSample>& b);
+bool sameCounts(const StatusCounts& a, const StatusCounts& b);
+// Counts and rankings equal
+bool sameStats(const DatasetStats& a, const DatasetStats& b);
+
+#endif // TESTDATA_HPP
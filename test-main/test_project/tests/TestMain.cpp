@@ -0,0 +1,44 @@
+#include "Check.hpp"
+#include <cstring>
+#include <exception>
+#include <iostream>
+
+namespace {
+
+int failures = 0;
+
+} // namespace
+
+std::vector<check::Test>& check::registry() {
+    static std::vector<Test> tests;
+    return tests;
+}
+
+void check::fail(const char* file, int line, const std::string& message) {
+    failures++;
+    std::cerr << file << ":" << line << ": failed: " << message << std::endl;
+}
+
+// Runs every test, or those whose name contains the first argument
+int main(int argc, char* argv[]) {
+    int run = 0;
+    int failed = 0;
+    for (const check::Test& test : check::registry()) {
+        if (argc > 1 && !std::strstr(test.name, argv[1]))
+            continue;
+        int before = failures;
+        try {
+            test.run();
+        } catch (const check::Stop&) {
+        } catch (const std::exception& e) {
+            check::fail(test.name, 0, std::string("threw ") + e.what());
+        }
+        run++;
+        if (failures != before) {
+            failed++;
+            std::cerr << test.name << " FAILED" << std::endl;
+        }
+    }
+    std::cout << run << " tests, " << failed << " failed" << std::endl;
+    return failed == 0 && run > 0 ? 0 : 1;
+}
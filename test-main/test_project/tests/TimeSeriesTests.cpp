@@ -0,0 +1,152 @@
+#include "Check.hpp"
+#include "TestData.hpp"
+#include "SampleTime.hpp"
+#include "TimeSeries.hpp"
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+namespace {
+
+// Samples of few series, some at the same time, some unusable
+std::vector<WaterSample> seriesSamples() {
+    std::vector<WaterSample> samples = randomSamples(6000, 110, 3);
+    for (size_t i = 0; i < 300; ++i)
+        samples.push_back(samples[i * 7]);
+    samples[5].setSampleDate("n/a");
+    samples[6].setLevel(std::nan(""));
+    return samples;
+}
+
+// Levels of one series at each usable time, in dataset order within a time
+std::map<int64_t, std::vector<double>> levelsByTime(const std::vector<WaterSample>& samples, const SeriesKey& key,
+                                                    int64_t (*bucket)(int64_t)) {
+    std::map<int64_t, std::vector<double>> levels;
+    for (const WaterSample& sample : samples) {
+        int64_t time;
+        if (sample.getLocation() == key.location && sample.getPollutant() == key.pollutant &&
+            sampletime::parse(sample.getSampleDate(), time) && !std::isnan(sample.getLevel()))
+            levels[bucket(time)].push_back(sample.getLevel());
+    }
+    return levels;
+}
+
+int64_t sameTime(int64_t time) {
+    return time;
+}
+
+int64_t nextDay(int64_t day) {
+    return day + sampletime::SECONDS_PER_DAY;
+}
+
+int64_t nextMonth(int64_t month) {
+    return sampletime::addMonths(month, 1);
+}
+
+// The series the slow way: a mean per bucket, and a gap for every empty
+// bucket between the first and last when next steps between buckets
+TimeSeries expectedSeries(const std::map<int64_t, std::vector<double>>& levels, int64_t (*next)(int64_t)) {
+    TimeSeries series;
+    for (const auto& bucket : levels) {
+        if (next && !series.empty()) {
+            for (int64_t empty = next(series.times.back()); empty < bucket.first; empty = next(empty)) {
+                series.times.push_back(empty);
+                series.values.push_back(std::nan(""));
+                series.counts.push_back(0);
+            }
+        }
+        double sum = 0.0;
+        for (double level : bucket.second)
+            sum += level;
+        series.times.push_back(bucket.first);
+        series.values.push_back(sum / static_cast<double>(bucket.second.size()));
+        series.counts.push_back(static_cast<uint32_t>(bucket.second.size()));
+    }
+    return series;
+}
+
+void checkSameSeries(const TimeSeries& actual, const TimeSeries& expected) {
+    REQUIRE(actual.size() == expected.size());
+    CHECK(actual.times == expected.times);
+    CHECK(actual.counts == expected.counts);
+    for (size_t i = 0; i < actual.size(); ++i)
+        CHECK_NEAR(actual.values[i], expected.values[i], 1e-9);
+}
+
+} // namespace
+
+TEST(seriesMatchTheSamplesAtEveryResolution) {
+    std::vector<WaterSample> samples = seriesSamples();
+    TimeSeriesEngine engine(samples);
+    std::vector<SeriesKey> keys = engine.keys();
+    CHECK(keys.size() == 3 * 4);
+    for (const SeriesKey& key : keys) {
+        checkSameSeries(engine.series(key.location, key.pollutant),
+                        expectedSeries(levelsByTime(samples, key, sameTime), nullptr));
+        checkSameSeries(engine.series(key.location, key.pollutant, Resolution::Daily),
+                        expectedSeries(levelsByTime(samples, key, sampletime::startOfDay), nextDay));
+        checkSameSeries(engine.series(key.location, key.pollutant, Resolution::Monthly),
+                        expectedSeries(levelsByTime(samples, key, sampletime::startOfMonth), nextMonth));
+    }
+    CHECK(engine.series("nowhere", "pH").empty());
+}
+
+TEST(appendedSamplesReplaceTheCachedSeries) {
+    std::vector<WaterSample> samples = seriesSamples();
+    std::vector<WaterSample> first(samples.begin(), samples.begin() + 4000);
+    std::vector<WaterSample> rest(samples.begin() + 4000, samples.end());
+    TimeSeriesEngine engine(first, 4);
+    TimeSeriesEngine whole(samples);
+    for (const SeriesKey& key : engine.keys())
+        engine.series(key.location, key.pollutant, Resolution::Monthly);
+    engine.add(rest);
+    for (const SeriesKey& key : whole.keys()) {
+        for (Resolution resolution : {Resolution::Raw, Resolution::Daily, Resolution::Monthly}) {
+            const TimeSeries& expected = whole.series(key.location, key.pollutant, resolution);
+            checkSameSeries(engine.series(key.location, key.pollutant, resolution), expected);
+        }
+    }
+}
+
+TEST(rollingMeansAndGapsMatchABruteForceScan) {
+    std::vector<WaterSample> samples = seriesSamples();
+    TimeSeriesEngine engine(samples);
+    SeriesKey key = engine.keys().front();
+    const TimeSeries& daily = engine.series(key.location, key.pollutant, Resolution::Daily);
+    const int64_t window = 30 * sampletime::SECONDS_PER_DAY;
+
+    TimeSeries rolling = rollingMean(daily, window);
+    REQUIRE(rolling.size() == daily.size());
+    for (size_t i = 0; i < daily.size(); ++i) {
+        if (daily.counts[i] == 0) {
+            CHECK(std::isnan(rolling.values[i]));
+            continue;
+        }
+        double sum = 0.0;
+        double count = 0.0;
+        for (size_t j = 0; j <= i; ++j) {
+            if (daily.counts[j] > 0 && daily.times[j] > daily.times[i] - window) {
+                sum += daily.values[j] * daily.counts[j];
+                count += daily.counts[j];
+            }
+        }
+        CHECK_NEAR(rolling.values[i], sum / count, 1e-9);
+    }
+
+    const int64_t minGap = 10 * sampletime::SECONDS_PER_DAY;
+    std::vector<TimeGap> gaps = findGaps(daily, minGap);
+    std::vector<int64_t> sampled;
+    for (size_t i = 0; i < daily.size(); ++i)
+        if (daily.counts[i] > 0)
+            sampled.push_back(daily.times[i]);
+    size_t found = 0;
+    for (size_t i = 1; i < sampled.size(); ++i) {
+        if (sampled[i] - sampled[i - 1] <= minGap)
+            continue;
+        REQUIRE(found < gaps.size());
+        CHECK(gaps[found].from == sampled[i - 1] && gaps[found].to == sampled[i]);
+        found++;
+    }
+    CHECK(found == gaps.size());
+    CHECK(found > 0);
+}